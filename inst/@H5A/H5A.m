@@ -394,6 +394,32 @@ classdef H5A
       data = __H5A_read__ (varargin{:});
     endfunction
 
+    ## -*- texinfo -*-
+    ## @deftypefn {} {@var{data} = } H5A.read_into (@var{attr_id}, @var{data})
+    ## @deftypefnx {} {@var{data} = } H5A.read_into (@var{attr_id}, @var{mem_type_id}, @var{data})
+    ## Read a numeric attribute specified with @var{attr_id} into an existing 
+    ## array.
+    ## 
+    ## @strong{Parameters:}
+    ##  @multitable @columnfractions 0.33 0.02 0.65
+    ##  @item @var{attr_id} @tab @tab Location or attribute identifier
+    ##  @item @var{mem_type_id} @tab @tab Target datatype (use @code{H5ML_DEFAULT} 
+    ## for automatic conversion)
+    ##  @item @var{data} @tab @tab Array receiving the data
+    ##  @end multitable
+    ## 
+    ## @strong{Description:}
+    ## 
+    ## Same as @code{H5A.read}, except that the values are stored in the memory 
+    ## already allocated for @var{data}. See @code{help H5D.read_into} for 
+    ## details.
+    ## 
+    ## @seealso{H5A.read,H5D.read_into}
+    ## @end deftypefn
+    function data = read_into (varargin)
+      data = __H5A_read_into__ (varargin{:});
+    endfunction
+
     ## -*- texinfo -*-
     ## @deftypefn {} {} H5A.write (@var{attribute_id}, @var{mem_type_id}, @var{data})
     ## Write an attribute, specified with @var{attribute_id}.
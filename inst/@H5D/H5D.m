@@ -85,6 +85,58 @@ classdef H5D
       dataset_id = __H5D_create__ (varargin{:});
     endfunction
 
+    ## -*- texinfo -*-
+    ## @deftypefn {} {[@var{offset}, @var{filter_mask}, @var{addr}, @var{size}] = } H5D.get_chunk_info (@var{dataset_id}, @var{space_id}, @var{index})
+    ## Retrieve information about a chunk specified by its index.
+    ## 
+    ## @strong{Parameters:}
+    ##  @multitable @columnfractions 0.33 0.02 0.65
+    ##  @item @var{dataset_id} @tab @tab Dataset identifier
+    ##  @item @var{space_id} @tab @tab Dataspace selection or @code{H5S_ALL}
+    ##  @item @var{index} @tab @tab Zero-based index of the chunk among the 
+    ## allocated chunks intersecting the selection
+    ##  @end multitable
+    ## 
+    ## @strong{Description:}
+    ## 
+    ## @var{offset} holds the zero-based logical coordinates of the first element 
+    ## of the chunk, in the same dimension order as @code{H5S.create_simple}. 
+    ## @var{filter_mask} has bit @var{n} set when the @var{n}-th filter of the 
+    ## pipeline was skipped for this chunk. @var{addr} and @var{size} are the 
+    ## address of the chunk in the file and its size in bytes after filtering.
+    ## 
+    ## See original function at 
+    ## @url{https://portal.hdfgroup.org/display/HDF5/H5D_GET_CHUNK_INFO}.
+    ## 
+    ## @seealso{H5D.get_num_chunks,H5D.read_chunk}
+    ## @end deftypefn
+    function [offset, filter_mask, addr, size] = get_chunk_info (varargin)
+      [offset, filter_mask, addr, size] = __H5D_get_chunk_info__ (varargin{:});
+    endfunction
+
+    ## -*- texinfo -*-
+    ## @deftypefn {} {@var{num_chunks} = } H5D.get_num_chunks (@var{dataset_id}, @var{space_id})
+    ## Return the number of allocated chunks of a dataset that intersect a 
+    ## selection.
+    ## 
+    ## @strong{Parameters:}
+    ##  @multitable @columnfractions 0.33 0.02 0.65
+    ##  @item @var{dataset_id} @tab @tab Dataset identifier
+    ##  @item @var{space_id} @tab @tab Dataspace selection or @code{H5S_ALL}
+    ##  @end multitable
+    ## 
+    ## @strong{Description:}
+    ## 
+    ## Chunks that were never written are not counted.
+    ## See original function at 
+    ## @url{https://portal.hdfgroup.org/display/HDF5/H5D_GET_NUM_CHUNKS}.
+    ## 
+    ## @seealso{H5D.get_chunk_info}
+    ## @end deftypefn
+    function num_chunks = get_num_chunks (varargin)
+      num_chunks = __H5D_get_num_chunks__ (varargin{:});
+    endfunction
+
     ## -*- texinfo -*-
     ## @deftypefn {} {@var{dcpl_id} = } H5D.get_create_plist (@var{dataset_id})
     ## Return an identifier for a copy of the dataset creation property list
@@ -185,6 +237,8 @@ classdef H5D
     ## -*- texinfo -*-
     ## @deftypefn {} {@var{data} = } H5D.read (@var{dataset_id})
     ## @deftypefnx {} {@var{data} = } H5D.read (@var{dataset_id}, @var{mem_type_id}, @var{mem_space_id}, @var{file_space_id}, @var{xfer_plist_id})
+    ## @deftypefnx {} {@var{data} = } H5D.read (@dots{}, 'CompoundLayout', @var{layout})
+    ## @deftypefnx {} {@var{data} = } H5D.read (@dots{}, 'References', @var{mode})
     ## Import data from dataset.
     ## 
     ## @strong{Parameters:}
@@ -220,11 +274,50 @@ classdef H5D
     ## See @code{H5T.dereference} for how to retrieve the actual object identifier.
     ## @item H5T_COMPOUND
     ## Returned as a struct with fields corresponding to field names in the compound 
-    ## data type.
+    ## data type. Numeric H5T_ARRAY members are returned as one column per 
+    ## record.
     ## @item H5T_VLEN
     ## Only H5T_STRING base types are handled. Returned as a char array.
     ## @end table
     ## 
+    ## The layout of compound data is controlled by the @qcode{'CompoundLayout'} 
+    ## option: with @qcode{'field'} (default), a scalar struct whose fields are arrays 
+    ## with the dimensions of the dataset is returned; with @qcode{'record'}, 
+    ## a struct array with the dimensions of the dataset is returned, each element 
+    ## holding one record.
+    ## 
+    ## Object reference datasets are returned as @code{int64} references with 
+    ## the @qcode{'References'} option @qcode{'id'} (default). With 
+    ## @qcode{'value'}, the referenced datasets are read at once, with the same 
+    ## conversions as above, and returned in a cell array with the dimensions of 
+    ## the reference dataset. Dataset region references, which can only be read 
+    ## with @qcode{'value'}, are returned the same way, each element holding the 
+    ## referenced subset only, shaped as if its selection was passed as 
+    ## @var{file_space_id}. The option has no effect on other datasets.
+    ## 
+    ## If @var{file_space_id} holds a selection and @var{mem_space_id} is 
+    ## @code{H5S_ALL}, only the selected elements are read. Regular hyperslab 
+    ## selections are returned with the shape of the selected block, other 
+    ## selections are returned as a column vector.
+    ## 
+    ## If @var{mem_space_id} is a dataspace identifier, the output array has 
+    ## the size of that dataspace and the elements selected in the file are 
+    ## stored in the elements selected in memory. Both selections must contain 
+    ## the same number of elements. Elements that are not selected in memory are 
+    ## zero, or empty for string data.
+    ## 
+    ## Chunked datasets compressed with the deflate filter, optionally combined 
+    ## with the shuffle and fletcher32 filters, are decompressed in parallel when 
+    ## the memory type matches the dataset type and the selection is a single 
+    ## block. The number of threads defaults to the number of processors and may 
+    ## be set with the @env{OCT_HDF5_NUM_THREADS} environment variable, e.g. 
+    ## @code{setenv ("OCT_HDF5_NUM_THREADS", "1")} disables parallel 
+    ## decompression.
+    ## 
+    ## Large contiguous datasets without filters, in files opened read-only, are 
+    ## copied from a memory mapping of the file instead of going through the HDF5 
+    ## sieve buffer, under the same conditions on the memory type and selection.
+    ## 
     ## See original function at 
     ## @url{https://portal.hdfgroup.org/display/HDF5/H5D_READ}.
     ## 
@@ -234,14 +327,137 @@ classdef H5D
       data = __H5D_read__ (varargin{:});
     endfunction
 
+    ## -*- texinfo -*-
+    ## @deftypefn {} {[@var{filter_mask}, @var{data}] = } H5D.read_chunk (@var{dataset_id}, @var{xfer_plist_id}, @var{offset})
+    ## Read a raw chunk from a dataset, bypassing the filter pipeline.
+    ## 
+    ## @strong{Parameters:}
+    ##  @multitable @columnfractions 0.33 0.02 0.65
+    ##  @item @var{dataset_id} @tab @tab Dataset identifier
+    ##  @item @var{xfer_plist_id} @tab @tab Transfer property list identifier or 
+    ## @code{H5P_DEFAULT}
+    ##  @item @var{offset} @tab @tab Zero-based logical coordinates of the first 
+    ## element of the chunk
+    ##  @end multitable
+    ## 
+    ## @strong{Description:}
+    ## 
+    ## @var{data} is a uint8 column vector holding the chunk bytes as stored in 
+    ## the file, i.e. after filtering, and @var{filter_mask} has bit @var{n} set 
+    ## when the @var{n}-th filter of the pipeline was skipped for this chunk. 
+    ## Together they can be passed to @code{H5D.write_chunk} to copy the chunk to 
+    ## a dataset with the same type, chunk size and filters without 
+    ## decompressing it.
+    ## 
+    ## See original function at 
+    ## @url{https://portal.hdfgroup.org/display/HDF5/H5D_READ_CHUNK}.
+    ## 
+    ## @seealso{H5D.write_chunk,H5D.get_chunk_info}
+    ## @end deftypefn
+    function [filter_mask, data] = read_chunk (varargin)
+      [filter_mask, data] = __H5D_read_chunk__ (varargin{:});
+    endfunction
+
+    ## -*- texinfo -*-
+    ## @deftypefn {} {@var{data} = } H5D.read_into (@var{dataset_id}, @var{data})
+    ## @deftypefnx {} {@var{data} = } H5D.read_into (@var{dataset_id}, @var{mem_type_id}, @var{mem_space_id}, @var{file_space_id}, @var{xfer_plist_id}, @var{data})
+    ## Import numeric data from dataset into an existing array.
+    ## 
+    ## @strong{Parameters:}
+    ##  @multitable @columnfractions 0.33 0.02 0.65
+    ##  @item @var{dataset_id} @tab @tab Location or dataset identifier
+    ##  @item @var{mem_type_id} @tab @tab Target datatype (use @code{H5ML_DEFAULT} 
+    ## for automatic conversion)
+    ##  @item @var{mem_space_id} @tab @tab Imported data dataspace identifier or 
+    ## @code{H5S_ALL}
+    ##  @item @var{file_space_id} @tab @tab Original data dataspace identifier or 
+    ## @code{H5S_ALL}
+    ##  @item @var{xfer_plist_id} @tab @tab Transfer property list identifier or 
+    ## @code{H5P_DEFAULT}
+    ##  @item @var{data} @tab @tab Array receiving the data
+    ##  @end multitable
+    ## 
+    ## @strong{Description:}
+    ## 
+    ## Same as @code{H5D.read} for numeric and reference data, except that the 
+    ## values are stored in the memory already allocated for @var{data} instead of 
+    ## a newly allocated array. This avoids repeated allocations when reading 
+    ## datasets of the same size in a loop. @var{data} must be a real array of the 
+    ## class and size that @code{H5D.read} would return for the same arguments.
+    ## 
+    ## The memory of @var{data} is reused unless another array shares it, e.g. 
+    ## an array obtained with @code{reshape (@var{data}, @dots{})}. The values are 
+    ## then read into a copy and that array is left unchanged. Variables that 
+    ## were assigned @var{data} hold the same array and therefore also see the 
+    ## new values. The output must always be assigned back to @var{data}.
+    ## 
+    ## @seealso{H5D.read,H5A.read_into}
+    ## @end deftypefn
+    function data = read_into (varargin)
+      data = __H5D_read_into__ (varargin{:});
+    endfunction
+
     ## -*- texinfo -*-
     ## @deftypefn {} {} H5D.write (@var{dataset_id}, @var{mem_type_id}, @var{mem_space_id}, @var{file_space_id}, @var{xfer_plist_id}, @var{data})
-    ## @seealso{}
+    ## Write data to dataset.
+    ## 
+    ## When @var{mem_space_id} is a dataspace, @var{data} must hold as many 
+    ## elements as its extent and the elements selected in memory are written to 
+    ## the elements selected in @var{file_space_id}. When @var{mem_space_id} is 
+    ## @code{H5S_ALL}, @var{data} holds either the whole dataset or only the 
+    ## elements selected in @var{file_space_id}, shaped as for @code{H5D.read}. 
+    ## Only the selected elements are written to the file.
+    ## 
+    ## For compound data types, @var{data} is either a scalar struct whose fields 
+    ## hold one value per record, or a struct array with one element per record. 
+    ## The number of records follows the same rules as the number of elements of 
+    ## numeric @var{data}.
+    ## 
+    ## Numeric data written to chunked datasets compressed with the deflate 
+    ## filter, optionally combined with the shuffle and fletcher32 filters, are 
+    ## compressed in parallel when the memory type matches the dataset type and 
+    ## the selection is a single block made of whole chunks, or extending to the 
+    ## edge of the dataset. The number of threads is controlled by the 
+    ## @env{OCT_HDF5_NUM_THREADS} environment variable as for @code{H5D.read}.
+    ## 
+    ## @seealso{H5D.read}
     ## @end deftypefn
     function write (varargin)
       __H5D_write__ (varargin{:});
     endfunction
 
+    ## -*- texinfo -*-
+    ## @deftypefn {} {} H5D.write_chunk (@var{dataset_id}, @var{xfer_plist_id}, @var{filter_mask}, @var{offset}, @var{data})
+    ## Write a raw chunk to a dataset, bypassing the filter pipeline.
+    ## 
+    ## @strong{Parameters:}
+    ##  @multitable @columnfractions 0.33 0.02 0.65
+    ##  @item @var{dataset_id} @tab @tab Dataset identifier
+    ##  @item @var{xfer_plist_id} @tab @tab Transfer property list identifier or 
+    ## @code{H5P_DEFAULT}
+    ##  @item @var{filter_mask} @tab @tab Mask of the filters that were skipped 
+    ## when encoding @var{data}
+    ##  @item @var{offset} @tab @tab Zero-based logical coordinates of the first 
+    ## element of the chunk
+    ##  @item @var{data} @tab @tab uint8 array of chunk bytes, already filtered
+    ##  @end multitable
+    ## 
+    ## @strong{Description:}
+    ## 
+    ## The bytes of @var{data} are stored as is and must be the result of 
+    ## applying the filters of the dataset, except those flagged in 
+    ## @var{filter_mask}, to a whole chunk. They are typically obtained with 
+    ## @code{H5D.read_chunk}.
+    ## 
+    ## See original function at 
+    ## @url{https://portal.hdfgroup.org/display/HDF5/H5D_WRITE_CHUNK}.
+    ## 
+    ## @seealso{H5D.read_chunk}
+    ## @end deftypefn
+    function write_chunk (varargin)
+      __H5D_write_chunk__ (varargin{:});
+    endfunction
+
   endmethods
 
 endclassdef
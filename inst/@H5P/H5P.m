@@ -64,6 +64,27 @@ classdef H5P
       [rank, dims] = __H5P_get_chunk__ (varargin{:});
     endfunction
 
+    ## -*- texinfo -*-
+    ## @deftypefn {} {[@var{filter_id}, @var{flags}, @var{cd_values}, @var{name}, @var{filter_config}] = } H5P.get_filter (@var{plist_id}, @var{idx})
+    ## Return information about the filter of index @var{idx}, zero-based, in the 
+    ## filter pipeline of the dataset creation property list @var{plist_id}.
+    ## 
+    ## @var{filter_id} is the filter identifier, e.g. the value of 
+    ## @qcode{'H5Z_FILTER_DEFLATE'}, @var{flags} the filter flags, 
+    ## @var{cd_values} the auxiliary data of the filter, such as the compression 
+    ## level of the deflate filter, @var{name} its name and @var{filter_config} 
+    ## the bit field telling whether encoding and decoding are enabled.
+    ## 
+    ## See original function at 
+    ## @url{https://portal.hdfgroup.org/display/HDF5/H5P_GET_FILTER2}.
+    ## 
+    ## @seealso{H5P.get_nfilters,H5D.get_create_plist}
+    ## @end deftypefn
+    function [filter_id, flags, cd_values, name, filter_config] = get_filter (varargin)
+      [filter_id, flags, cd_values, name, filter_config] = ...
+        __H5P_get_filter__ (varargin{:});
+    endfunction
+
     ## -*- texinfo -*-
     ## @deftypefn {} {@var{layout_id} = } H5P.get_layout (@var{plist_id}) 
     ## @seealso{H5D.get_create_plist}
@@ -72,6 +93,156 @@ classdef H5P
       layout_id = __H5P_get_layout__ (varargin{:});
     endfunction
 
+    ## -*- texinfo -*-
+    ## @deftypefn {} {@var{nfilters} = } H5P.get_nfilters (@var{plist_id})
+    ## Return the number of filters in the filter pipeline of the dataset 
+    ## creation property list @var{plist_id}.
+    ## @seealso{H5P.get_filter,H5D.get_create_plist}
+    ## @end deftypefn
+    function nfilters = get_nfilters (varargin)
+      nfilters = __H5P_get_nfilters__ (varargin{:});
+    endfunction
+
+    ## -*- texinfo -*-
+    ## @deftypefn {} {} H5P.set_alloc_time (@var{plist_id}, @var{alloc_time})
+    ## Set the time at which storage is allocated for datasets created with the 
+    ## dataset creation property list @var{plist_id}.
+    ## 
+    ## @var{alloc_time} is one of @qcode{'H5D_ALLOC_TIME_DEFAULT'}, 
+    ## @qcode{'H5D_ALLOC_TIME_EARLY'}, when the dataset is created, 
+    ## @qcode{'H5D_ALLOC_TIME_INCR'}, as chunks are written, or 
+    ## @qcode{'H5D_ALLOC_TIME_LATE'}, when data are first written.
+    ## @seealso{H5P.set_fill_time,H5P.create}
+    ## @end deftypefn
+    function set_alloc_time (varargin)
+      __H5P_set_alloc_time__ (varargin{:});
+    endfunction
+
+    ## -*- texinfo -*-
+    ## @deftypefn {} {} H5P.set_chunk (@var{plist_id}, @var{dims})
+    ## Set the dimensions of the chunks of datasets created with the dataset 
+    ## creation property list @var{plist_id}, and their layout to 
+    ## @qcode{'H5D_CHUNKED'}.
+    ## 
+    ## @var{dims} has one element per dimension, in the same order as for 
+    ## @code{H5S.create_simple}. Chunking is required by all filters, e.g. 
+    ## @code{H5P.set_deflate}.
+    ## @seealso{H5P.get_chunk,H5P.set_deflate,H5D.create}
+    ## @end deftypefn
+    function set_chunk (varargin)
+      __H5P_set_chunk__ (varargin{:});
+    endfunction
+
+    ## -*- texinfo -*-
+    ## @deftypefn {} {} H5P.set_deflate (@var{plist_id}, @var{level})
+    ## Add the deflate (gzip) compression filter, with compression @var{level} 
+    ## from 0 to 9, to the filter pipeline of the dataset creation property list 
+    ## @var{plist_id}.
+    ## 
+    ## Datasets must be chunked, see @code{H5P.set_chunk}. The deflate filter is 
+    ## usually preceded by the shuffle filter, see @code{H5P.set_shuffle}, which 
+    ## improves the compression of multi-byte data.
+    ## @seealso{H5P.set_chunk,H5P.set_shuffle,H5P.get_filter}
+    ## @end deftypefn
+    function set_deflate (varargin)
+      __H5P_set_deflate__ (varargin{:});
+    endfunction
+
+    ## -*- texinfo -*-
+    ## @deftypefn {} {} H5P.set_fill_time (@var{plist_id}, @var{fill_time})
+    ## Set the time at which the storage of datasets created with the dataset 
+    ## creation property list @var{plist_id} is filled with the fill value.
+    ## 
+    ## @var{fill_time} is one of @qcode{'H5D_FILL_TIME_IFSET'} (default), only if 
+    ## a fill value was set with @code{H5P.set_fill_value}, 
+    ## @qcode{'H5D_FILL_TIME_ALLOC'}, when storage is allocated, or 
+    ## @qcode{'H5D_FILL_TIME_NEVER'}, in which case unwritten elements are 
+    ## undefined.
+    ## @seealso{H5P.set_fill_value,H5P.set_alloc_time}
+    ## @end deftypefn
+    function set_fill_time (varargin)
+      __H5P_set_fill_time__ (varargin{:});
+    endfunction
+
+    ## -*- texinfo -*-
+    ## @deftypefn {} {} H5P.set_fill_value (@var{plist_id}, @var{type_id}, @var{value})
+    ## Set the value of the unwritten elements of datasets created with the 
+    ## dataset creation property list @var{plist_id}.
+    ## 
+    ## The numeric or logical scalar @var{value} is converted to the data type 
+    ## @var{type_id}, which is in turn converted to the type of the dataset when 
+    ## it is created.
+    ## @seealso{H5P.fill_value_defined,H5P.set_fill_time}
+    ## @end deftypefn
+    function set_fill_value (varargin)
+      __H5P_set_fill_value__ (varargin{:});
+    endfunction
+
+    ## -*- texinfo -*-
+    ## @deftypefn {} {} H5P.set_fletcher32 (@var{plist_id})
+    ## Add the Fletcher32 checksum filter to the filter pipeline of the dataset 
+    ## creation property list @var{plist_id}. Chunks whose checksum does not 
+    ## match are reported as errors when read.
+    ## @seealso{H5P.set_chunk,H5P.get_filter}
+    ## @end deftypefn
+    function set_fletcher32 (varargin)
+      __H5P_set_fletcher32__ (varargin{:});
+    endfunction
+
+    ## -*- texinfo -*-
+    ## @deftypefn {} {} H5P.set_layout (@var{plist_id}, @var{layout})
+    ## Set the storage layout of datasets created with the dataset creation 
+    ## property list @var{plist_id}.
+    ## 
+    ## @var{layout} is one of @qcode{'H5D_COMPACT'}, data stored in the object 
+    ## header, for small datasets, @qcode{'H5D_CONTIGUOUS'} (default) or 
+    ## @qcode{'H5D_CHUNKED'}, the chunk dimensions being set with 
+    ## @code{H5P.set_chunk}.
+    ## @seealso{H5P.get_layout,H5P.set_chunk}
+    ## @end deftypefn
+    function set_layout (varargin)
+      __H5P_set_layout__ (varargin{:});
+    endfunction
+
+    ## -*- texinfo -*-
+    ## @deftypefn {} {} H5P.set_nbit (@var{plist_id})
+    ## Add the N-Bit filter to the filter pipeline of the dataset creation 
+    ## property list @var{plist_id}. Only the significant bits of the elements, 
+    ## as defined by the precision and offset of the dataset type, are stored.
+    ## @seealso{H5P.set_chunk,H5P.set_scaleoffset}
+    ## @end deftypefn
+    function set_nbit (varargin)
+      __H5P_set_nbit__ (varargin{:});
+    endfunction
+
+    ## -*- texinfo -*-
+    ## @deftypefn {} {} H5P.set_scaleoffset (@var{plist_id}, @var{scale_type}, @var{scale_factor})
+    ## Add the scale-offset filter to the filter pipeline of the dataset creation 
+    ## property list @var{plist_id}.
+    ## 
+    ## With @var{scale_type} @qcode{'H5Z_SO_INT'}, integer data are stored with 
+    ## @var{scale_factor} bits, or the minimum number of bits when it is 
+    ## @qcode{'H5Z_SO_INT_MINBITS_DEFAULT'}. With 
+    ## @qcode{'H5Z_SO_FLOAT_DSCALE'}, floating point data are stored with 
+    ## @var{scale_factor} decimal digits, which is lossy.
+    ## @seealso{H5P.set_chunk,H5P.set_nbit}
+    ## @end deftypefn
+    function set_scaleoffset (varargin)
+      __H5P_set_scaleoffset__ (varargin{:});
+    endfunction
+
+    ## -*- texinfo -*-
+    ## @deftypefn {} {} H5P.set_shuffle (@var{plist_id})
+    ## Add the shuffle filter to the filter pipeline of the dataset creation 
+    ## property list @var{plist_id}. The bytes of the elements of each chunk are 
+    ## regrouped by significance, which helps the compression filters that 
+    ## follow, e.g. @code{H5P.set_deflate}.
+    ## @seealso{H5P.set_chunk,H5P.set_deflate}
+    ## @end deftypefn
+    function set_shuffle (varargin)
+      __H5P_set_shuffle__ (varargin{:});
+    endfunction
+
   endmethods
 
 endclassdef
@@ -58,6 +58,10 @@ classdef H5R
     ## Given a reference, @var{ref}, to an object or a region in an object,
     ## open that object and return an identifier.
     ## 
+    ## With @qcode{'H5R_OBJECT'}, @var{ref} may be an array of references, as 
+    ## returned by @code{H5D.read}: the referenced objects are all opened at once 
+    ## and @var{ref_obj_id} is an array of identifiers of the same size.
+    ## 
     ## The parameter @var{obj_id} must be a valid identifier for the HDF5 file
     ## containing the referenced object or for any object in that HDF5 file.
     ## 
@@ -84,6 +88,35 @@ classdef H5R
       obj_type = __H5R_get_obj_type__ (varargin{:});
     endfunction
 
+    ## -*- texinfo -*-
+    ## @deftypefn {} {@var{space_id} = } H5R.get_region (@var{loc_id}, @var{ref_type}, @var{ref})
+    ## Return a copy of the dataspace of the dataset pointed to by the dataset 
+    ## region reference @var{ref}, with the referenced region selected.
+    ## 
+    ## @strong{Parameters:}
+    ##  @multitable @columnfractions 0.33 0.02 0.65
+    ##  @item @var{loc_id} @tab @tab Identifier of the file or of any object in 
+    ## the file containing the referenced dataset
+    ##  @item @var{ref_type} @tab @tab Must be @qcode{'H5R_DATASET_REGION'}
+    ##  @item @var{ref} @tab @tab Reference as returned by @code{H5R.create}
+    ##  @end multitable
+    ## 
+    ## @strong{Description:}
+    ## 
+    ## The referenced data are read by passing @var{space_id} as the file 
+    ## dataspace of @code{H5D.read} on the dataset returned by 
+    ## @code{H5R.dereference}. The dataspace should be released with 
+    ## @code{H5S.close}.
+    ## 
+    ## See original function at 
+    ## @url{https://portal.hdfgroup.org/display/HDF5/H5R_GET_REGION}.
+    ## 
+    ## @seealso{H5R.create,H5R.dereference,H5S.close}
+    ## @end deftypefn
+    function space_id = get_region (varargin)
+      space_id = __H5R_get_region__ (varargin{:});
+    endfunction
+
   endmethods
 
 endclassdef
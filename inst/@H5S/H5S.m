@@ -40,6 +40,20 @@ classdef H5S
       __H5S_close__ (varargin{:});
     endfunction
 
+    ## -*- texinfo -*-
+    ## @deftypefn {} {@var{output_space_id} =} H5S.copy (@var{space_id})
+    ## 
+    ## Create a new dataspace which is an exact copy of the dataspace 
+    ## @var{space_id}, including its selection.
+    ## 
+    ## The dataspace identifier returned by this function must be released with 
+    ## @code{H5S.close} or resource leaks will occur.
+    ## @seealso{H5S.close}
+    ## @end deftypefn
+    function output_space_id = copy (varargin)
+      output_space_id = __H5S_copy__ (varargin{:});
+    endfunction
+
     ## -*- texinfo -*-
     ## @deftypefn {} {@var{space_id} =} create (@var{type})
     ## 
@@ -102,6 +116,32 @@ classdef H5S
       space_id = __H5S_create_simple__ (varargin{:});
     endfunction
 
+    ## -*- texinfo -*-
+    ## @deftypefn {} {[@var{start}, @var{finish}] =} H5S.get_select_bounds (@var{space_id})
+    ## 
+    ## Return the zero-based coordinates of the opposite corners of the bounding 
+    ## box of the current selection of dataspace @var{space_id}.
+    ## 
+    ## The coordinates are given in the same dimension order as for 
+    ## @code{H5S.create_simple} and include the offset set with 
+    ## @code{H5S.offset_simple}.
+    ## @seealso{H5S.get_select_npoints,H5S.select_hyperslab}
+    ## @end deftypefn
+    function [start, finish] = get_select_bounds (varargin)
+      [start, finish] = __H5S_get_select_bounds__ (varargin{:});
+    endfunction
+
+    ## -*- texinfo -*-
+    ## @deftypefn {} {@var{npoints} =} H5S.get_select_npoints (@var{space_id})
+    ## 
+    ## Return the number of elements in the current selection of dataspace 
+    ## @var{space_id}.
+    ## @seealso{H5S.get_select_bounds}
+    ## @end deftypefn
+    function npoints = get_select_npoints (varargin)
+      npoints = __H5S_get_select_npoints__ (varargin{:});
+    endfunction
+
     ## -*- texinfo -*-
     ## @deftypefn {} {[@var{ndims}, @var{dims}, @var{maxdims}] = } H5S.get_simple_extent_dims (@var{space_id})
     ## @seealso{}
@@ -122,6 +162,93 @@ classdef H5S
       space_type = __H5S_get_simple_extent_type__ (varargin{:});
     endfunction
 
+    ## -*- texinfo -*-
+    ## @deftypefn {} {} H5S.offset_simple (@var{space_id}, @var{offset})
+    ## 
+    ## Set the offset of the selection of the simple dataspace @var{space_id}.
+    ## 
+    ## @var{offset} has one, possibly negative, element per dimension of the 
+    ## dataspace and moves the current selection by that many elements, without 
+    ## changing it otherwise. This allows the same selection shape to be moved 
+    ## across a dataspace.
+    ## @seealso{H5S.select_hyperslab}
+    ## @end deftypefn
+    function offset_simple (varargin)
+      __H5S_offset_simple__ (varargin{:});
+    endfunction
+
+    ## -*- texinfo -*-
+    ## @deftypefn {} {} H5S.select_all (@var{space_id})
+    ## 
+    ## Select the entire extent of the dataspace @var{space_id}.
+    ## @seealso{H5S.select_none}
+    ## @end deftypefn
+    function select_all (varargin)
+      __H5S_select_all__ (varargin{:});
+    endfunction
+
+    ## -*- texinfo -*-
+    ## @deftypefn {} {} H5S.select_elements (@var{space_id}, @var{op}, @var{coord})
+    ## 
+    ## Select individual elements of the dataspace @var{space_id}.
+    ## 
+    ## @var{coord} is a @var{rank}-by-@var{num_elements} matrix whose columns are 
+    ## the zero-based coordinates of the selected elements, in the same dimension 
+    ## order as for @code{H5S.create_simple}. Elements are read or written in the 
+    ## order of the columns.
+    ## 
+    ## @var{op} is one of @qcode{'H5S_SELECT_SET'}, to replace the current 
+    ## selection, @qcode{'H5S_SELECT_APPEND'} or @qcode{'H5S_SELECT_PREPEND'}, to 
+    ## add the elements after or before those of an existing point selection.
+    ## @seealso{H5S.select_hyperslab,H5S.get_select_npoints}
+    ## @end deftypefn
+    function select_elements (varargin)
+      __H5S_select_elements__ (varargin{:});
+    endfunction
+
+    ## -*- texinfo -*-
+    ## @deftypefn {} {} H5S.select_hyperslab (@var{space_id}, @var{op}, @var{start}, @var{stride}, @var{count}, @var{block})
+    ## 
+    ## Select a hyperslab region of the dataspace @var{space_id}.
+    ## 
+    ## The hyperslab is made of @var{count} blocks of @var{block} elements in each 
+    ## dimension, the first block starting at the zero-based coordinates 
+    ## @var{start} and consecutive blocks being separated by @var{stride} 
+    ## elements. All arguments have one element per dimension, in the same order 
+    ## as for @code{H5S.create_simple}. An empty @var{stride} or @var{block} 
+    ## stands for ones, i.e. contiguous single element blocks.
+    ## 
+    ## @var{op} combines the hyperslab with the current selection: 
+    ## @qcode{'H5S_SELECT_SET'} replaces it, while @qcode{'H5S_SELECT_OR'}, 
+    ## @qcode{'H5S_SELECT_AND'}, @qcode{'H5S_SELECT_XOR'}, 
+    ## @qcode{'H5S_SELECT_NOTB'} and @qcode{'H5S_SELECT_NOTA'} respectively keep 
+    ## the union, the intersection, the symmetric difference, the elements only 
+    ## in the current selection and the elements only in the new hyperslab.
+    ## 
+    ## For instance, the elements @code{x(1:10,1:2:end)} of a 100-by-50 
+    ## array @var{x}, written with the dataspace @var{sid} created by 
+    ## @code{H5S.create_simple (2, [50 100], [])}, are selected with:
+    ## 
+    ## @example
+    ## H5S.select_hyperslab (sid, "H5S_SELECT_SET", [0 0], [2 1], [25 10], [])
+    ## @end example
+    ## @seealso{H5S.select_elements,H5S.get_select_npoints,H5D.read,H5D.write}
+    ## @end deftypefn
+    function select_hyperslab (varargin)
+      __H5S_select_hyperslab__ (varargin{:});
+    endfunction
+
+    ## -*- texinfo -*-
+    ## @deftypefn {} {} H5S.select_none (@var{space_id})
+    ## 
+    ## Reset the selection of the dataspace @var{space_id} to include no 
+    ## elements.
+    ## @seealso{H5S.select_all}
+    ## @end deftypefn
+    function select_none (varargin)
+      __H5S_select_none__ (varargin{:});
+    endfunction
+
   endmethods
 
 endclassdef
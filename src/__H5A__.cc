@@ -735,6 +735,92 @@ See original function at \
 %! fail ("H5E.set_auto (false); data = H5A.read (123456789, 'toto'); H5E.set_auto (true)", "unknown MEM_TYPE_ID 'toto'");
 */
 
+// PKG_ADD: autoload ("__H5A_read_into__", "__H5A__.oct");
+// PKG_DEL: autoload ("__H5A_read_into__", "__H5A__.oct", "remove");
+DEFUN_DLD(__H5A_read_into__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {@var{data} = } H5A.read_into (@var{attr_id}, @var{data})\n\
+@deftypefnx {} {@var{data} = } H5A.read_into (@var{attr_id}, @var{mem_type_id}, @var{data})\n\
+Read a numeric attribute specified with @var{attr_id} into an existing \
+array.\n\
+\n\
+@strong{Parameters:}\n\
+ @multitable @columnfractions 0.33 0.02 0.65\n\
+ @item @var{attr_id} @tab @tab Location or attribute identifier\n\
+ @item @var{mem_type_id} @tab @tab Target datatype (use @code{H5ML_DEFAULT} \
+for automatic conversion)\n\
+ @item @var{data} @tab @tab Array receiving the data\n\
+ @end multitable\n\
+\n\
+@strong{Description:}\n\
+\n\
+Same as @code{H5A.read}, except that the values are stored in the memory \
+already allocated for @var{data}. See @code{help H5D.read_into} for \
+details.\n\
+\n\
+@seealso{H5A.read,H5D.read_into}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  int nargin = args.length ();
+
+  if (nargin != 2 && nargin != 3)
+    print_usage ("H5A.read_into");
+
+  // Attribute ID
+  hid_t attr_id = get_h5_id (args, 0, "ATTR_ID", "H5A.read_into", false);
+
+  // Data buffer memory type ID
+  hid_t mem_type_id = H5Aget_type (attr_id);
+
+  if (nargin > 2
+      && (! args(1).is_string ()
+          || args(1).string_value () != "H5ML_DEFAULT"))
+        mem_type_id = get_h5_id (args, 1, "MEM_TYPE_ID", "H5A.read_into");
+
+  // Get output dimensions
+  dim_vector dv;
+  hid_t space_id = H5Aget_space (attr_id);
+  dv = get_dim_vector (space_id);
+  H5Sclose (space_id);
+
+  if (dv.ndims () == 0)
+    retval = ovl (Matrix ());
+  else
+    retval.append (__h5_read_into__ ("H5A.read_into", args(nargin-1), dv,
+                                     attr_id, mem_type_id));
+
+  return retval;
+}
+
+
+/*
+%!test
+%! fail ("H5A.read_into (1)", "Invalid call");
+
+%!test
+%! fname = tempname ();
+%! fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%! space = H5S.create_simple (1, 4, []);
+%! attr = H5A.create (fid, 'a', 'H5T_NATIVE_DOUBLE', space, 'H5P_DEFAULT');
+%! H5A.write (attr, 'H5ML_DEFAULT', [1; 2; 3; 4]);
+%! buf = zeros (4, 1);
+%! alias = buf;
+%! buf = H5A.read_into (attr, buf);
+%! shared = zeros (4, 1);
+%! shaped = reshape (shared, 2, 2);
+%! shared = H5A.read_into (attr, shared);
+%! H5A.close (attr);
+%! H5S.close (space);
+%! H5F.close (fid);
+%! delete (fname);
+%! assert (buf, [1; 2; 3; 4])
+%! assert (alias, [1; 2; 3; 4])
+%! assert (shared, [1; 2; 3; 4])
+%! assert (shaped, zeros (2, 2))
+*/
+
 // PKG_ADD: autoload ("__H5A_write__", "__H5A__.oct");
 // PKG_DEL: autoload ("__H5A_write__", "__H5A__.oct", "remove");
 DEFUN_DLD(__H5A_write__, args, , 
@@ -795,4 +881,64 @@ See original function at \
 %!test
 %! h5ex_t_cmpdatt ()
 
+%!test
+%! ## Compound attributes are written from a struct array or a scalar struct
+%! data = struct ('a', {int16(-1), int16(2), int16(3)}, 'b', {'x', 'yy', ''});
+%! fname = tempname ();
+%! fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%! strtype = H5T.copy ('H5T_C_S1');
+%! H5T.set_size (strtype, 'H5T_VARIABLE');
+%! dtype = H5T.create ('H5T_COMPOUND', 2 + H5T.get_size (strtype));
+%! H5T.insert (dtype, 'a', 0, 'H5T_NATIVE_INT16');
+%! H5T.insert (dtype, 'b', 2, strtype);
+%! space = H5S.create_simple (1, numel (data), []);
+%! attr = H5A.create (fid, 'rec', dtype, space, 'H5P_DEFAULT');
+%! H5A.write (attr, 'H5ML_DEFAULT', data);
+%! rdata = H5A.read (attr);
+%! fail ("H5A.write (attr, 'H5ML_DEFAULT', data(1:2))",
+%!       "expecting 3 elements in the input struct array");
+%! fail ("H5A.write (attr, 'H5ML_DEFAULT', struct ('a', int16 ([1 2])))",
+%!       "expecting 3 elements for each field");
+%! H5A.close (attr);
+%! attr = H5A.create (fid, 'field', dtype, space, 'H5P_DEFAULT');
+%! H5A.write (attr, 'H5ML_DEFAULT', rdata);
+%! fdata = H5A.read (attr);
+%! H5A.close (attr);
+%! H5S.close (space);
+%! H5T.close (dtype);
+%! H5T.close (strtype);
+%! H5F.close (fid);
+%! delete (fname);
+%! assert (rdata, struct ('a', int16 ([-1; 2; 3]), 'b', {{'x'; 'yy'; ''}}))
+%! assert (fdata, rdata)
+
+%!test
+%! ## Fixed length string members are padded as set in their type
+%! fname = tempname ();
+%! unwind_protect
+%!   fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%!   ctype = H5T.copy ('H5T_C_S1');
+%!   H5T.set_size (ctype, 4);
+%!   ftype = H5T.copy ('H5T_FORTRAN_S1');
+%!   H5T.set_size (ftype, 4);
+%!   dtype = H5T.create ('H5T_COMPOUND', 8);
+%!   H5T.insert (dtype, 'c', 0, ctype);
+%!   H5T.insert (dtype, 'f', 4, ftype);
+%!   space = H5S.create_simple (1, 2, []);
+%!   attr = H5A.create (fid, 'rec', dtype, space, 'H5P_DEFAULT');
+%!   H5A.write (attr, 'H5ML_DEFAULT',
+%!              struct ('c', {{'ab'; 'cde'}}, 'f', {{'ab'; 'cdefg'}}));
+%!   rdata = H5A.read (attr);
+%!   H5A.close (attr);
+%!   H5S.close (space);
+%!   H5T.close (dtype);
+%!   H5T.close (ftype);
+%!   H5T.close (ctype);
+%!   H5F.close (fid);
+%!   assert (rdata.c, ['ab '; 'cde'])
+%!   assert (rdata.f, ['ab  '; 'cdef'])
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
 */
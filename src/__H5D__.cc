@@ -20,6 +20,11 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include <octave/oct.h>
 #include <hdf5.h>
 
+#include <cmath>
+#include <functional>
+#include <map>
+#include <vector>
+
 #include "./util/h5_oct_util.h"
 #include "./util/h5_data_util.h"
 // PKG_ADD: autoload ("__H5D_close__", "__H5D__.oct");
@@ -143,6 +148,133 @@ See original function at \
 %!fail ("H5D.create (1, 2, 3, 4, 5, 6, 7, 8)", "Invalid call")
 */
 
+// Convert the zero-based chunk offset in argument ARGNUM to HDF5
+// coordinates, checking its length against the rank of DATASET_ID.
+static std::vector<hsize_t>
+get_chunk_offset (const octave_value_list& args, int argnum,
+                  hid_t dataset_id, const std::string& caller)
+{
+  NDArray tmp = args(argnum).xarray_value ("%s: OFFSET must be a numeric "
+                                           "vector", caller.c_str ());
+
+  hid_t space_id = H5Dget_space (dataset_id);
+
+  if (space_id < 0)
+    error ("%s: unable to retrieve data space", caller.c_str ());
+
+  int rank = H5Sget_simple_extent_ndims (space_id);
+
+  H5Sclose (space_id);
+
+  if (rank < 0 || rank != tmp.numel ())
+    error ("%s: OFFSET must have one element per dataset dimension",
+           caller.c_str ());
+
+  std::vector<hsize_t> offset (rank);
+
+  for (int ii = 0; ii < rank; ii++)
+    {
+      if (tmp(ii) < 0 || tmp(ii) != std::floor (tmp(ii)))
+        error ("%s: OFFSET must contain non-negative integers",
+               caller.c_str ());
+
+      offset[ii] = static_cast<hsize_t> (tmp(ii));
+    }
+
+  return offset;
+}
+
+// PKG_ADD: autoload ("__H5D_get_chunk_info__", "__H5D__.oct");
+// PKG_DEL: autoload ("__H5D_get_chunk_info__", "__H5D__.oct", "remove");
+DEFUN_DLD(__H5D_get_chunk_info__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {[@var{offset}, @var{filter_mask}, @var{addr}, @var{size}] = } H5D.get_chunk_info (@var{dataset_id}, @var{space_id}, @var{index})\n\
+Retrieve information about a chunk specified by its index.\n\
+\n\
+@strong{Parameters:}\n\
+ @multitable @columnfractions 0.33 0.02 0.65\n\
+ @item @var{dataset_id} @tab @tab Dataset identifier\n\
+ @item @var{space_id} @tab @tab Dataspace selection or @code{H5S_ALL}\n\
+ @item @var{index} @tab @tab Zero-based index of the chunk among the \
+allocated chunks intersecting the selection\n\
+ @end multitable\n\
+\n\
+@strong{Description:}\n\
+\n\
+@var{offset} holds the zero-based logical coordinates of the first element \
+of the chunk, in the same dimension order as @code{H5S.create_simple}. \
+@var{filter_mask} has bit @var{n} set when the @var{n}-th filter of the \
+pipeline was skipped for this chunk. @var{addr} and @var{size} are the \
+address of the chunk in the file and its size in bytes after filtering.\n\
+\n\
+See original function at \
+@url{https://portal.hdfgroup.org/display/HDF5/H5D_GET_CHUNK_INFO}.\n\
+\n\
+@seealso{H5D.get_num_chunks,H5D.read_chunk}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  int nargin = args.length ();
+
+  if (nargin != 3)
+    print_usage ("H5D.get_chunk_info");
+
+  // Dataset ID
+  hid_t dataset_id = get_h5_id (args, 0, "DATASET_ID", "H5D.get_chunk_info",
+                                false);
+
+  // Space ID
+  hid_t space_id = get_h5_id (args, 1, "SPACE_ID", "H5D.get_chunk_info");
+
+  // Chunk index
+  double idx = args(2).xdouble_value ("H5D.get_chunk_info: INDEX must be a "
+                                      "numeric scalar");
+
+  if (idx < 0 || idx != std::floor (idx))
+    error ("H5D.get_chunk_info: INDEX must be a non-negative integer");
+
+#if H5_VERSION_GE(1, 10, 5)
+  hid_t rank_space_id = H5Dget_space (dataset_id);
+
+  if (rank_space_id < 0)
+    error ("H5D.get_chunk_info: unable to retrieve data space");
+
+  int rank = H5Sget_simple_extent_ndims (rank_space_id);
+
+  H5Sclose (rank_space_id);
+
+  std::vector<hsize_t> offset (rank > 0 ? rank : 1);
+  unsigned filter_mask = 0;
+  haddr_t addr = 0;
+  hsize_t size = 0;
+
+  if (H5Dget_chunk_info (dataset_id, space_id, static_cast<hsize_t> (idx),
+                         offset.data (), &filter_mask, &addr, &size) < 0)
+    error ("H5D.get_chunk_info: unable to retrieve chunk information");
+
+  Matrix ooffset (1, rank, 0);
+
+  for (int ii = 0; ii < rank; ii++)
+    ooffset(ii) = offset[ii];
+
+  retval.append (ooffset);
+  retval.append (static_cast<double> (filter_mask));
+  retval.append (octave_uint64 (addr));
+  retval.append (static_cast<double> (size));
+#else
+  error ("H5D.get_chunk_info: requires HDF5 1.10.5 or later");
+#endif
+
+  return retval;
+}
+
+/*
+%!fail ("H5D.get_chunk_info ()", "Invalid call");
+
+%!fail ("H5D.get_chunk_info (1, 'H5S_ALL', -1)", "INDEX must be a non-negative integer");
+*/
+
 // PKG_ADD: autoload ("__H5D_get_create_plist__", "__H5D__.oct");
 // PKG_DEL: autoload ("__H5D_get_create_plist__", "__H5D__.oct", "remove");
 DEFUN_DLD(__H5D_get_create_plist__, args, , 
@@ -189,6 +321,63 @@ See original function at \
 %!fail ("H5E.set_auto (false);H5D.get_create_plist (-123456);H5E.set_auto (true);", "unable to retrieve creation property list");
 */
 
+// PKG_ADD: autoload ("__H5D_get_num_chunks__", "__H5D__.oct");
+// PKG_DEL: autoload ("__H5D_get_num_chunks__", "__H5D__.oct", "remove");
+DEFUN_DLD(__H5D_get_num_chunks__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {@var{num_chunks} = } H5D.get_num_chunks (@var{dataset_id}, @var{space_id})\n\
+Return the number of allocated chunks of a dataset that intersect a \
+selection.\n\
+\n\
+@strong{Parameters:}\n\
+ @multitable @columnfractions 0.33 0.02 0.65\n\
+ @item @var{dataset_id} @tab @tab Dataset identifier\n\
+ @item @var{space_id} @tab @tab Dataspace selection or @code{H5S_ALL}\n\
+ @end multitable\n\
+\n\
+@strong{Description:}\n\
+\n\
+Chunks that were never written are not counted.\n\
+See original function at \
+@url{https://portal.hdfgroup.org/display/HDF5/H5D_GET_NUM_CHUNKS}.\n\
+\n\
+@seealso{H5D.get_chunk_info}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  int nargin = args.length ();
+
+  if (nargin != 2)
+    print_usage ("H5D.get_num_chunks");
+
+  // Dataset ID
+  hid_t dataset_id = get_h5_id (args, 0, "DATASET_ID", "H5D.get_num_chunks",
+                                false);
+
+  // Space ID
+  hid_t space_id = get_h5_id (args, 1, "SPACE_ID", "H5D.get_num_chunks");
+
+#if H5_VERSION_GE(1, 10, 5)
+  hsize_t nchunks = 0;
+
+  if (H5Dget_num_chunks (dataset_id, space_id, &nchunks) < 0)
+    error ("H5D.get_num_chunks: unable to retrieve number of chunks");
+
+  retval.append (static_cast<double> (nchunks));
+#else
+  error ("H5D.get_num_chunks: requires HDF5 1.10.5 or later");
+#endif
+
+  return retval;
+}
+
+/*
+%!fail ("H5D.get_num_chunks ()", "Invalid call");
+
+%!fail ("H5D.get_num_chunks ('toto', 'H5S_ALL')", "DATASET_ID must be a scalar numeric identifier");
+*/
+
 // PKG_ADD: autoload ("__H5D_get_space__", "__H5D__.oct");
 // PKG_DEL: autoload ("__H5D_get_space__", "__H5D__.oct", "remove");
 DEFUN_DLD(__H5D_get_space__, args, , 
@@ -349,12 +538,244 @@ See original function at \
 %!fail ("H5D.open (123456789, 'toto', 'toto')", "unknown DAPL_ID 'toto'")
 */
 
+// Call READER with the dimensions of the data selected in DATASET_ID and
+// the memory dataspace they are to be read into, replacing H5S_ALL with a
+// dataspace shaped after the selection in FILE_SPACE_ID if any.
+static octave_value
+read_selection (const std::string& caller, hid_t dataset_id,
+                hid_t mem_space_id, hid_t file_space_id,
+                const std::function<octave_value (const dim_vector&,
+                                                  hid_t)>& reader)
+{
+  // Get output dimensions
+  dim_vector dv;
+  hid_t space_id = file_space_id;
+
+  if (file_space_id == H5S_ALL)
+    space_id = H5Dget_space (dataset_id);
+
+  if (space_id < 0)
+    error ("%s: unable to retrieve data space", caller.c_str ());
+
+  h5_id_closer space_closer (space_id != file_space_id ? space_id : -1,
+                             H5Sclose);
+
+  hid_t own_mem_space_id = -1;
+
+  if (mem_space_id != H5S_ALL)
+    {
+      // The output buffer spans the whole memory dataspace extent
+      hssize_t nmem = H5Sget_select_npoints (mem_space_id);
+      hssize_t nfile = H5Sget_select_npoints (space_id);
+
+      if (nmem < 0)
+        error ("%s: invalid MEM_SPACE_ID", caller.c_str ());
+      else if (nmem != nfile)
+        error ("%s: number of selected elements in MEM_SPACE_ID (%ld) "
+               "and FILE_SPACE_ID (%ld) differ", caller.c_str (),
+               static_cast<long> (nmem), static_cast<long> (nfile));
+
+      dv = get_dim_vector (mem_space_id);
+    }
+  else if (H5Sget_simple_extent_type (space_id) == H5S_SIMPLE
+           && H5Sget_select_type (space_id) != H5S_SEL_ALL)
+    {
+      // Only read the selected elements in a buffer shaped after
+      // the file selection
+      own_mem_space_id = get_select_mem_space (space_id);
+      mem_space_id = own_mem_space_id;
+
+      dv = get_dim_vector (mem_space_id);
+    }
+  else
+    dv = get_dim_vector (space_id);
+
+  h5_id_closer mem_space_closer (own_mem_space_id, H5Sclose);
+
+  if (dv.ndims () == 0)
+    return Matrix ();
+
+  return reader (dv, mem_space_id);
+}
+
+// Read data from DATASET_ID into a new array or, if INTO is not null,
+// into the storage of the existing array INTO.
+static octave_value
+read_dataset (const std::string& caller, hid_t dataset_id, hid_t mem_type_id,
+              hid_t mem_space_id, hid_t file_space_id, hid_t xfer_plist_id,
+              bool as_records, const octave_value *into = nullptr)
+{
+  return read_selection
+    (caller, dataset_id, mem_space_id, file_space_id,
+     [&] (const dim_vector& dv, hid_t sel_mem_space_id) -> octave_value
+     {
+       if (into)
+         return __h5_read_into__ (caller, *into, dv, dataset_id, mem_type_id,
+                                  sel_mem_space_id, file_space_id,
+                                  xfer_plist_id);
+       else
+         return __h5_read__ (caller, dv, dataset_id, mem_type_id,
+                             sel_mem_space_id, file_space_id, xfer_plist_id,
+                             H5_INDEX_UNKNOWN, as_records);
+     });
+}
+
+// Read the selection REGION_ID, or the whole data if it is H5S_ALL, of the
+// object OBJ_ID referenced by element II of a reference dataset.
+static octave_value
+read_referenced_data (const std::string& caller, hid_t obj_id,
+                      hid_t region_id, hid_t xfer_plist_id, bool as_records,
+                      octave_idx_type ii)
+{
+  if (H5Iget_type (obj_id) != H5I_DATASET)
+    error ("%s: element %ld does not reference a dataset",
+           caller.c_str (), static_cast<long> (ii+1));
+
+  hid_t type_id = H5Dget_type (obj_id);
+
+  if (type_id < 0)
+    error ("%s: unable to retrieve data type", caller.c_str ());
+
+  h5_id_closer type_closer (type_id, H5Tclose);
+
+  return read_dataset (caller, obj_id, type_id, H5S_ALL, region_id,
+                       xfer_plist_id, as_records);
+}
+
+// Read the object reference dataset DATASET_ID and return a cell array
+// holding the values of the referenced datasets, each one being read
+// whole with the default conversions.  Datasets referenced several times
+// are only read once.
+static octave_value
+read_objects (const std::string& caller, hid_t dataset_id,
+              hid_t mem_space_id, hid_t file_space_id, hid_t xfer_plist_id,
+              bool as_records)
+{
+  int64NDArray refs
+    = read_dataset (caller, dataset_id, H5T_STD_REF_OBJ, mem_space_id,
+                    file_space_id, xfer_plist_id, false).int64_array_value ();
+
+  Cell retval (refs.dims ());
+
+  std::map<hobj_ref_t, octave_idx_type> read_refs;
+
+  for (octave_idx_type ii = 0; ii < refs.numel (); ii++)
+    {
+      hobj_ref_t ref = static_cast<hobj_ref_t> (refs(ii).value ());
+
+      auto it = read_refs.find (ref);
+
+      if (it != read_refs.end ())
+        {
+          retval(ii) = retval(it->second);
+          continue;
+        }
+
+      hid_t obj_id = H5Rdereference2 (dataset_id, H5P_DEFAULT, H5R_OBJECT,
+                                      &ref);
+
+      if (obj_id < 0)
+        error ("%s: unable to dereference element %ld", caller.c_str (),
+               static_cast<long> (ii+1));
+
+      h5_id_closer obj_closer (obj_id, H5Oclose);
+
+      retval(ii) = read_referenced_data (caller, obj_id, H5S_ALL,
+                                         xfer_plist_id, as_records, ii);
+
+      read_refs[ref] = ii;
+    }
+
+  return retval;
+}
+
+// Read the dataset region reference dataset DATASET_ID and return a cell
+// array holding the referenced subsets.  Each subset is read through the
+// selection stored in its reference, shaped as by H5D.read with that
+// selection as file dataspace.
+static octave_value
+read_regions (const std::string& caller, hid_t dataset_id,
+              hid_t mem_space_id, hid_t file_space_id, hid_t xfer_plist_id,
+              bool as_records)
+{
+  return read_selection
+    (caller, dataset_id, mem_space_id, file_space_id,
+     [&] (const dim_vector& dv, hid_t sel_mem_space_id) -> octave_value
+     {
+       const size_t ref_size = sizeof (hdset_reg_ref_t);
+
+       std::vector<unsigned char> refs (dv.numel () * ref_size);
+
+       if (H5Dread (dataset_id, H5T_STD_REF_DSETREG, sel_mem_space_id,
+                    file_space_id, xfer_plist_id, refs.data ()) < 0)
+         error ("%s: unable to read data", caller.c_str ());
+
+       Cell retval (dv);
+
+       for (octave_idx_type ii = 0; ii < dv.numel (); ii++)
+         {
+           const void *ref = refs.data () + ii * ref_size;
+
+           hid_t obj_id = H5Rdereference2 (dataset_id, H5P_DEFAULT,
+                                           H5R_DATASET_REGION, ref);
+
+           if (obj_id < 0)
+             error ("%s: unable to dereference element %ld", caller.c_str (),
+                    static_cast<long> (ii+1));
+
+           h5_id_closer obj_closer (obj_id, H5Oclose);
+
+           hid_t region_id = H5Rget_region (dataset_id, H5R_DATASET_REGION,
+                                            ref);
+
+           if (region_id < 0)
+             error ("%s: unable to retrieve region of element %ld",
+                    caller.c_str (), static_cast<long> (ii+1));
+
+           h5_id_closer region_closer (region_id, H5Sclose);
+
+           retval(ii) = read_referenced_data (caller, obj_id, region_id,
+                                              xfer_plist_id, as_records, ii);
+         }
+
+       return retval;
+     });
+}
+
+// Read the reference dataset DATASET_ID as the values it references
+static octave_value
+read_referenced (const std::string& caller, hid_t dataset_id,
+                 hid_t mem_space_id, hid_t file_space_id, hid_t xfer_plist_id,
+                 bool as_records)
+{
+  hid_t file_type_id = H5Dget_type (dataset_id);
+
+  if (file_type_id < 0)
+    error ("%s: unable to retrieve data type", caller.c_str ());
+
+  htri_t is_obj_ref = H5Tequal (file_type_id, H5T_STD_REF_OBJ);
+  htri_t is_region_ref = H5Tequal (file_type_id, H5T_STD_REF_DSETREG);
+
+  H5Tclose (file_type_id);
+
+  if (is_obj_ref > 0)
+    return read_objects (caller, dataset_id, mem_space_id, file_space_id,
+                         xfer_plist_id, as_records);
+  else if (is_region_ref > 0)
+    return read_regions (caller, dataset_id, mem_space_id, file_space_id,
+                         xfer_plist_id, as_records);
+  else
+    error ("%s: unhandled reference type", caller.c_str ());
+}
+
 // PKG_ADD: autoload ("__H5D_read__", "__H5D__.oct");
 // PKG_DEL: autoload ("__H5D_read__", "__H5D__.oct", "remove");
 DEFUN_DLD(__H5D_read__, args, , 
 "-*- texinfo -*-\n\
 @deftypefn {} {@var{data} = } H5D.read (@var{dataset_id})\n\
 @deftypefnx {} {@var{data} = } H5D.read (@var{dataset_id}, @var{mem_type_id}, @var{mem_space_id}, @var{file_space_id}, @var{xfer_plist_id})\n\
+@deftypefnx {} {@var{data} = } H5D.read (@dots{}, 'CompoundLayout', @var{layout})\n\
+@deftypefnx {} {@var{data} = } H5D.read (@dots{}, 'References', @var{mode})\n\
 Import data from dataset.\n\
 \n\
 @strong{Parameters:}\n\
@@ -390,11 +811,50 @@ identifier(s).\n\
 See @code{H5T.dereference} for how to retrieve the actual object identifier.\n\
 @item H5T_COMPOUND\n\
 Returned as a struct with fields corresponding to field names in the compound \
-data type.\n\
+data type. Numeric H5T_ARRAY members are returned as one column per \
+record.\n\
 @item H5T_VLEN\n\
 Only H5T_STRING base types are handled. Returned as a char array.\n\
 @end table\n\
 \n\
+The layout of compound data is controlled by the @qcode{'CompoundLayout'} \
+option: with @qcode{'field'} (default), a scalar struct whose fields are arrays \
+with the dimensions of the dataset is returned; with @qcode{'record'}, \
+a struct array with the dimensions of the dataset is returned, each element \
+holding one record.\n\
+\n\
+Object reference datasets are returned as @code{int64} references with \
+the @qcode{'References'} option @qcode{'id'} (default). With \
+@qcode{'value'}, the referenced datasets are read at once, with the same \
+conversions as above, and returned in a cell array with the dimensions of \
+the reference dataset. Dataset region references, which can only be read \
+with @qcode{'value'}, are returned the same way, each element holding the \
+referenced subset only, shaped as if its selection was passed as \
+@var{file_space_id}. The option has no effect on other datasets.\n\
+\n\
+If @var{file_space_id} holds a selection and @var{mem_space_id} is \
+@code{H5S_ALL}, only the selected elements are read. Regular hyperslab \
+selections are returned with the shape of the selected block, other \
+selections are returned as a column vector.\n\
+\n\
+If @var{mem_space_id} is a dataspace identifier, the output array has \
+the size of that dataspace and the elements selected in the file are \
+stored in the elements selected in memory. Both selections must contain \
+the same number of elements. Elements that are not selected in memory are \
+zero, or empty for string data.\n\
+\n\
+Chunked datasets compressed with the deflate filter, optionally combined \
+with the shuffle and fletcher32 filters, are decompressed in parallel when \
+the memory type matches the dataset type and the selection is a single \
+block. The number of threads defaults to the number of processors and may \
+be set with the @env{OCT_HDF5_NUM_THREADS} environment variable, e.g. \
+@code{setenv (\"OCT_HDF5_NUM_THREADS\", \"1\")} disables parallel \
+decompression.\n\
+\n\
+Large contiguous datasets without filters, in files opened read-only, are \
+copied from a memory mapping of the file instead of going through the HDF5 \
+sieve buffer, under the same conditions on the memory type and selection.\n\
+\n\
 See original function at \
 @url{https://portal.hdfgroup.org/display/HDF5/H5D_READ}.\n\
 \n\
@@ -405,6 +865,42 @@ See original function at \
 
   int nargin = args.length ();
 
+  // Trailing compound layout and reference options
+  bool as_records = false;
+  bool resolve_refs = false;
+
+  while (nargin >= 3 && args(nargin-2).is_string ())
+    {
+      std::string opt = args(nargin-2).string_value ();
+
+      if (opt == "CompoundLayout")
+        {
+          std::string layout
+            = args(nargin-1).xstring_value ("H5D.read: LAYOUT must be a "
+                                            "string");
+
+          if (layout == "record")
+            as_records = true;
+          else if (layout != "field")
+            error ("H5D.read: LAYOUT must be \"field\" or \"record\"");
+        }
+      else if (opt == "References")
+        {
+          std::string mode
+            = args(nargin-1).xstring_value ("H5D.read: MODE must be a "
+                                            "string");
+
+          if (mode == "value")
+            resolve_refs = true;
+          else if (mode != "id")
+            error ("H5D.read: MODE must be \"id\" or \"value\"");
+        }
+      else
+        break;
+
+      nargin -= 2;
+    }
+
   if (nargin != 1 && nargin != 5)
     print_usage ("H5D.read");
 
@@ -437,21 +933,13 @@ See original function at \
   if (nargin > 1)
     xfer_plist_id = get_h5_id (args, 4, "XFER_PLIST_ID", "H5D.read");
 
-  // Get output dimensions
-  dim_vector dv;
-  if (mem_space_id != H5S_ALL)
-    error ("H5D.read: only H5S_ALL is implemented for MEM_SPACE_ID");
-
-  if (file_space_id == H5S_ALL)
-    file_space_id = H5Dget_space (dataset_id);
-
-  dv = get_dim_vector (file_space_id);
-
-  if (dv.ndims () == 0)
-    retval = ovl (Matrix ());
+  if (resolve_refs && H5Tget_class (mem_type_id) == H5T_REFERENCE)
+    retval = ovl (read_referenced ("H5D.read", dataset_id, mem_space_id,
+                                   file_space_id, xfer_plist_id, as_records));
   else
-    retval.append (__h5_read__ ("H5D.read", dv, dataset_id, mem_type_id,
-                                mem_space_id, file_space_id, xfer_plist_id));
+    retval = ovl (read_dataset ("H5D.read", dataset_id, mem_type_id,
+                                 mem_space_id, file_space_id, xfer_plist_id,
+                                 as_records));
 
   return retval;
 }
@@ -509,6 +997,478 @@ See original function at \
 %!test
 %! h5ex_t_objref ()
 
+%!test
+%! fname = tempname ();
+%! unwind_protect
+%!   fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%!   vals = {int8([1 2 3]), single([1.5; 2]), magic(3)};
+%!   types = {'H5T_NATIVE_INT8', 'H5T_NATIVE_FLOAT', 'H5T_NATIVE_DOUBLE'};
+%!   for ii = 1:numel (vals)
+%!     name = sprintf ('v%d', ii);
+%!     space = H5S.create_simple (2, fliplr (size (vals{ii})), []);
+%!     dset = H5D.create (fid, name, types{ii}, space, 'H5P_DEFAULT');
+%!     H5D.write (dset, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT',
+%!                vals{ii});
+%!     H5D.close (dset);
+%!     H5S.close (space);
+%!     refs(ii) = H5R.create (fid, name, 'H5R_OBJECT', -1);
+%!   endfor
+%!   refs = reshape (refs([1 2 3 3]), 2, 2);
+%!   space = H5S.create_simple (2, [2 2], []);
+%!   dset = H5D.create (fid, 'refs', 'H5T_STD_REF_OBJ', space, 'H5P_DEFAULT');
+%!   H5D.write (dset, 'H5T_STD_REF_OBJ', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT',
+%!              refs);
+%!   assert (H5D.read (dset), refs)
+%!   assert (H5D.read (dset, 'References', 'id'), refs)
+%!   data = H5D.read (dset, 'References', 'value');
+%!   assert (data, reshape (vals([1 2 3 3]), 2, 2))
+%!   data = H5D.read (dset, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL',
+%!                    'H5P_DEFAULT', 'References', 'value');
+%!   assert (data, reshape (vals([1 2 3 3]), 2, 2))
+%!   H5D.close (dset);
+%!   H5S.close (space);
+%!   H5F.close (fid);
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+%!test
+%! fname = tempname ();
+%! unwind_protect
+%!   fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%!   data = reshape (1:20, 4, 5);
+%!   space = H5S.create_simple (2, [5 4], []);
+%!   dset = H5D.create (fid, 'data', 'H5T_NATIVE_DOUBLE', space, 'H5P_DEFAULT');
+%!   H5D.write (dset, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT', data);
+%!   H5D.close (dset);
+%!   H5S.select_hyperslab (space, 'H5S_SELECT_SET', [1 0], [], [3 2], []);
+%!   refs = H5R.create (fid, 'data', 'H5R_DATASET_REGION', space);
+%!   H5S.select_elements (space, 'H5S_SELECT_SET', [0 4; 3 1]);
+%!   refs(2,:) = H5R.create (fid, 'data', 'H5R_DATASET_REGION', space);
+%!   H5S.close (space);
+%!   space = H5S.create_simple (1, 2, []);
+%!   dset = H5D.create (fid, 'refs', 'H5T_STD_REF_DSETREG', space,
+%!                      'H5P_DEFAULT');
+%!   H5D.write (dset, 'H5T_STD_REF_DSETREG', 'H5S_ALL', 'H5S_ALL',
+%!              'H5P_DEFAULT', refs);
+%!   rdata = H5D.read (dset, 'References', 'value');
+%!   H5D.close (dset);
+%!   H5S.close (space);
+%!   H5F.close (fid);
+%!   assert (rdata, {data(1:2,2:4); [data(4,1); data(2,5)]})
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+%!test
+%! fname = tempname ();
+%! unwind_protect
+%!   fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%!   data = reshape (1:20, 4, 5);
+%!   space = H5S.create_simple (2, [5 4], []);
+%!   dset = H5D.create (fid, 'data', 'H5T_NATIVE_DOUBLE', space, 'H5P_DEFAULT');
+%!   H5D.write (dset, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT', data);
+%!   H5S.select_hyperslab (space, 'H5S_SELECT_SET', [1 0], [], [3 2], []);
+%!   mem_space = H5S.create_simple (2, [4 3], []);
+%!   H5S.select_hyperslab (mem_space, 'H5S_SELECT_SET', [1 1], [], [3 2], []);
+%!   rdata = H5D.read (dset, 'H5ML_DEFAULT', mem_space, space, 'H5P_DEFAULT');
+%!   H5S.close (mem_space);
+%!   H5S.close (space);
+%!   H5D.close (dset);
+%!   H5F.close (fid);
+%!   expected = zeros (3, 4);
+%!   expected(2:3,2:4) = data(1:2,2:4);
+%!   assert (rdata, expected)
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+%!fail ("H5D.read (1, 'References', 'other')", "MODE must be")
+
+%!test
+%! ## Filtered chunks, partial at the dataset edges, read in full and as a
+%! ## hyperslab with and without worker threads
+%! data = reshape (1:37*23, 37, 23);
+%! fname = tempname ();
+%! nthreads = getenv ('OCT_HDF5_NUM_THREADS');
+%! unwind_protect
+%!   fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%!   space = H5S.create_simple (2, fliplr (size (data)), []);
+%!   dcpl = H5P.create ('H5P_DATASET_CREATE');
+%!   H5P.set_chunk (dcpl, [5 8]);
+%!   H5P.set_shuffle (dcpl);
+%!   H5P.set_deflate (dcpl, 6);
+%!   H5P.set_fletcher32 (dcpl);
+%!   dset = H5D.create (fid, '/a', 'H5T_NATIVE_DOUBLE', space, 'H5P_DEFAULT',
+%!                      dcpl, 'H5P_DEFAULT');
+%!   H5D.write (dset, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT',
+%!              data);
+%!   H5S.select_hyperslab (space, 'H5S_SELECT_SET', [3 6], [], [11 20], []);
+%!   for nt = {'1', '4'}
+%!     setenv ('OCT_HDF5_NUM_THREADS', nt{1});
+%!     full = H5D.read (dset);
+%!     slab = H5D.read (dset, 'H5ML_DEFAULT', 'H5S_ALL', space, 'H5P_DEFAULT');
+%!     assert (full, data)
+%!     assert (slab, data(7:26,4:14))
+%!   endfor
+%!   H5P.close (dcpl);
+%!   H5S.close (space);
+%!   H5D.close (dset);
+%!   H5F.close (fid);
+%! unwind_protect_cleanup
+%!   setenv ('OCT_HDF5_NUM_THREADS', nthreads);
+%!   unlink (fname);
+%! end_unwind_protect
+
+%!test
+%! ## Large contiguous datasets of files opened read-only are mapped in
+%! ## memory, read-write files go through H5Dread
+%! data = reshape (1:512*300, 512, 300);
+%! fname = tempname ();
+%! unwind_protect
+%!   fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%!   space = H5S.create_simple (2, fliplr (size (data)), []);
+%!   dset = H5D.create (fid, '/a', 'H5T_NATIVE_DOUBLE', space, 'H5P_DEFAULT');
+%!   H5D.write (dset, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT',
+%!              data);
+%!   H5D.close (dset);
+%!   H5F.close (fid);
+%!   H5S.select_hyperslab (space, 'H5S_SELECT_SET', [100 50], [], [150 400],
+%!                         []);
+%!   full = slab = cell (1, 2);
+%!   modes = {'H5F_ACC_RDONLY', 'H5F_ACC_RDWR'};
+%!   for ii = 1:2
+%!     fid = H5F.open (fname, modes{ii}, 'H5P_DEFAULT');
+%!     dset = H5D.open (fid, '/a');
+%!     full{ii} = H5D.read (dset);
+%!     slab{ii} = H5D.read (dset, 'H5ML_DEFAULT', 'H5S_ALL', space,
+%!                          'H5P_DEFAULT');
+%!     H5D.close (dset);
+%!     H5F.close (fid);
+%!   endfor
+%!   H5S.close (space);
+%!   assert (numel (data) * 8 >= 2^20)
+%!   assert (full{1}, full{2})
+%!   assert (slab{1}, slab{2})
+%!   assert (full{1}, data)
+%!   assert (slab{1}, data(51:450,101:250))
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+%!test
+%! data = reshape (1:12, 3, 4);
+%! fname = tempname ();
+%! fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%! space = H5S.create_simple (2, fliplr (size (data)), []);
+%! dset = H5D.create (fid, '/a', 'H5T_NATIVE_DOUBLE', space, 'H5P_DEFAULT');
+%! H5D.write (dset, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT', data);
+%! memspace = H5S.create_simple (1, numel (data), []);
+%! badspace = H5S.create_simple (1, 5, []);
+%! rdata = H5D.read (dset, 'H5ML_DEFAULT', memspace, 'H5S_ALL', ...
+%!                   'H5P_DEFAULT');
+%! fail ("H5D.read (dset, 'H5ML_DEFAULT', badspace, 'H5S_ALL', 'H5P_DEFAULT')",
+%!       "number of selected elements");
+%! H5S.close (badspace);
+%! H5S.close (memspace);
+%! H5S.close (space);
+%! H5D.close (dset);
+%! H5F.close (fid);
+%! delete (fname);
+%! assert (rdata, data(:))
+
+%!test
+%! data = struct ('a', {1, 2, 3}, 'b', {'x', 'yy', 'zzz'});
+%! fname = tempname ();
+%! fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%! strtype = H5T.copy ('H5T_C_S1');
+%! H5T.set_size (strtype, 'H5T_VARIABLE');
+%! dtype = H5T.create ('H5T_COMPOUND', 16);
+%! H5T.insert (dtype, 'a', 0, 'H5T_NATIVE_DOUBLE');
+%! H5T.insert (dtype, 'b', 8, strtype);
+%! space = H5S.create_simple (1, numel (data), []);
+%! dset = H5D.create (fid, '/a', dtype, space, 'H5P_DEFAULT');
+%! H5D.write (dset, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT', data);
+%! rdata = H5D.read (dset, 'CompoundLayout', 'record');
+%! cdata = H5D.read (dset, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL', ...
+%!                   'H5P_DEFAULT', 'CompoundLayout', 'field');
+%! fail ("H5D.read (dset, 'CompoundLayout', 'rows')", "LAYOUT must be");
+%! H5D.close (dset);
+%! H5S.close (space);
+%! H5T.close (dtype);
+%! H5T.close (strtype);
+%! H5F.close (fid);
+%! delete (fname);
+%! assert (rdata, data(:))
+%! assert (cdata, struct ('a', [1; 2; 3], 'b', {{'x'; 'yy'; 'zzz'}}))
+
+%!test
+%! ## Nested compound, fixed length string and array members
+%! data = struct ('id', {int32(1), int32(2)}, 'name', {'ab', 'cde'}, ...
+%!                'pos', {[1; 2; 3], [4; 5; 6]}, ...
+%!                'inner', {struct('x', 1.5, 'y', uint8(7)), ...
+%!                          struct('x', -2, 'y', uint8(9))});
+%! fname = tempname ();
+%! fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%! strtype = H5T.copy ('H5T_C_S1');
+%! H5T.set_size (strtype, 4);
+%! arrtype = H5T.array_create ('H5T_NATIVE_DOUBLE', 3);
+%! intype = H5T.create ('H5T_COMPOUND', 9);
+%! H5T.insert (intype, 'x', 0, 'H5T_NATIVE_DOUBLE');
+%! H5T.insert (intype, 'y', 8, 'H5T_NATIVE_UINT8');
+%! dtype = H5T.create ('H5T_COMPOUND', 41);
+%! H5T.insert (dtype, 'id', 0, 'H5T_NATIVE_INT32');
+%! H5T.insert (dtype, 'name', 4, strtype);
+%! H5T.insert (dtype, 'pos', 8, arrtype);
+%! H5T.insert (dtype, 'inner', 32, intype);
+%! space = H5S.create_simple (1, numel (data), []);
+%! dset = H5D.create (fid, '/rec', dtype, space, 'H5P_DEFAULT');
+%! H5D.write (dset, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT', data);
+%! rdata = H5D.read (dset, 'CompoundLayout', 'record');
+%! cdata = H5D.read (dset);
+%! H5D.close (dset);
+%! dset = H5D.create (fid, '/field', dtype, space, 'H5P_DEFAULT');
+%! H5D.write (dset, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT',
+%!            setfield (cdata, 'name', {'ab'; 'cde'}));
+%! fdata = H5D.read (dset, 'CompoundLayout', 'record');
+%! fail ("H5D.write (dset, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT', setfield (cdata, 'pos', 1:5))",
+%!       "expecting 6 elements for each array field");
+%! H5D.close (dset);
+%! H5S.close (space);
+%! H5T.close (dtype);
+%! H5T.close (intype);
+%! H5T.close (arrtype);
+%! H5T.close (strtype);
+%! H5F.close (fid);
+%! delete (fname);
+%! assert (rdata, data(:))
+%! assert (fdata, data(:))
+%! assert (cdata.id, int32 ([1; 2]))
+%! assert (cdata.name, ['ab '; 'cde'])
+%! assert (cdata.pos, [1 4; 2 5; 3 6])
+%! assert (cdata.inner, struct ('x', [1.5; -2], 'y', uint8 ([7; 9])))
+
+%!test
+%! ## Scalar structure holding the selected records only
+%! fname = tempname ();
+%! unwind_protect
+%!   fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%!   dtype = H5T.create ('H5T_COMPOUND', 12);
+%!   H5T.insert (dtype, 'a', 0, 'H5T_NATIVE_DOUBLE');
+%!   H5T.insert (dtype, 'b', 8, 'H5T_NATIVE_INT32');
+%!   space = H5S.create_simple (1, 5, []);
+%!   dset = H5D.create (fid, '/rec', dtype, space, 'H5P_DEFAULT');
+%!   H5D.write (dset, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT',
+%!              struct ('a', zeros (5, 1), 'b', zeros (5, 1, 'int32')));
+%!   H5S.select_hyperslab (space, 'H5S_SELECT_SET', 1, [], 3, []);
+%!   H5D.write (dset, 'H5ML_DEFAULT', 'H5S_ALL', space, 'H5P_DEFAULT',
+%!              struct ('a', [1; 2; 3], 'b', int32 ([4; 5; 6])));
+%!   fail ("H5D.write (dset, 'H5ML_DEFAULT', 'H5S_ALL', space, 'H5P_DEFAULT', struct ('a', [1; 2], 'b', int32 ([4; 5])))",
+%!         "DATA has 2 elements");
+%!   rdata = H5D.read (dset);
+%!   H5D.close (dset);
+%!   H5S.close (space);
+%!   H5T.close (dtype);
+%!   H5F.close (fid);
+%!   assert (rdata, struct ('a', [0; 1; 2; 3; 0], 'b', int32 ([0; 4; 5; 6; 0])))
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+*/
+
+// PKG_ADD: autoload ("__H5D_read_chunk__", "__H5D__.oct");
+// PKG_DEL: autoload ("__H5D_read_chunk__", "__H5D__.oct", "remove");
+DEFUN_DLD(__H5D_read_chunk__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {[@var{filter_mask}, @var{data}] = } H5D.read_chunk (@var{dataset_id}, @var{xfer_plist_id}, @var{offset})\n\
+Read a raw chunk from a dataset, bypassing the filter pipeline.\n\
+\n\
+@strong{Parameters:}\n\
+ @multitable @columnfractions 0.33 0.02 0.65\n\
+ @item @var{dataset_id} @tab @tab Dataset identifier\n\
+ @item @var{xfer_plist_id} @tab @tab Transfer property list identifier or \
+@code{H5P_DEFAULT}\n\
+ @item @var{offset} @tab @tab Zero-based logical coordinates of the first \
+element of the chunk\n\
+ @end multitable\n\
+\n\
+@strong{Description:}\n\
+\n\
+@var{data} is a uint8 column vector holding the chunk bytes as stored in \
+the file, i.e. after filtering, and @var{filter_mask} has bit @var{n} set \
+when the @var{n}-th filter of the pipeline was skipped for this chunk. \
+Together they can be passed to @code{H5D.write_chunk} to copy the chunk to \
+a dataset with the same type, chunk size and filters without \
+decompressing it.\n\
+\n\
+See original function at \
+@url{https://portal.hdfgroup.org/display/HDF5/H5D_READ_CHUNK}.\n\
+\n\
+@seealso{H5D.write_chunk,H5D.get_chunk_info}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  int nargin = args.length ();
+
+  if (nargin != 3)
+    print_usage ("H5D.read_chunk");
+
+  // Dataset ID
+  hid_t dataset_id = get_h5_id (args, 0, "DATASET_ID", "H5D.read_chunk",
+                                false);
+
+  // Transfer plist ID
+  hid_t xfer_plist_id = get_h5_id (args, 1, "XFER_PLIST_ID",
+                                   "H5D.read_chunk");
+
+  // Chunk offset
+  std::vector<hsize_t> offset = get_chunk_offset (args, 2, dataset_id,
+                                                  "H5D.read_chunk");
+
+#if H5_VERSION_GE(1, 10, 3)
+  hsize_t nbytes = 0;
+
+  if (H5Dget_chunk_storage_size (dataset_id, offset.data (), &nbytes) < 0)
+    error ("H5D.read_chunk: unable to retrieve chunk size");
+
+  uint8NDArray data (dim_vector (nbytes, 1));
+  uint32_t filter_mask = 0;
+
+  if (nbytes > 0
+      && H5Dread_chunk (dataset_id, xfer_plist_id, offset.data (),
+                        &filter_mask, data.fortran_vec ()) < 0)
+    error ("H5D.read_chunk: unable to read chunk");
+
+  retval.append (static_cast<double> (filter_mask));
+  retval.append (data);
+#else
+  error ("H5D.read_chunk: requires HDF5 1.10.3 or later");
+#endif
+
+  return retval;
+}
+
+/*
+%!fail ("H5D.read_chunk ()", "Invalid call");
+
+%!fail ("H5D.read_chunk ('toto', 'H5P_DEFAULT', 0)", "DATASET_ID must be a scalar numeric identifier");
+*/
+
+// PKG_ADD: autoload ("__H5D_read_into__", "__H5D__.oct");
+// PKG_DEL: autoload ("__H5D_read_into__", "__H5D__.oct", "remove");
+DEFUN_DLD(__H5D_read_into__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {@var{data} = } H5D.read_into (@var{dataset_id}, @var{data})\n\
+@deftypefnx {} {@var{data} = } H5D.read_into (@var{dataset_id}, @var{mem_type_id}, @var{mem_space_id}, @var{file_space_id}, @var{xfer_plist_id}, @var{data})\n\
+Import numeric data from dataset into an existing array.\n\
+\n\
+@strong{Parameters:}\n\
+ @multitable @columnfractions 0.33 0.02 0.65\n\
+ @item @var{dataset_id} @tab @tab Location or dataset identifier\n\
+ @item @var{mem_type_id} @tab @tab Target datatype (use @code{H5ML_DEFAULT} \
+for automatic conversion)\n\
+ @item @var{mem_space_id} @tab @tab Imported data dataspace identifier or \
+@code{H5S_ALL}\n\
+ @item @var{file_space_id} @tab @tab Original data dataspace identifier or \
+@code{H5S_ALL}\n\
+ @item @var{xfer_plist_id} @tab @tab Transfer property list identifier or \
+@code{H5P_DEFAULT}\n\
+ @item @var{data} @tab @tab Array receiving the data\n\
+ @end multitable\n\
+\n\
+@strong{Description:}\n\
+\n\
+Same as @code{H5D.read} for numeric and reference data, except that the \
+values are stored in the memory already allocated for @var{data} instead of \
+a newly allocated array. This avoids repeated allocations when reading \
+datasets of the same size in a loop. @var{data} must be a real array of the \
+class and size that @code{H5D.read} would return for the same arguments.\n\
+\n\
+The memory of @var{data} is reused unless another array shares it, e.g. \
+an array obtained with @code{reshape (@var{data}, @dots{})}. The values are \
+then read into a copy and that array is left unchanged. Variables that \
+were assigned @var{data} hold the same array and therefore also see the \
+new values. The output must always be assigned back to @var{data}.\n\
+\n\
+@seealso{H5D.read,H5A.read_into}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  int nargin = args.length ();
+
+  if (nargin != 2 && nargin != 6)
+    print_usage ("H5D.read_into");
+
+  // Dataset ID
+  hid_t dataset_id = get_h5_id (args, 0, "DATASET_ID", "H5D.read_into",
+                                false);
+
+  // Data buffer memory type ID
+  hid_t mem_type_id = H5Dget_type (dataset_id);
+
+  if (nargin > 2
+      && (! args(1).is_string ()
+          || args(1).string_value () != "H5ML_DEFAULT"))
+        mem_type_id = get_h5_id (args, 1, "MEM_TYPE_ID", "H5D.read_into");
+
+  // Data buffer space ID
+  hid_t mem_space_id = H5S_ALL;
+
+  if (nargin > 2)
+    mem_space_id = get_h5_id (args, 2, "MEM_SPACE_ID", "H5D.read_into");
+
+  // File space ID
+  hid_t file_space_id = H5S_ALL;
+
+  if (nargin > 2)
+    file_space_id = get_h5_id (args, 3, "FILE_SPACE_ID", "H5D.read_into");
+
+  // Transfer plist ID
+  hid_t xfer_plist_id = H5P_DEFAULT;
+
+  if (nargin > 2)
+    xfer_plist_id = get_h5_id (args, 4, "XFER_PLIST_ID", "H5D.read_into");
+
+  // Receiving array
+  retval = ovl (read_dataset ("H5D.read_into", dataset_id, mem_type_id,
+                               mem_space_id, file_space_id, xfer_plist_id,
+                               false, &args(nargin-1)));
+
+  return retval;
+}
+
+/*
+%!test
+%! fail ("H5D.read_into (1)", "Invalid call");
+
+%!test
+%! data = reshape (int32 (1:12), 3, 4);
+%! fname = tempname ();
+%! fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%! space = H5S.create_simple (2, fliplr (size (data)), []);
+%! dset = H5D.create (fid, '/a', 'H5T_STD_I32BE', space, 'H5P_DEFAULT');
+%! H5D.write (dset, 'H5T_NATIVE_INT32', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT',
+%!            data);
+%! buf = zeros (3, 4, 'int32');
+%! alias = buf;
+%! buf = H5D.read_into (dset, buf);
+%! shared = zeros (3, 4, 'int32');
+%! shaped = reshape (shared, 4, 3);
+%! shared = H5D.read_into (dset, shared);
+%! fail ("H5D.read_into (dset, zeros (3, 4))", "must be a real int32 array");
+%! fail ("H5D.read_into (dset, zeros (4, 3, 'int32'))", "must be of size 3x4");
+%! H5S.close (space);
+%! H5D.close (dset);
+%! H5F.close (fid);
+%! delete (fname);
+%! assert (buf, data)
+%! assert (alias, data)
+%! assert (shared, data)
+%! assert (shaped, zeros (4, 3, 'int32'))
+
 */
 
 // PKG_ADD: autoload ("__H5D_write__", "__H5D__.oct");
@@ -516,7 +1476,28 @@ See original function at \
 DEFUN_DLD(__H5D_write__, args, , 
 "-*- texinfo -*-\n\
 @deftypefn {} {} H5D.write (@var{dataset_id}, @var{mem_type_id}, @var{mem_space_id}, @var{file_space_id}, @var{xfer_plist_id}, @var{data})\n\
-@seealso{}\n\
+Write data to dataset.\n\
+\n\
+When @var{mem_space_id} is a dataspace, @var{data} must hold as many \
+elements as its extent and the elements selected in memory are written to \
+the elements selected in @var{file_space_id}. When @var{mem_space_id} is \
+@code{H5S_ALL}, @var{data} holds either the whole dataset or only the \
+elements selected in @var{file_space_id}, shaped as for @code{H5D.read}. \
+Only the selected elements are written to the file.\n\
+\n\
+For compound data types, @var{data} is either a scalar struct whose fields \
+hold one value per record, or a struct array with one element per record. \
+The number of records follows the same rules as the number of elements of \
+numeric @var{data}.\n\
+\n\
+Numeric data written to chunked datasets compressed with the deflate \
+filter, optionally combined with the shuffle and fletcher32 filters, are \
+compressed in parallel when the memory type matches the dataset type and \
+the selection is a single block made of whole chunks, or extending to the \
+edge of the dataset. The number of threads is controlled by the \
+@env{OCT_HDF5_NUM_THREADS} environment variable as for @code{H5D.read}.\n\
+\n\
+@seealso{H5D.read}\n\
 @end deftypefn")
 {
   octave_value_list retval;
@@ -576,6 +1557,26 @@ DEFUN_DLD(__H5D_write__, args, ,
 %! delete (fname);
 %! assert (true)
 
+%!test
+%! fname = tempname ();
+%! fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%! space = H5S.create_simple (1, 6, []);
+%! mspace = H5S.create_simple (2, [2 3], []);
+%! dset = H5D.create (fid, '/a', 'H5T_NATIVE_DOUBLE', space, 'H5P_DEFAULT');
+%! H5D.write (dset, 'H5ML_DEFAULT', mspace, 'H5S_ALL', 'H5P_DEFAULT',
+%!            [1 2; 3 4; 5 6]);
+%! fail ("H5D.write (dset, 'H5ML_DEFAULT', mspace, 'H5S_ALL', 'H5P_DEFAULT', 1:5)",
+%!       "DATA has 5 elements but MEM_SPACE_ID holds 6");
+%! fail ("H5D.write (dset, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT', 1:5)",
+%!       "DATA has 5 elements but the dataset holds 6");
+%! data = H5D.read (dset);
+%! H5D.close (dset);
+%! H5S.close (mspace);
+%! H5S.close (space);
+%! H5F.close (fid);
+%! delete (fname);
+%! assert (data(:), [1; 3; 5; 2; 4; 6])
+
 %!test
 %! ## For compatibility with ML, in vlstrings vertical char arrays are turned
 %! ## horizontal
@@ -668,4 +1669,200 @@ DEFUN_DLD(__H5D_write__, args, ,
 %! delete (fname)
 %! assert (item, sub_data)
 
+%!test
+%! ## Fixed length strings are written one per row, short strings padded
+%! fname = tempname ();
+%! unwind_protect
+%!   fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%!   strtype = H5T.copy ('H5T_C_S1');
+%!   H5T.set_size (strtype, 8);
+%!   space = H5S.create ('H5S_SCALAR');
+%!   dset = H5D.create (fid, '/scalar', strtype, space, 'H5P_DEFAULT');
+%!   H5D.write (dset, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT', 'ab');
+%!   str = H5D.read (dset);
+%!   H5D.close (dset);
+%!   H5S.close (space);
+%!   rows = char ('ab', 'cde', 'fghijkl');
+%!   space = H5S.create_simple (1, 3, []);
+%!   dset = H5D.create (fid, '/rows', strtype, space, 'H5P_DEFAULT');
+%!   H5D.write (dset, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT',
+%!              rows);
+%!   rdata = H5D.read (dset);
+%!   fail ("H5D.write (dset, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT', rows(1:2,:))",
+%!         "DATA has 2 elements");
+%!   H5D.close (dset);
+%!   H5S.close (space);
+%!   H5T.close (strtype);
+%!   H5F.close (fid);
+%!   assert (str, 'ab')
+%!   assert (rdata, rows)
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+*/
+
+// PKG_ADD: autoload ("__H5D_write_chunk__", "__H5D__.oct");
+// PKG_DEL: autoload ("__H5D_write_chunk__", "__H5D__.oct", "remove");
+DEFUN_DLD(__H5D_write_chunk__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {} H5D.write_chunk (@var{dataset_id}, @var{xfer_plist_id}, @var{filter_mask}, @var{offset}, @var{data})\n\
+Write a raw chunk to a dataset, bypassing the filter pipeline.\n\
+\n\
+@strong{Parameters:}\n\
+ @multitable @columnfractions 0.33 0.02 0.65\n\
+ @item @var{dataset_id} @tab @tab Dataset identifier\n\
+ @item @var{xfer_plist_id} @tab @tab Transfer property list identifier or \
+@code{H5P_DEFAULT}\n\
+ @item @var{filter_mask} @tab @tab Mask of the filters that were skipped \
+when encoding @var{data}\n\
+ @item @var{offset} @tab @tab Zero-based logical coordinates of the first \
+element of the chunk\n\
+ @item @var{data} @tab @tab uint8 array of chunk bytes, already filtered\n\
+ @end multitable\n\
+\n\
+@strong{Description:}\n\
+\n\
+The bytes of @var{data} are stored as is and must be the result of \
+applying the filters of the dataset, except those flagged in \
+@var{filter_mask}, to a whole chunk. They are typically obtained with \
+@code{H5D.read_chunk}.\n\
+\n\
+See original function at \
+@url{https://portal.hdfgroup.org/display/HDF5/H5D_WRITE_CHUNK}.\n\
+\n\
+@seealso{H5D.read_chunk}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  int nargin = args.length ();
+
+  if (nargin != 5)
+    print_usage ("H5D.write_chunk");
+
+  // Dataset ID
+  hid_t dataset_id = get_h5_id (args, 0, "DATASET_ID", "H5D.write_chunk",
+                                false);
+
+  // Transfer plist ID
+  hid_t xfer_plist_id = get_h5_id (args, 1, "XFER_PLIST_ID",
+                                   "H5D.write_chunk");
+
+  // Filter mask
+  double mask = args(2).xdouble_value ("H5D.write_chunk: FILTER_MASK must "
+                                       "be a numeric scalar");
+
+  if (mask < 0 || mask > 0xffffffff || mask != std::floor (mask))
+    error ("H5D.write_chunk: FILTER_MASK must be a 32-bit unsigned integer");
+
+  // Chunk bytes
+  if (! args(4).is_uint8_type ())
+    error ("H5D.write_chunk: DATA must be a uint8 array");
+
+  uint8NDArray data = args(4).uint8_array_value ();
+
+  // Chunk offset
+  std::vector<hsize_t> offset = get_chunk_offset (args, 3, dataset_id,
+                                                  "H5D.write_chunk");
+
+#if H5_VERSION_GE(1, 10, 3)
+  if (H5Dwrite_chunk (dataset_id, xfer_plist_id,
+                      static_cast<uint32_t> (mask), offset.data (),
+                      data.numel (), data.data ()) < 0)
+    error ("H5D.write_chunk: unable to write chunk");
+#else
+  error ("H5D.write_chunk: requires HDF5 1.10.3 or later");
+#endif
+
+  return retval;
+}
+
+/*
+%!fail ("H5D.write_chunk ()", "Invalid call");
+
+%!fail ("H5D.write_chunk (1, 'H5P_DEFAULT', 0, 0, [1 2 3])", "DATA must be a uint8 array");
+
+%!test
+%! ## Raw chunks are copied between deflated datasets, and unfiltered bytes
+%! ## are stored when the filter is masked
+%! data = reshape (1:40, 5, 8);
+%! fname = tempname ();
+%! unwind_protect
+%!   fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%!   space = H5S.create_simple (2, [8 5], []);
+%!   dcpl = H5P.create ('H5P_DATASET_CREATE');
+%!   H5P.set_chunk (dcpl, [4 5]);
+%!   H5P.set_deflate (dcpl, 9);
+%!   src = H5D.create (fid, '/src', 'H5T_NATIVE_DOUBLE', space, 'H5P_DEFAULT',
+%!                     dcpl, 'H5P_DEFAULT');
+%!   H5D.write (src, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT', data);
+%!   [mask, bytes] = H5D.read_chunk (src, 'H5P_DEFAULT', [4 0]);
+%!   raw = typecast (reshape (data(:,1:4), [], 1), 'uint8');
+%!   dst = H5D.create (fid, '/dst', 'H5T_NATIVE_DOUBLE', space, 'H5P_DEFAULT',
+%!                     dcpl, 'H5P_DEFAULT');
+%!   H5D.write_chunk (dst, 'H5P_DEFAULT', mask, [4 0], bytes);
+%!   H5D.write_chunk (dst, 'H5P_DEFAULT', 1, [0 0], raw);
+%!   [mask2, bytes2] = H5D.read_chunk (dst, 'H5P_DEFAULT', [4 0]);
+%!   [mask3, bytes3] = H5D.read_chunk (dst, 'H5P_DEFAULT', [0 0]);
+%!   rdata = H5D.read (dst);
+%!   H5D.close (dst);
+%!   H5D.close (src);
+%!   H5P.close (dcpl);
+%!   H5S.close (space);
+%!   H5F.close (fid);
+%!   assert (mask, 0)
+%!   assert (numel (bytes) < 20 * 8)
+%!   assert (mask2, mask)
+%!   assert (bytes2, bytes)
+%!   assert (mask3, 1)
+%!   assert (bytes3, raw)
+%!   assert (rdata, data)
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+%!test
+%! ## Edge chunks compressed in parallel are padded with the fill value,
+%! ## which shows once they are copied inside a larger dataset
+%! data = reshape (1:70, 10, 7);
+%! fname = tempname ();
+%! nthreads = getenv ('OCT_HDF5_NUM_THREADS');
+%! unwind_protect
+%!   fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%!   space = H5S.create_simple (2, [7 10], []);
+%!   dcpl = H5P.create ('H5P_DATASET_CREATE');
+%!   H5P.set_chunk (dcpl, [4 4]);
+%!   H5P.set_fill_value (dcpl, 'H5T_NATIVE_DOUBLE', -1);
+%!   H5P.set_shuffle (dcpl);
+%!   H5P.set_deflate (dcpl, 6);
+%!   H5P.set_fletcher32 (dcpl);
+%!   src = H5D.create (fid, '/src', 'H5T_NATIVE_DOUBLE', space, 'H5P_DEFAULT',
+%!                     dcpl, 'H5P_DEFAULT');
+%!   setenv ('OCT_HDF5_NUM_THREADS', '4');
+%!   H5D.write (src, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT', data);
+%!   H5S.close (space);
+%!   space = H5S.create_simple (2, [8 12], []);
+%!   dst = H5D.create (fid, '/dst', 'H5T_NATIVE_DOUBLE', space, 'H5P_DEFAULT',
+%!                     dcpl, 'H5P_DEFAULT');
+%!   for offset = {[0 0], [0 4], [0 8], [4 0], [4 4], [4 8]}
+%!     [mask, bytes] = H5D.read_chunk (src, 'H5P_DEFAULT', offset{1});
+%!     H5D.write_chunk (dst, 'H5P_DEFAULT', mask, offset{1}, bytes);
+%!   endfor
+%!   setenv ('OCT_HDF5_NUM_THREADS', '1');
+%!   rdata = H5D.read (src);
+%!   xdata = H5D.read (dst);
+%!   H5D.close (dst);
+%!   H5D.close (src);
+%!   H5P.close (dcpl);
+%!   H5S.close (space);
+%!   H5F.close (fid);
+%!   expected = -ones (12, 8);
+%!   expected(1:10,1:7) = data;
+%!   assert (rdata, data)
+%!   assert (xdata, expected)
+%! unwind_protect_cleanup
+%!   setenv ('OCT_HDF5_NUM_THREADS', nthreads);
+%!   unlink (fname);
+%! end_unwind_protect
 */
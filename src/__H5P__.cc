@@ -20,6 +20,11 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include <octave/oct.h>
 #include <hdf5.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
 #include "./util/h5_oct_util.h"
 // PKG_ADD: autoload ("__H5P_close__", "__H5P__.oct");
 // PKG_DEL: autoload ("__H5P_close__", "__H5P__.oct", "remove");
@@ -133,6 +138,68 @@ DEFUN_DLD(__H5P_get_chunk__, args, ,
   return retval;
 }
 
+// PKG_ADD: autoload ("__H5P_get_filter__", "__H5P__.oct");
+// PKG_DEL: autoload ("__H5P_get_filter__", "__H5P__.oct", "remove");
+DEFUN_DLD(__H5P_get_filter__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {[@var{filter_id}, @var{flags}, @var{cd_values}, @var{name}, @var{filter_config}] = } H5P.get_filter (@var{plist_id}, @var{idx})\n\
+Return information about the filter of index @var{idx}, zero-based, in the \
+filter pipeline of the dataset creation property list @var{plist_id}.\n\
+\n\
+@var{filter_id} is the filter identifier, e.g. the value of \
+@qcode{'H5Z_FILTER_DEFLATE'}, @var{flags} the filter flags, \
+@var{cd_values} the auxiliary data of the filter, such as the compression \
+level of the deflate filter, @var{name} its name and @var{filter_config} \
+the bit field telling whether encoding and decoding are enabled.\n\
+\n\
+See original function at \
+@url{https://portal.hdfgroup.org/display/HDF5/H5P_GET_FILTER2}.\n\
+\n\
+@seealso{H5P.get_nfilters,H5D.get_create_plist}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  int nargin = args.length ();
+
+  if (nargin != 2)
+    print_usage ("H5P.get_filter");
+
+  // Property list ID
+  hid_t plist_id = get_h5_id (args, 0, "PLIST_ID", "H5P.get_filter");
+
+  // Filter index
+  int idx = args(1).xint_value ("H5P.get_filter: IDX must be an integer");
+
+  unsigned int flags = 0;
+  size_t cd_nelmts = 32;
+  unsigned int cd_values[32];
+  char name[256] = "";
+  unsigned int filter_config = 0;
+
+  H5Z_filter_t filter_id
+    = H5Pget_filter2 (plist_id, idx, &flags, &cd_nelmts, cd_values,
+                      sizeof (name), name, &filter_config);
+
+  if (filter_id < 0)
+    error ("H5P.get_filter: unable to get filter %d", idx);
+
+  cd_nelmts = std::min<size_t> (cd_nelmts, 32);
+
+  Matrix ocd_values (1, cd_nelmts, 0.0);
+
+  for (size_t ii = 0; ii < cd_nelmts; ii++)
+    ocd_values(ii) = cd_values[ii];
+
+  retval.append (octave_int64 (filter_id));
+  retval.append (static_cast<double> (flags));
+  retval.append (ocd_values);
+  retval.append (std::string (name));
+  retval.append (static_cast<double> (filter_config));
+
+  return retval;
+}
+
 // PKG_ADD: autoload ("__H5P_get_layout__", "__H5P__.oct");
 // PKG_DEL: autoload ("__H5P_get_layout__", "__H5P__.oct", "remove");
 DEFUN_DLD(__H5P_get_layout__, args, , 
@@ -159,4 +226,524 @@ DEFUN_DLD(__H5P_get_layout__, args, ,
   return retval.append (octave_int64 (layout_id));
 }
 
+// PKG_ADD: autoload ("__H5P_get_nfilters__", "__H5P__.oct");
+// PKG_DEL: autoload ("__H5P_get_nfilters__", "__H5P__.oct", "remove");
+DEFUN_DLD(__H5P_get_nfilters__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {@var{nfilters} = } H5P.get_nfilters (@var{plist_id})\n\
+Return the number of filters in the filter pipeline of the dataset \
+creation property list @var{plist_id}.\n\
+@seealso{H5P.get_filter,H5D.get_create_plist}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  int nargin = args.length ();
+
+  if (nargin != 1)
+    print_usage ("H5P.get_nfilters");
+
+  // Property list ID
+  hid_t plist_id = get_h5_id (args, 0, "PLIST_ID", "H5P.get_nfilters");
+
+  int nfilters = H5Pget_nfilters (plist_id);
+
+  if (nfilters < 0)
+    error ("H5P.get_nfilters: unable to get number of filters");
+
+  return retval.append (static_cast<double> (nfilters));
+}
+
+// PKG_ADD: autoload ("__H5P_set_alloc_time__", "__H5P__.oct");
+// PKG_DEL: autoload ("__H5P_set_alloc_time__", "__H5P__.oct", "remove");
+DEFUN_DLD(__H5P_set_alloc_time__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {} H5P.set_alloc_time (@var{plist_id}, @var{alloc_time})\n\
+Set the time at which storage is allocated for datasets created with the \
+dataset creation property list @var{plist_id}.\n\
+\n\
+@var{alloc_time} is one of @qcode{'H5D_ALLOC_TIME_DEFAULT'}, \
+@qcode{'H5D_ALLOC_TIME_EARLY'}, when the dataset is created, \
+@qcode{'H5D_ALLOC_TIME_INCR'}, as chunks are written, or \
+@qcode{'H5D_ALLOC_TIME_LATE'}, when data are first written.\n\
+@seealso{H5P.set_fill_time,H5P.create}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  int nargin = args.length ();
+
+  if (nargin != 2)
+    print_usage ("H5P.set_alloc_time");
+
+  // Property list ID
+  hid_t plist_id = get_h5_id (args, 0, "PLIST_ID", "H5P.set_alloc_time");
+
+  // Allocation time
+  H5D_alloc_time_t alloc_time
+    = static_cast<H5D_alloc_time_t> (get_h5_id (args, 1, "ALLOC_TIME",
+                                                "H5P.set_alloc_time"));
+
+  if (H5Pset_alloc_time (plist_id, alloc_time) < 0)
+    error ("H5P.set_alloc_time: unable to set allocation time");
+
+  return retval;
+}
+
+// PKG_ADD: autoload ("__H5P_set_chunk__", "__H5P__.oct");
+// PKG_DEL: autoload ("__H5P_set_chunk__", "__H5P__.oct", "remove");
+DEFUN_DLD(__H5P_set_chunk__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {} H5P.set_chunk (@var{plist_id}, @var{dims})\n\
+Set the dimensions of the chunks of datasets created with the dataset \
+creation property list @var{plist_id}, and their layout to \
+@qcode{'H5D_CHUNKED'}.\n\
+\n\
+@var{dims} has one element per dimension, in the same order as for \
+@code{H5S.create_simple}. Chunking is required by all filters, e.g. \
+@code{H5P.set_deflate}.\n\
+@seealso{H5P.get_chunk,H5P.set_deflate,H5D.create}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  int nargin = args.length ();
+
+  if (nargin != 2)
+    print_usage ("H5P.set_chunk");
+
+  // Property list ID
+  hid_t plist_id = get_h5_id (args, 0, "PLIST_ID", "H5P.set_chunk");
+
+  // Chunk dimensions
+  NDArray tmp = args(1).xarray_value ("H5P.set_chunk: DIMS must be a "
+                                      "numeric vector");
+
+  int rank = tmp.numel ();
+
+  if (rank < 1 || rank > H5S_MAX_RANK)
+    error ("H5P.set_chunk: DIMS must have between 1 and %d elements",
+           H5S_MAX_RANK);
+
+  std::vector<hsize_t> dims (rank);
+
+  for (int ii = 0; ii < rank; ii++)
+    {
+      if (tmp(ii) < 1 || tmp(ii) != std::floor (tmp(ii)))
+        error ("H5P.set_chunk: DIMS must contain positive integers");
+
+      dims[ii] = static_cast<hsize_t> (tmp(ii));
+    }
+
+  if (H5Pset_chunk (plist_id, rank, dims.data ()) < 0)
+    error ("H5P.set_chunk: unable to set chunk dimensions");
+
+  return retval;
+}
+
+/*
+%!test
+%! dcpl = H5P.create ('H5P_DATASET_CREATE');
+%! H5P.set_chunk (dcpl, [10 20]);
+%! [rank, dims] = H5P.get_chunk (dcpl);
+%! assert (rank, 2)
+%! assert (dims, [10 20])
+%! assert (double (H5P.get_layout (dcpl)),
+%!         double (H5ML.get_constant_value ('H5D_CHUNKED')))
+%! H5P.close (dcpl);
+
+%!fail ("H5P.set_chunk ('H5P_DEFAULT', [0 1])", "DIMS must contain positive integers")
+*/
+
+// PKG_ADD: autoload ("__H5P_set_deflate__", "__H5P__.oct");
+// PKG_DEL: autoload ("__H5P_set_deflate__", "__H5P__.oct", "remove");
+DEFUN_DLD(__H5P_set_deflate__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {} H5P.set_deflate (@var{plist_id}, @var{level})\n\
+Add the deflate (gzip) compression filter, with compression @var{level} \
+from 0 to 9, to the filter pipeline of the dataset creation property list \
+@var{plist_id}.\n\
+\n\
+Datasets must be chunked, see @code{H5P.set_chunk}. The deflate filter is \
+usually preceded by the shuffle filter, see @code{H5P.set_shuffle}, which \
+improves the compression of multi-byte data.\n\
+@seealso{H5P.set_chunk,H5P.set_shuffle,H5P.get_filter}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  int nargin = args.length ();
+
+  if (nargin != 2)
+    print_usage ("H5P.set_deflate");
+
+  // Property list ID
+  hid_t plist_id = get_h5_id (args, 0, "PLIST_ID", "H5P.set_deflate");
+
+  // Compression level
+  int level = args(1).xint_value ("H5P.set_deflate: LEVEL must be an "
+                                  "integer");
+
+  if (level < 0 || level > 9)
+    error ("H5P.set_deflate: LEVEL must be between 0 and 9");
+
+  if (H5Pset_deflate (plist_id, level) < 0)
+    error ("H5P.set_deflate: unable to set deflate filter");
+
+  return retval;
+}
+
+/*
+%!test
+%! fname = tempname ();
+%! unwind_protect
+%!   data = repmat (int32 (1:100).', 1, 50);
+%!   fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%!   space = H5S.create_simple (2, fliplr (size (data)), []);
+%!   dcpl = H5P.create ('H5P_DATASET_CREATE');
+%!   H5P.set_chunk (dcpl, [10 100]);
+%!   H5P.set_shuffle (dcpl);
+%!   H5P.set_deflate (dcpl, 6);
+%!   H5P.set_fletcher32 (dcpl);
+%!   dset = H5D.create (fid, 'data', 'H5T_NATIVE_INT32', space, 'H5P_DEFAULT',
+%!                      dcpl, 'H5P_DEFAULT');
+%!   H5D.write (dset, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT',
+%!              data);
+%!   H5P.close (dcpl);
+%!   dcpl = H5D.get_create_plist (dset);
+%!   assert (H5P.get_nfilters (dcpl), 3)
+%!   [filter_id, ~, cd_values] = H5P.get_filter (dcpl, 1);
+%!   assert (filter_id, H5ML.get_constant_value ('H5Z_FILTER_DEFLATE'))
+%!   assert (cd_values, 6)
+%!   assert (H5P.get_filter (dcpl, 0),
+%!           H5ML.get_constant_value ('H5Z_FILTER_SHUFFLE'))
+%!   assert (H5P.get_filter (dcpl, 2),
+%!           H5ML.get_constant_value ('H5Z_FILTER_FLETCHER32'))
+%!   assert (H5D.read (dset), data)
+%!   H5P.close (dcpl);
+%!   H5D.close (dset);
+%!   H5S.close (space);
+%!   H5F.close (fid);
+%!   assert (stat (fname).size < numel (data) * 4 / 2)
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+%!fail ("H5P.set_deflate ('H5P_DEFAULT', 10)", "LEVEL must be between 0 and 9")
+*/
+
+// PKG_ADD: autoload ("__H5P_set_fill_time__", "__H5P__.oct");
+// PKG_DEL: autoload ("__H5P_set_fill_time__", "__H5P__.oct", "remove");
+DEFUN_DLD(__H5P_set_fill_time__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {} H5P.set_fill_time (@var{plist_id}, @var{fill_time})\n\
+Set the time at which the storage of datasets created with the dataset \
+creation property list @var{plist_id} is filled with the fill value.\n\
+\n\
+@var{fill_time} is one of @qcode{'H5D_FILL_TIME_IFSET'} (default), only if \
+a fill value was set with @code{H5P.set_fill_value}, \
+@qcode{'H5D_FILL_TIME_ALLOC'}, when storage is allocated, or \
+@qcode{'H5D_FILL_TIME_NEVER'}, in which case unwritten elements are \
+undefined.\n\
+@seealso{H5P.set_fill_value,H5P.set_alloc_time}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  int nargin = args.length ();
+
+  if (nargin != 2)
+    print_usage ("H5P.set_fill_time");
 
+  // Property list ID
+  hid_t plist_id = get_h5_id (args, 0, "PLIST_ID", "H5P.set_fill_time");
+
+  // Fill time
+  H5D_fill_time_t fill_time
+    = static_cast<H5D_fill_time_t> (get_h5_id (args, 1, "FILL_TIME",
+                                               "H5P.set_fill_time"));
+
+  if (H5Pset_fill_time (plist_id, fill_time) < 0)
+    error ("H5P.set_fill_time: unable to set fill time");
+
+  return retval;
+}
+
+// PKG_ADD: autoload ("__H5P_set_fill_value__", "__H5P__.oct");
+// PKG_DEL: autoload ("__H5P_set_fill_value__", "__H5P__.oct", "remove");
+DEFUN_DLD(__H5P_set_fill_value__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {} H5P.set_fill_value (@var{plist_id}, @var{type_id}, @var{value})\n\
+Set the value of the unwritten elements of datasets created with the \
+dataset creation property list @var{plist_id}.\n\
+\n\
+The numeric or logical scalar @var{value} is converted to the data type \
+@var{type_id}, which is in turn converted to the type of the dataset when \
+it is created.\n\
+@seealso{H5P.fill_value_defined,H5P.set_fill_time}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  int nargin = args.length ();
+
+  if (nargin != 3)
+    print_usage ("H5P.set_fill_value");
+
+  // Property list ID
+  hid_t plist_id = get_h5_id (args, 0, "PLIST_ID", "H5P.set_fill_value");
+
+  // Type ID
+  hid_t type_id = get_h5_id (args, 1, "TYPE_ID", "H5P.set_fill_value");
+
+  // Value, converted from its native type
+  octave_value val = args(2);
+
+  if (! (val.isnumeric () || val.islogical ()) || val.iscomplex ()
+      || val.numel () != 1)
+    error ("H5P.set_fill_value: VALUE must be a real numeric scalar");
+
+  hid_t val_type_id = H5T_NATIVE_DOUBLE;
+  std::vector<char> buf (std::max<size_t> (H5Tget_size (type_id), 8));
+
+  if (val.is_int64_type ())
+    {
+      int64_t tmp = val.int64_scalar_value ().value ();
+      val_type_id = H5T_NATIVE_INT64;
+      std::memcpy (buf.data (), &tmp, sizeof (tmp));
+    }
+  else if (val.is_uint64_type ())
+    {
+      uint64_t tmp = val.uint64_scalar_value ().value ();
+      val_type_id = H5T_NATIVE_UINT64;
+      std::memcpy (buf.data (), &tmp, sizeof (tmp));
+    }
+  else
+    {
+      double tmp = val.double_value ();
+      std::memcpy (buf.data (), &tmp, sizeof (tmp));
+    }
+
+  if (H5Tconvert (val_type_id, type_id, 1, buf.data (), nullptr,
+                  H5P_DEFAULT) < 0)
+    error ("H5P.set_fill_value: unable to convert VALUE to TYPE_ID");
+
+  if (H5Pset_fill_value (plist_id, type_id, buf.data ()) < 0)
+    error ("H5P.set_fill_value: unable to set fill value");
+
+  return retval;
+}
+
+/*
+%!test
+%! fname = tempname ();
+%! unwind_protect
+%!   fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%!   space = H5S.create_simple (1, 4, []);
+%!   dcpl = H5P.create ('H5P_DATASET_CREATE');
+%!   H5P.set_layout (dcpl, 'H5D_COMPACT');
+%!   H5P.set_alloc_time (dcpl, 'H5D_ALLOC_TIME_EARLY');
+%!   H5P.set_fill_time (dcpl, 'H5D_FILL_TIME_ALLOC');
+%!   H5P.set_fill_value (dcpl, 'H5T_NATIVE_INT16', -7);
+%!   assert (H5P.fill_value_defined (dcpl),
+%!           H5ML.get_constant_value ('H5D_FILL_VALUE_USER_DEFINED'))
+%!   dset = H5D.create (fid, 'data', 'H5T_STD_I16LE', space, 'H5P_DEFAULT',
+%!                      dcpl, 'H5P_DEFAULT');
+%!   assert (H5D.read (dset), int16 ([-7; -7; -7; -7]))
+%!   H5P.close (dcpl);
+%!   dcpl = H5D.get_create_plist (dset);
+%!   assert (double (H5P.get_layout (dcpl)),
+%!           double (H5ML.get_constant_value ('H5D_COMPACT')))
+%!   H5P.close (dcpl);
+%!   H5D.close (dset);
+%!   H5S.close (space);
+%!   H5F.close (fid);
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+%!fail ("H5P.set_fill_value ('H5P_DEFAULT', 'H5T_NATIVE_INT16', [1 2])", "VALUE must be a real numeric scalar")
+*/
+
+// PKG_ADD: autoload ("__H5P_set_fletcher32__", "__H5P__.oct");
+// PKG_DEL: autoload ("__H5P_set_fletcher32__", "__H5P__.oct", "remove");
+DEFUN_DLD(__H5P_set_fletcher32__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {} H5P.set_fletcher32 (@var{plist_id})\n\
+Add the Fletcher32 checksum filter to the filter pipeline of the dataset \
+creation property list @var{plist_id}. Chunks whose checksum does not \
+match are reported as errors when read.\n\
+@seealso{H5P.set_chunk,H5P.get_filter}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  int nargin = args.length ();
+
+  if (nargin != 1)
+    print_usage ("H5P.set_fletcher32");
+
+  // Property list ID
+  hid_t plist_id = get_h5_id (args, 0, "PLIST_ID", "H5P.set_fletcher32");
+
+  if (H5Pset_fletcher32 (plist_id) < 0)
+    error ("H5P.set_fletcher32: unable to set fletcher32 filter");
+
+  return retval;
+}
+
+// PKG_ADD: autoload ("__H5P_set_layout__", "__H5P__.oct");
+// PKG_DEL: autoload ("__H5P_set_layout__", "__H5P__.oct", "remove");
+DEFUN_DLD(__H5P_set_layout__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {} H5P.set_layout (@var{plist_id}, @var{layout})\n\
+Set the storage layout of datasets created with the dataset creation \
+property list @var{plist_id}.\n\
+\n\
+@var{layout} is one of @qcode{'H5D_COMPACT'}, data stored in the object \
+header, for small datasets, @qcode{'H5D_CONTIGUOUS'} (default) or \
+@qcode{'H5D_CHUNKED'}, the chunk dimensions being set with \
+@code{H5P.set_chunk}.\n\
+@seealso{H5P.get_layout,H5P.set_chunk}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  int nargin = args.length ();
+
+  if (nargin != 2)
+    print_usage ("H5P.set_layout");
+
+  // Property list ID
+  hid_t plist_id = get_h5_id (args, 0, "PLIST_ID", "H5P.set_layout");
+
+  // Layout
+  H5D_layout_t layout
+    = static_cast<H5D_layout_t> (get_h5_id (args, 1, "LAYOUT",
+                                            "H5P.set_layout"));
+
+  if (H5Pset_layout (plist_id, layout) < 0)
+    error ("H5P.set_layout: unable to set layout");
+
+  return retval;
+}
+
+// PKG_ADD: autoload ("__H5P_set_nbit__", "__H5P__.oct");
+// PKG_DEL: autoload ("__H5P_set_nbit__", "__H5P__.oct", "remove");
+DEFUN_DLD(__H5P_set_nbit__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {} H5P.set_nbit (@var{plist_id})\n\
+Add the N-Bit filter to the filter pipeline of the dataset creation \
+property list @var{plist_id}. Only the significant bits of the elements, \
+as defined by the precision and offset of the dataset type, are stored.\n\
+@seealso{H5P.set_chunk,H5P.set_scaleoffset}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  int nargin = args.length ();
+
+  if (nargin != 1)
+    print_usage ("H5P.set_nbit");
+
+  // Property list ID
+  hid_t plist_id = get_h5_id (args, 0, "PLIST_ID", "H5P.set_nbit");
+
+  if (H5Pset_nbit (plist_id) < 0)
+    error ("H5P.set_nbit: unable to set nbit filter");
+
+  return retval;
+}
+
+// PKG_ADD: autoload ("__H5P_set_scaleoffset__", "__H5P__.oct");
+// PKG_DEL: autoload ("__H5P_set_scaleoffset__", "__H5P__.oct", "remove");
+DEFUN_DLD(__H5P_set_scaleoffset__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {} H5P.set_scaleoffset (@var{plist_id}, @var{scale_type}, @var{scale_factor})\n\
+Add the scale-offset filter to the filter pipeline of the dataset creation \
+property list @var{plist_id}.\n\
+\n\
+With @var{scale_type} @qcode{'H5Z_SO_INT'}, integer data are stored with \
+@var{scale_factor} bits, or the minimum number of bits when it is \
+@qcode{'H5Z_SO_INT_MINBITS_DEFAULT'}. With \
+@qcode{'H5Z_SO_FLOAT_DSCALE'}, floating point data are stored with \
+@var{scale_factor} decimal digits, which is lossy.\n\
+@seealso{H5P.set_chunk,H5P.set_nbit}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  int nargin = args.length ();
+
+  if (nargin != 3)
+    print_usage ("H5P.set_scaleoffset");
+
+  // Property list ID
+  hid_t plist_id = get_h5_id (args, 0, "PLIST_ID", "H5P.set_scaleoffset");
+
+  // Scale type
+  H5Z_SO_scale_type_t scale_type
+    = static_cast<H5Z_SO_scale_type_t> (get_h5_id (args, 1, "SCALE_TYPE",
+                                                   "H5P.set_scaleoffset"));
+
+  // Scale factor
+  int scale_factor = get_h5_id (args, 2, "SCALE_FACTOR",
+                                "H5P.set_scaleoffset");
+
+  if (H5Pset_scaleoffset (plist_id, scale_type, scale_factor) < 0)
+    error ("H5P.set_scaleoffset: unable to set scaleoffset filter");
+
+  return retval;
+}
+
+// PKG_ADD: autoload ("__H5P_set_shuffle__", "__H5P__.oct");
+// PKG_DEL: autoload ("__H5P_set_shuffle__", "__H5P__.oct", "remove");
+DEFUN_DLD(__H5P_set_shuffle__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {} H5P.set_shuffle (@var{plist_id})\n\
+Add the shuffle filter to the filter pipeline of the dataset creation \
+property list @var{plist_id}. The bytes of the elements of each chunk are \
+regrouped by significance, which helps the compression filters that \
+follow, e.g. @code{H5P.set_deflate}.\n\
+@seealso{H5P.set_chunk,H5P.set_deflate}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  int nargin = args.length ();
+
+  if (nargin != 1)
+    print_usage ("H5P.set_shuffle");
+
+  // Property list ID
+  hid_t plist_id = get_h5_id (args, 0, "PLIST_ID", "H5P.set_shuffle");
+
+  if (H5Pset_shuffle (plist_id) < 0)
+    error ("H5P.set_shuffle: unable to set shuffle filter");
+
+  return retval;
+}
+
+/*
+%!test
+%! fname = tempname ();
+%! unwind_protect
+%!   data = int32 (reshape (1000:1999, 100, 10));
+%!   fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%!   space = H5S.create_simple (2, fliplr (size (data)), []);
+%!   dcpl = H5P.create ('H5P_DATASET_CREATE');
+%!   H5P.set_chunk (dcpl, [5 50]);
+%!   H5P.set_scaleoffset (dcpl, 'H5Z_SO_INT', 'H5Z_SO_INT_MINBITS_DEFAULT');
+%!   dset = H5D.create (fid, 'data', 'H5T_NATIVE_INT32', space, 'H5P_DEFAULT',
+%!                      dcpl, 'H5P_DEFAULT');
+%!   H5D.write (dset, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT',
+%!              data);
+%!   assert (H5D.read (dset), data)
+%!   H5P.close (dcpl);
+%!   H5D.close (dset);
+%!   H5S.close (space);
+%!   H5F.close (fid);
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+*/
@@ -76,19 +76,7 @@ references and should be set to -1 if the reference is an object reference,\n\
       if (H5Rcreate (&ref, loc_id, name.c_str (), ref_type, space_id) < 0)
         error ("H5R.create: unable to create reference");
 
-      int nref = sizeof (haddr_t) + 4;
-
-      int64NDArray out(dim_vector (1,nref));
-
-#if ((H5_VERS_MAJOR * 1000) + H5_VERS_MINOR) <= 1010
-      for (int ii = 0; ii < nref; ii++)
-        out(ii) = ref[ii];
-#else
-      for (int ii = 0; ii < nref; ii++)
-        out(ii) = ref.__data[ii];
-#endif
-
-      retval.append (out);
+      retval.append (region_ref_value (ref));
     }
   else
     error ("H5R.create: unknown REF_TYPE");
@@ -104,6 +92,10 @@ DEFUN_DLD(__H5R_dereference__, args, ,
 Given a reference, @var{ref}, to an object or a region in an object,\n\
 open that object and return an identifier.\n\
 \n\
+With @qcode{'H5R_OBJECT'}, @var{ref} may be an array of references, as \
+returned by @code{H5D.read}: the referenced objects are all opened at once \
+and @var{ref_obj_id} is an array of identifiers of the same size.\n\
+\n\
 The parameter @var{obj_id} must be a valid identifier for the HDF5 file\n\
 containing the referenced object or for any object in that HDF5 file.\n\
 \n\
@@ -146,17 +138,207 @@ function such as @code{H5O.close} or @code{H5D.close} for datasets.\n\
     = static_cast<H5R_type_t> (get_h5_id (args, argnum++,
                                           "REF_TYPE", "H5R.dereference"));
 
+  if (ref_type == H5R_DATASET_REGION)
+    {
+      hdset_reg_ref_t ref;
+      get_region_ref (args(argnum), "H5R.dereference", ref);
+
+      hid_t out_ref = H5Rdereference2 (obj_id, oapl_id, ref_type, &ref);
+
+      if (out_ref < 0)
+        error ("H5R.dereference: unable to dereference region reference");
+
+      return retval.append (octave_int64 (out_ref));
+    }
+
   // Ref
   int64NDArray ref = args(argnum).xint64_array_value ("H5R.dereference: "
                                                       "REF must be a "
                                                       "reference");
 
-  hid_t out_ref = H5Rdereference2 (obj_id, oapl_id,ref_type,
-                                   ref.data ());
+  if (ref.numel () == 1)
+    {
+      hid_t out_ref = H5Rdereference2 (obj_id, oapl_id,ref_type,
+                                       ref.data ());
+
+      return retval.append (octave_int64 (out_ref));
+    }
+
+  // Arrays of object references are dereferenced at once, objects opened
+  // so far being closed if one of them fails
+  int64NDArray out (ref.dims ());
+
+  for (octave_idx_type ii = 0; ii < ref.numel (); ii++)
+    {
+      hobj_ref_t obj_ref = static_cast<hobj_ref_t> (ref(ii).value ());
+
+      hid_t out_ref = H5Rdereference2 (obj_id, oapl_id, H5R_OBJECT, &obj_ref);
+
+      if (out_ref < 0)
+        {
+          for (octave_idx_type jj = 0; jj < ii; jj++)
+            H5Oclose (out(jj).value ());
+
+          error ("H5R.dereference: unable to dereference REF(%ld)",
+                 static_cast<long> (ii+1));
+        }
+
+      out(ii) = out_ref;
+    }
+
+  return retval.append (out);
+}
+
+/*
+%!test
+%! fname = tempname ();
+%! unwind_protect
+%!   file = H5F.create (fname, "H5F_ACC_TRUNC", "H5P_DEFAULT", "H5P_DEFAULT");
+%!   space = H5S.create ("H5S_SCALAR");
+%!   names = {"/a", "/b", "/c"};
+%!   for ii = 1:numel (names)
+%!     dset = H5D.create (file, names{ii}, "H5T_NATIVE_DOUBLE", space,
+%!                        "H5P_DEFAULT");
+%!     H5D.close (dset);
+%!     refs(ii,1) = H5R.create (file, names{ii}, "H5R_OBJECT", -1);
+%!   endfor
+%!   H5S.close (space);
+%!   refs = [refs refs([3 1 2])];
+%!   ids = H5R.dereference (file, "H5R_OBJECT", refs);
+%!   assert (class (ids), "int64")
+%!   assert (size (ids), [3 2])
+%!   expected = [names.' names([3 1 2]).'];
+%!   for ii = 1:numel (ids)
+%!     assert (H5I.get_name (ids(ii)), expected{ii})
+%!     H5O.close (ids(ii));
+%!   endfor
+%!   H5F.close (file);
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+%!error <unable to dereference REF\(2\)>
+%! fname = tempname ();
+%! unwind_protect
+%!   file = H5F.create (fname, "H5F_ACC_TRUNC", "H5P_DEFAULT", "H5P_DEFAULT");
+%!   space = H5S.create ("H5S_SCALAR");
+%!   dset = H5D.create (file, "a", "H5T_NATIVE_DOUBLE", space, "H5P_DEFAULT");
+%!   H5D.close (dset);
+%!   H5S.close (space);
+%!   ref = H5R.create (file, "a", "H5R_OBJECT", -1);
+%!   H5E.set_auto (false);
+%!   H5R.dereference (file, "H5R_OBJECT", [ref; int64(12345678)]);
+%! unwind_protect_cleanup
+%!   H5E.set_auto (true);
+%!   H5F.close (file);
+%!   unlink (fname);
+%! end_unwind_protect
+
+%!error <unable to dereference region reference>
+%! fname = tempname ();
+%! unwind_protect
+%!   file = H5F.create (fname, "H5F_ACC_TRUNC", "H5P_DEFAULT", "H5P_DEFAULT");
+%!   H5E.set_auto (false);
+%!   H5R.dereference (file, "H5R_DATASET_REGION", int64 (255 * ones (1, 12)));
+%! unwind_protect_cleanup
+%!   H5E.set_auto (true);
+%!   H5F.close (file);
+%!   unlink (fname);
+%! end_unwind_protect
+*/
+
+// PKG_ADD: autoload ("__H5R_get_region__", "__H5R__.oct");
+// PKG_DEL: autoload ("__H5R_get_region__", "__H5R__.oct", "remove");
+DEFUN_DLD(__H5R_get_region__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {@var{space_id} = } H5R.get_region (@var{loc_id}, @var{ref_type}, @var{ref})\n\
+Return a copy of the dataspace of the dataset pointed to by the dataset \
+region reference @var{ref}, with the referenced region selected.\n\
+\n\
+@strong{Parameters:}\n\
+ @multitable @columnfractions 0.33 0.02 0.65\n\
+ @item @var{loc_id} @tab @tab Identifier of the file or of any object in \
+the file containing the referenced dataset\n\
+ @item @var{ref_type} @tab @tab Must be @qcode{'H5R_DATASET_REGION'}\n\
+ @item @var{ref} @tab @tab Reference as returned by @code{H5R.create}\n\
+ @end multitable\n\
+\n\
+@strong{Description:}\n\
+\n\
+The referenced data are read by passing @var{space_id} as the file \
+dataspace of @code{H5D.read} on the dataset returned by \
+@code{H5R.dereference}. The dataspace should be released with \
+@code{H5S.close}.\n\
+\n\
+See original function at \
+@url{https://portal.hdfgroup.org/display/HDF5/H5R_GET_REGION}.\n\
+\n\
+@seealso{H5R.create,H5R.dereference,H5S.close}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  int nargin = args.length ();
+
+  if (nargin != 3)
+    print_usage ("H5R.get_region");
 
-  return retval.append (octave_int64 (out_ref));
+  // Location ID
+  hid_t loc_id = get_h5_id (args, 0, "LOC_ID", "H5R.get_region", false);
+
+  // Ref type
+  H5R_type_t ref_type
+    = static_cast<H5R_type_t> (get_h5_id (args, 1,
+                                          "REF_TYPE", "H5R.get_region"));
+
+  if (ref_type != H5R_DATASET_REGION)
+    error ("H5R.get_region: REF_TYPE must be 'H5R_DATASET_REGION'");
+
+  // Ref
+  hdset_reg_ref_t ref;
+  get_region_ref (args(2), "H5R.get_region", ref);
+
+  hid_t space_id = H5Rget_region (loc_id, ref_type, &ref);
+
+  if (space_id < 0)
+    error ("H5R.get_region: unable to retrieve region");
+
+  return retval.append (octave_int64 (space_id));
 }
 
+/*
+%!test
+%! fname = tempname ();
+%! unwind_protect
+%!   file = H5F.create (fname, "H5F_ACC_TRUNC", "H5P_DEFAULT", "H5P_DEFAULT");
+%!   data = reshape (1:20, 4, 5);
+%!   space = H5S.create_simple (2, [5 4], []);
+%!   dset = H5D.create (file, "data", "H5T_NATIVE_DOUBLE", space,
+%!                      "H5P_DEFAULT");
+%!   H5D.write (dset, "H5ML_DEFAULT", "H5S_ALL", "H5S_ALL", "H5P_DEFAULT",
+%!              data);
+%!   H5D.close (dset);
+%!   H5S.select_hyperslab (space, "H5S_SELECT_SET", [1 1], [], [3 2], []);
+%!   ref = H5R.create (file, "data", "H5R_DATASET_REGION", space);
+%!   H5S.close (space);
+%!   assert (size (ref), [1 12])
+%!   dset = H5R.dereference (file, "H5R_DATASET_REGION", ref);
+%!   region = H5R.get_region (file, "H5R_DATASET_REGION", ref);
+%!   assert (H5S.get_select_npoints (region), 6)
+%!   assert (H5D.read (dset, "H5ML_DEFAULT", "H5S_ALL", region,
+%!                     "H5P_DEFAULT"), data(2:3,2:4))
+%!   H5S.close (region);
+%!   H5D.close (dset);
+%!   H5F.close (file);
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+%!fail ("H5R.get_region (1, 'H5R_OBJECT', int64 (1))", "REF_TYPE must be")
+
+%!fail ("H5R.get_region (1, 'H5R_DATASET_REGION', int64 (1))", "dataset region reference")
+*/
+
 // PKG_ADD: autoload ("__H5R_get_obj_type__", "__H5R__.oct");
 // PKG_DEL: autoload ("__H5R_get_obj_type__", "__H5R__.oct", "remove");
 DEFUN_DLD(__H5R_get_obj_type__, args, , 
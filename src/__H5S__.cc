@@ -20,7 +20,56 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include <octave/oct.h>
 #include <hdf5.h>
 
+#include <cmath>
+#include <vector>
+
 #include "./util/h5_oct_util.h"
+
+// Rank of a simple dataspace
+static int
+get_space_rank (hid_t space_id, const std::string& caller)
+{
+  int rank = H5Sget_simple_extent_ndims (space_id);
+
+  if (rank < 0)
+    error ("%s: unable to get space rank", caller.c_str ());
+
+  return rank;
+}
+
+// Convert VAL to a vector of RANK non-negative integers.  If ALLOW_EMPTY
+// is true, an empty VAL gives an empty vector.
+static std::vector<hsize_t>
+get_hsize_vector (const octave_value& val, int rank,
+                  const std::string& argname, const std::string& caller,
+                  bool allow_empty)
+{
+  std::vector<hsize_t> retval;
+
+  if (allow_empty && val.isempty ())
+    return retval;
+
+  NDArray tmp = val.xarray_value ("%s: %s must be a numeric vector",
+                                  caller.c_str (), argname.c_str ());
+
+  if (tmp.numel () != rank)
+    error ("%s: %s must have one element per dimension", caller.c_str (),
+           argname.c_str ());
+
+  retval.resize (rank);
+
+  for (int ii = 0; ii < rank; ii++)
+    {
+      if (tmp(ii) < 0 || tmp(ii) != std::round (tmp(ii)))
+        error ("%s: %s must contain non-negative integers", caller.c_str (),
+               argname.c_str ());
+
+      retval[ii] = static_cast<hsize_t> (tmp(ii));
+    }
+
+  return retval;
+}
+
 // PKG_ADD: autoload ("__H5S_close__", "__H5S__.oct");
 // PKG_DEL: autoload ("__H5S_close__", "__H5S__.oct", "remove");
 DEFUN_DLD(__H5S_close__, args, , 
@@ -45,6 +94,36 @@ DEFUN_DLD(__H5S_close__, args, ,
   return retval;
 }
 
+// PKG_ADD: autoload ("__H5S_copy__", "__H5S__.oct");
+// PKG_DEL: autoload ("__H5S_copy__", "__H5S__.oct", "remove");
+DEFUN_DLD(__H5S_copy__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {@var{output_space_id} =} H5S.copy (@var{space_id})\n\
+\n\
+Create a new dataspace which is an exact copy of the dataspace \
+@var{space_id}, including its selection.\n\
+\n\
+The dataspace identifier returned by this function must be released with \
+@code{H5S.close} or resource leaks will occur.\n\
+@seealso{H5S.close}\n\
+@end deftypefn")
+{
+  int nargin = args.length ();
+
+  if (nargin != 1)
+    print_usage ("H5S.copy");
+
+  // Space ID
+  hid_t space_id = get_h5_id (args, 0, "SPACE_ID", "H5S.copy", false);
+
+  hid_t sid = H5Scopy (space_id);
+
+  if (sid < 0)
+    error ("H5S.copy: unable to copy dataspace");
+
+  return ovl (octave_int64 (sid));
+}
+
 // PKG_ADD: autoload ("__H5S_create__", "__H5S__.oct");
 // PKG_DEL: autoload ("__H5S_create__", "__H5S__.oct", "remove");
 DEFUN_DLD(__H5S_create__, args, , 
@@ -173,6 +252,83 @@ of egual to the elemnts in DIMS");
   return ovl (octave_int64 (sid));
 }
 
+// PKG_ADD: autoload ("__H5S_get_select_bounds__", "__H5S__.oct");
+// PKG_DEL: autoload ("__H5S_get_select_bounds__", "__H5S__.oct", "remove");
+DEFUN_DLD(__H5S_get_select_bounds__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {[@var{start}, @var{finish}] =} H5S.get_select_bounds (@var{space_id})\n\
+\n\
+Return the zero-based coordinates of the opposite corners of the bounding \
+box of the current selection of dataspace @var{space_id}.\n\
+\n\
+The coordinates are given in the same dimension order as for \
+@code{H5S.create_simple} and include the offset set with \
+@code{H5S.offset_simple}.\n\
+@seealso{H5S.get_select_npoints,H5S.select_hyperslab}\n\
+@end deftypefn")
+{
+  octave_value_list retval;
+
+  int nargin = args.length ();
+
+  if (nargin != 1)
+    print_usage ("H5S.get_select_bounds");
+
+  // Space ID
+  hid_t space_id = get_h5_id (args, 0, "SPACE_ID", "H5S.get_select_bounds",
+                              false);
+
+  int rank = get_space_rank (space_id, "H5S.get_select_bounds");
+
+  std::vector<hsize_t> start (rank);
+  std::vector<hsize_t> finish (rank);
+
+  if (H5Sget_select_bounds (space_id, start.data (), finish.data ()) < 0)
+    error ("H5S.get_select_bounds: unable to get selection bounds");
+
+  Matrix ostart (1, rank, 0);
+  Matrix ofinish (1, rank, 0);
+
+  for (int ii = 0; ii < rank; ii++)
+    {
+      ostart(ii) = start[ii];
+      ofinish(ii) = finish[ii];
+    }
+
+  retval.append (ostart);
+  retval.append (ofinish);
+
+  return retval;
+}
+
+// PKG_ADD: autoload ("__H5S_get_select_npoints__", "__H5S__.oct");
+// PKG_DEL: autoload ("__H5S_get_select_npoints__", "__H5S__.oct", "remove");
+DEFUN_DLD(__H5S_get_select_npoints__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {@var{npoints} =} H5S.get_select_npoints (@var{space_id})\n\
+\n\
+Return the number of elements in the current selection of dataspace \
+@var{space_id}.\n\
+@seealso{H5S.get_select_bounds}\n\
+@end deftypefn")
+{
+  int nargin = args.length ();
+
+  if (nargin != 1)
+    print_usage ("H5S.get_select_npoints");
+
+  // Space ID
+  hid_t space_id = get_h5_id (args, 0, "SPACE_ID", "H5S.get_select_npoints",
+                              false);
+
+  hssize_t npoints = H5Sget_select_npoints (space_id);
+
+  if (npoints < 0)
+    error ("H5S.get_select_npoints: unable to get number of selected points");
+
+  return ovl (static_cast<double> (npoints));
+}
+
 // PKG_ADD: autoload ("__H5S_get_simple_extent_dims__", "__H5S__.oct");
 // PKG_DEL: autoload ("__H5S_get_simple_extent_dims__", "__H5S__.oct", "remove");
 DEFUN_DLD(__H5S_get_simple_extent_dims__, args, , 
@@ -254,4 +410,280 @@ Determine the current class @var{space_type} of a dataspace @var{space_id}.\n\
   return retval.append (octave_int64 (space_type));
 }
 
+// PKG_ADD: autoload ("__H5S_offset_simple__", "__H5S__.oct");
+// PKG_DEL: autoload ("__H5S_offset_simple__", "__H5S__.oct", "remove");
+DEFUN_DLD(__H5S_offset_simple__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {} H5S.offset_simple (@var{space_id}, @var{offset})\n\
+\n\
+Set the offset of the selection of the simple dataspace @var{space_id}.\n\
+\n\
+@var{offset} has one, possibly negative, element per dimension of the \
+dataspace and moves the current selection by that many elements, without \
+changing it otherwise. This allows the same selection shape to be moved \
+across a dataspace.\n\
+@seealso{H5S.select_hyperslab}\n\
+@end deftypefn")
+{
+  int nargin = args.length ();
+
+  if (nargin != 2)
+    print_usage ("H5S.offset_simple");
+
+  // Space ID
+  hid_t space_id = get_h5_id (args, 0, "SPACE_ID", "H5S.offset_simple",
+                              false);
+
+  int rank = get_space_rank (space_id, "H5S.offset_simple");
+
+  // Offset
+  NDArray tmp
+    = args(1).xarray_value ("H5S.offset_simple: OFFSET must be a numeric "
+                            "vector");
+
+  if (tmp.numel () != rank)
+    error ("H5S.offset_simple: OFFSET must have one element per dimension");
+
+  std::vector<hssize_t> offset (rank);
+
+  for (int ii = 0; ii < rank; ii++)
+    {
+      if (tmp(ii) != std::round (tmp(ii)))
+        error ("H5S.offset_simple: OFFSET must contain integers");
+
+      offset[ii] = static_cast<hssize_t> (tmp(ii));
+    }
+
+  if (H5Soffset_simple (space_id, offset.data ()) < 0)
+    error ("H5S.offset_simple: unable to set selection offset");
+
+  return octave_value_list ();
+}
+
+// PKG_ADD: autoload ("__H5S_select_all__", "__H5S__.oct");
+// PKG_DEL: autoload ("__H5S_select_all__", "__H5S__.oct", "remove");
+DEFUN_DLD(__H5S_select_all__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {} H5S.select_all (@var{space_id})\n\
+\n\
+Select the entire extent of the dataspace @var{space_id}.\n\
+@seealso{H5S.select_none}\n\
+@end deftypefn")
+{
+  int nargin = args.length ();
+
+  if (nargin != 1)
+    print_usage ("H5S.select_all");
+
+  // Space ID
+  hid_t space_id = get_h5_id (args, 0, "SPACE_ID", "H5S.select_all", false);
+
+  if (H5Sselect_all (space_id) < 0)
+    error ("H5S.select_all: unable to select dataspace");
+
+  return octave_value_list ();
+}
+
+// PKG_ADD: autoload ("__H5S_select_elements__", "__H5S__.oct");
+// PKG_DEL: autoload ("__H5S_select_elements__", "__H5S__.oct", "remove");
+DEFUN_DLD(__H5S_select_elements__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {} H5S.select_elements (@var{space_id}, @var{op}, @var{coord})\n\
+\n\
+Select individual elements of the dataspace @var{space_id}.\n\
+\n\
+@var{coord} is a @var{rank}-by-@var{num_elements} matrix whose columns are \
+the zero-based coordinates of the selected elements, in the same dimension \
+order as for @code{H5S.create_simple}. Elements are read or written in the \
+order of the columns.\n\
+\n\
+@var{op} is one of @qcode{'H5S_SELECT_SET'}, to replace the current \
+selection, @qcode{'H5S_SELECT_APPEND'} or @qcode{'H5S_SELECT_PREPEND'}, to \
+add the elements after or before those of an existing point selection.\n\
+@seealso{H5S.select_hyperslab,H5S.get_select_npoints}\n\
+@end deftypefn")
+{
+  int nargin = args.length ();
+
+  if (nargin != 3)
+    print_usage ("H5S.select_elements");
+
+  // Space ID
+  hid_t space_id = get_h5_id (args, 0, "SPACE_ID", "H5S.select_elements",
+                              false);
+
+  // Selection operator
+  H5S_seloper_t op
+    = static_cast<H5S_seloper_t> (get_h5_id (args, 1, "OP",
+                                             "H5S.select_elements"));
 
+  int rank = get_space_rank (space_id, "H5S.select_elements");
+
+  // Coordinates
+  NDArray tmp
+    = args(2).xarray_value ("H5S.select_elements: COORD must be a numeric "
+                            "matrix");
+
+  octave_idx_type nel = (rank > 0 ? tmp.numel () / rank : 0);
+
+  if (tmp.ndims () > 2 || tmp.rows () != rank)
+    error ("H5S.select_elements: COORD must have one row per dimension");
+
+  std::vector<hsize_t> coord (tmp.numel ());
+
+  for (octave_idx_type ii = 0; ii < tmp.numel (); ii++)
+    {
+      if (tmp(ii) < 0 || tmp(ii) != std::round (tmp(ii)))
+        error ("H5S.select_elements: COORD must contain non-negative "
+               "integers");
+
+      coord[ii] = static_cast<hsize_t> (tmp(ii));
+    }
+
+  if (H5Sselect_elements (space_id, op, nel, coord.data ()) < 0)
+    error ("H5S.select_elements: unable to select elements");
+
+  return octave_value_list ();
+}
+
+// PKG_ADD: autoload ("__H5S_select_hyperslab__", "__H5S__.oct");
+// PKG_DEL: autoload ("__H5S_select_hyperslab__", "__H5S__.oct", "remove");
+DEFUN_DLD(__H5S_select_hyperslab__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {} H5S.select_hyperslab (@var{space_id}, @var{op}, @var{start}, @var{stride}, @var{count}, @var{block})\n\
+\n\
+Select a hyperslab region of the dataspace @var{space_id}.\n\
+\n\
+The hyperslab is made of @var{count} blocks of @var{block} elements in each \
+dimension, the first block starting at the zero-based coordinates \
+@var{start} and consecutive blocks being separated by @var{stride} \
+elements. All arguments have one element per dimension, in the same order \
+as for @code{H5S.create_simple}. An empty @var{stride} or @var{block} \
+stands for ones, i.e. contiguous single element blocks.\n\
+\n\
+@var{op} combines the hyperslab with the current selection: \
+@qcode{'H5S_SELECT_SET'} replaces it, while @qcode{'H5S_SELECT_OR'}, \
+@qcode{'H5S_SELECT_AND'}, @qcode{'H5S_SELECT_XOR'}, \
+@qcode{'H5S_SELECT_NOTB'} and @qcode{'H5S_SELECT_NOTA'} respectively keep \
+the union, the intersection, the symmetric difference, the elements only \
+in the current selection and the elements only in the new hyperslab.\n\
+\n\
+For instance, the elements @code{x(1:10,1:2:end)} of a 100-by-50 \
+array @var{x}, written with the dataspace @var{sid} created by \
+@code{H5S.create_simple (2, [50 100], [])}, are selected with:\n\
+\n\
+@example\n\
+H5S.select_hyperslab (sid, \"H5S_SELECT_SET\", [0 0], [2 1], [25 10], [])\n\
+@end example\n\
+@seealso{H5S.select_elements,H5S.get_select_npoints,H5D.read,H5D.write}\n\
+@end deftypefn")
+{
+  int nargin = args.length ();
+
+  if (nargin != 6)
+    print_usage ("H5S.select_hyperslab");
+
+  // Space ID
+  hid_t space_id = get_h5_id (args, 0, "SPACE_ID", "H5S.select_hyperslab",
+                              false);
+
+  // Selection operator
+  H5S_seloper_t op
+    = static_cast<H5S_seloper_t> (get_h5_id (args, 1, "OP",
+                                             "H5S.select_hyperslab"));
+
+  int rank = get_space_rank (space_id, "H5S.select_hyperslab");
+
+  std::vector<hsize_t> start
+    = get_hsize_vector (args(2), rank, "START", "H5S.select_hyperslab",
+                        false);
+  std::vector<hsize_t> stride
+    = get_hsize_vector (args(3), rank, "STRIDE", "H5S.select_hyperslab",
+                        true);
+  std::vector<hsize_t> count
+    = get_hsize_vector (args(4), rank, "COUNT", "H5S.select_hyperslab",
+                        false);
+  std::vector<hsize_t> block
+    = get_hsize_vector (args(5), rank, "BLOCK", "H5S.select_hyperslab",
+                        true);
+
+  if (H5Sselect_hyperslab (space_id, op, start.data (),
+                           stride.empty () ? nullptr : stride.data (),
+                           count.data (),
+                           block.empty () ? nullptr : block.data ()) < 0)
+    error ("H5S.select_hyperslab: unable to select hyperslab");
+
+  return octave_value_list ();
+}
+
+// PKG_ADD: autoload ("__H5S_select_none__", "__H5S__.oct");
+// PKG_DEL: autoload ("__H5S_select_none__", "__H5S__.oct", "remove");
+DEFUN_DLD(__H5S_select_none__, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {} H5S.select_none (@var{space_id})\n\
+\n\
+Reset the selection of the dataspace @var{space_id} to include no \
+elements.\n\
+@seealso{H5S.select_all}\n\
+@end deftypefn")
+{
+  int nargin = args.length ();
+
+  if (nargin != 1)
+    print_usage ("H5S.select_none");
+
+  // Space ID
+  hid_t space_id = get_h5_id (args, 0, "SPACE_ID", "H5S.select_none", false);
+
+  if (H5Sselect_none (space_id) < 0)
+    error ("H5S.select_none: unable to reset selection");
+
+  return octave_value_list ();
+}
+
+/*
+%!test
+%! space = H5S.create_simple (2, [5 8], []);
+%! H5S.select_hyperslab (space, 'H5S_SELECT_SET', [0 1], [2 3], [3 2], []);
+%! assert (H5S.get_select_npoints (space), 6)
+%! [start, finish] = H5S.get_select_bounds (space);
+%! assert ([start; finish], [0 1; 4 4])
+%! H5S.select_hyperslab (space, 'H5S_SELECT_OR', [1 0], [], [1 8], []);
+%! assert (H5S.get_select_npoints (space), 14)
+%! H5S.select_hyperslab (space, 'H5S_SELECT_NOTB', [1 0], [], [1 8], []);
+%! assert (H5S.get_select_npoints (space), 6)
+%! copy = H5S.copy (space);
+%! H5S.offset_simple (copy, [0 2]);
+%! [start, finish] = H5S.get_select_bounds (copy);
+%! assert ([start; finish], [0 3; 4 6])
+%! H5S.select_none (space);
+%! assert (H5S.get_select_npoints (space), 0)
+%! H5S.select_all (space);
+%! assert (H5S.get_select_npoints (space), 40)
+%! H5S.close (copy);
+%! H5S.close (space);
+
+%!test
+%! fname = tempname ();
+%! fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%! space = H5S.create_simple (2, [4 6], []);
+%! dset = H5D.create (fid, '/a', 'H5T_NATIVE_DOUBLE', space, 'H5P_DEFAULT');
+%! data = reshape (1:24, 6, 4);
+%! H5D.write (dset, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT', data);
+%! ## Write a 2-by-3 tile in place
+%! H5S.select_hyperslab (space, 'H5S_SELECT_SET', [1 2], [], [3 2], []);
+%! H5D.write (dset, 'H5ML_DEFAULT', 'H5S_ALL', space, 'H5P_DEFAULT',
+%!            -ones (2, 3));
+%! data(3:4,2:4) = -1;
+%! assert (H5D.read (dset), data)
+%! ## Read scattered elements in the order of their coordinates
+%! H5S.select_elements (space, 'H5S_SELECT_SET', [3 0 2; 5 0 1]);
+%! pts = H5D.read (dset, 'H5ML_DEFAULT', 'H5S_ALL', space, 'H5P_DEFAULT');
+%! assert (pts(:), [24; 1; 14])
+%! H5D.close (dset);
+%! H5S.close (space);
+%! H5F.close (fid);
+%! delete (fname);
+
+%!fail ("H5S.select_hyperslab (1, 'H5S_SELECT_FOO', 0, [], 1, [])", "unknown OP");
+*/
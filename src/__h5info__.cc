@@ -0,0 +1,531 @@
+/*
+
+Copyright (C) 2025 Pantxo Diribarne
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#include <exception>
+#include <string>
+#include <vector>
+
+#include <octave/oct.h>
+#include <hdf5.h>
+
+#include "./util/H5LT_c.h"
+#include "./util/h5_oct_util.h"
+#include "./util/h5_data_util.h"
+
+// What is queried besides the object headers
+struct info_options
+{
+  // Read attribute values
+  bool read_values = true;
+
+  // Number of group levels below the starting location whose contents are
+  // described
+  double max_depth = octave_Inf;
+
+  // Query dataset creation properties (chunk size)
+  bool read_dcpl = true;
+};
+
+// Description of a group being visited: the child groups and datasets found
+// so far and the addresses of the group and its ancestors, used to detect
+// loops.
+struct group_node
+{
+  const info_options *opts;
+  int depth;
+  std::string name;
+  std::vector<haddr_t> addr;
+  std::vector<octave_scalar_map> groups;
+  std::vector<octave_scalar_map> datasets;
+
+  // Octave errors can't propagate through the HDF5 library and are
+  // rethrown once the iteration has stopped
+  std::exception_ptr err;
+};
+
+// Attributes found so far on an object
+struct attr_list
+{
+  bool read_values;
+  std::vector<octave_scalar_map> attrs;
+  std::exception_ptr err;
+};
+
+static void
+visit_object (hid_t loc_id, const std::string& name, group_node& parent);
+
+// Column struct array out of MAPS, which all have the same fields, or []
+static octave_value
+column_struct (const std::vector<octave_scalar_map>& maps)
+{
+  if (maps.empty ())
+    return octave_value (Matrix ());
+
+  return octave_value (octave_map::cat (0, maps.size (), maps.data ()));
+}
+
+static octave_scalar_map
+type_struct (hid_t type_id)
+{
+  octave_scalar_map s;
+
+  if (! dtype_to_struct (type_id, s))
+    error ("h5info: unable retrieve data type info");
+
+  return s;
+}
+
+// Size of a dataset (IS_DATASET true) or attribute space.  Dataset sizes are
+// reported in Octave's dimension order and scalar datasets have size 1,
+// while attribute sizes are in HDF5 order and scalar attributes have an
+// empty size.
+static octave_scalar_map
+space_struct (hid_t space_id, bool is_dataset)
+{
+  H5S_class_t space_type = H5Sget_simple_extent_type (space_id);
+
+  int ndims = H5Sget_simple_extent_ndims (space_id);
+
+  if (space_type == H5S_NO_CLASS || ndims < 0)
+    error ("h5info: unable to get space size");
+
+  std::vector<hsize_t> dims (ndims);
+  std::vector<hsize_t> maxdims (ndims);
+
+  if (H5Sget_simple_extent_dims (space_id, dims.data (), maxdims.data ()) < 0)
+    error ("h5info: unable to get space size");
+
+  Matrix size (1, ndims, 0.0);
+  Matrix maxsize (1, ndims, 0.0);
+
+  for (int ii = 0; ii < ndims; ii++)
+    {
+      int jj = is_dataset ? ndims - 1 - ii : ii;
+
+      size(jj) = dims[ii];
+
+      if (maxdims[ii] == H5S_UNLIMITED)
+        maxsize(jj) = octave_Inf;
+      else
+        maxsize(jj) = maxdims[ii];
+    }
+
+  std::string type = "simple";
+
+  if (space_type == H5S_NULL)
+    type = "null";
+  else if (space_type == H5S_SCALAR)
+    {
+      type = "scalar";
+
+      if (is_dataset)
+        size = maxsize = Matrix (1, 1, 1.0);
+      else
+        size = maxsize = Matrix ();
+    }
+
+  octave_scalar_map s;
+  s.assign ("Size", size);
+  s.assign ("MaxSize", maxsize);
+  s.assign ("Type", type);
+
+  return s;
+}
+
+static void
+visit_attribute (hid_t loc_id, const std::string& name, attr_list& list)
+{
+  hid_t attr_id = H5Aopen (loc_id, name.c_str (), H5P_DEFAULT);
+
+  if (attr_id < 0)
+    error ("h5info: unable to open attribute '%s'", name.c_str ());
+
+  h5_id_closer attr_closer (attr_id, H5Aclose);
+
+  hid_t type_id = H5Aget_type (attr_id);
+
+  if (type_id < 0)
+    error ("h5info: unable to retrieve data type");
+
+  h5_id_closer type_closer (type_id, H5Tclose);
+
+  hid_t space_id = H5Aget_space (attr_id);
+
+  if (space_id < 0)
+    error ("h5info: unable to retrieve data space");
+
+  h5_id_closer space_closer (space_id, H5Sclose);
+
+  octave_scalar_map s;
+  s.assign ("Name", name);
+  s.assign ("Datatype", type_struct (type_id));
+  s.assign ("Dataspace", space_struct (space_id, false));
+
+  // Unreadable values are reported and left empty, as H5A.read would
+  octave_value value = Matrix ();
+
+  if (list.read_values)
+    {
+      try
+        {
+          dim_vector dv = get_dim_vector (space_id);
+
+          if (dv.ndims () > 0)
+            value = __h5_read__ ("H5A.read", dv, attr_id, type_id);
+        }
+      catch (const octave::execution_exception& ee)
+        {
+#if defined HAVE_EXCEPTION_MSG
+          octave_stdout << ee.message () << "\n";
+#else
+          octave_stdout << ee.info () << "\n";
+#endif
+        }
+    }
+
+  s.assign ("Value", value);
+
+  list.attrs.push_back (s);
+}
+
+static herr_t
+attr_visitor (hid_t loc_id, const char *name, const H5A_info_t * /*info*/,
+              void *op_data)
+{
+  attr_list *list = static_cast<attr_list *> (op_data);
+
+  try
+    {
+      visit_attribute (loc_id, name, *list);
+    }
+  catch (...)
+    {
+      list->err = std::current_exception ();
+      return -1;
+    }
+
+  return 0;
+}
+
+static octave_value
+get_attributes (hid_t obj_id, const info_options& opts)
+{
+  attr_list list;
+  list.read_values = opts.read_values;
+
+  if (H5Aiterate2 (obj_id, H5_INDEX_NAME, H5_ITER_NATIVE, nullptr,
+                   attr_visitor, &list) < 0)
+    {
+      if (list.err)
+        std::rethrow_exception (list.err);
+
+      error ("h5info: unable to iterate over attributes");
+    }
+
+  return column_struct (list.attrs);
+}
+
+static herr_t
+link_visitor (hid_t group_id, const char *name, const H5L_info_t * /*info*/,
+              void *op_data)
+{
+  group_node *node = static_cast<group_node *> (op_data);
+
+  try
+    {
+      visit_object (group_id, name, *node);
+    }
+  catch (...)
+    {
+      node->err = std::current_exception ();
+      return -1;
+    }
+
+  return 0;
+}
+
+static void
+visit_group (hid_t loc_id, const std::string& name, haddr_t addr,
+             group_node& parent)
+{
+  // A group reached again through a hard link to one of its ancestors
+  for (const auto& parent_addr : parent.addr)
+    if (parent_addr == addr)
+      {
+        octave_stdout << std::string (2 * (parent.addr.size () + 1), ' ')
+                      << "  Warning: Loop detected!\n";
+        return;
+      }
+
+  group_node node;
+  node.opts = parent.opts;
+  node.depth = parent.depth + 1;
+
+  if (parent.name == "__g__")
+    node.name = name;
+  else if (parent.name == "/")
+    node.name = "/" + name;
+  else
+    node.name = parent.name + "/" + name;
+
+  node.addr = parent.addr;
+  node.addr.push_back (addr);
+
+  hid_t group_id = H5Gopen (loc_id, name.c_str (), H5P_DEFAULT);
+
+  if (group_id < 0)
+    error ("h5info: unable to open group '%s'", node.name.c_str ());
+
+  h5_id_closer group_closer (group_id, H5Gclose);
+
+  // Links are visited in name order, so that objects reachable through
+  // several paths are described once per path.  Groups below the maximum
+  // depth are listed without their contents.
+  if (node.depth < node.opts->max_depth
+      && H5Literate (group_id, H5_INDEX_NAME, H5_ITER_NATIVE, nullptr,
+                     link_visitor, &node) < 0)
+    {
+      if (node.err)
+        std::rethrow_exception (node.err);
+
+      error ("h5info: unable to iterate over group '%s'", node.name.c_str ());
+    }
+
+  int64NDArray oaddr (dim_vector (1, node.addr.size ()));
+
+  for (size_t ii = 0; ii < node.addr.size (); ii++)
+    oaddr(ii) = octave_int64 (node.addr[ii]);
+
+  octave_scalar_map s;
+  s.assign ("Name", node.name);
+  s.assign ("Groups", column_struct (node.groups));
+  s.assign ("Datasets", column_struct (node.datasets));
+  s.assign ("Datatypes", Matrix ());
+  s.assign ("Links", Matrix ());
+  s.assign ("Attributes", get_attributes (group_id, *node.opts));
+  s.assign ("addr", oaddr);
+
+  parent.groups.push_back (s);
+}
+
+static void
+visit_dataset (hid_t loc_id, const std::string& name, group_node& parent)
+{
+  hid_t dataset_id = H5Dopen (loc_id, name.c_str (), H5P_DEFAULT);
+
+  if (dataset_id < 0)
+    error ("h5info: unable to open dataset '%s'", name.c_str ());
+
+  h5_id_closer dataset_closer (dataset_id, H5Dclose);
+
+  hid_t type_id = H5Dget_type (dataset_id);
+
+  if (type_id < 0)
+    error ("h5info: unable to retrieve data type");
+
+  h5_id_closer type_closer (type_id, H5Tclose);
+
+  hid_t space_id = H5Dget_space (dataset_id);
+
+  if (space_id < 0)
+    error ("h5info: unable to retrieve data space");
+
+  h5_id_closer space_closer (space_id, H5Sclose);
+
+  // Chunk size, in HDF5 dimension order
+  Matrix chunk_size;
+
+  hid_t dcpl_id = H5P_DEFAULT;
+
+  if (parent.opts->read_dcpl)
+    {
+      dcpl_id = H5Dget_create_plist (dataset_id);
+
+      if (dcpl_id < 0)
+        error ("h5info: unable to retrieve dataset creation property list");
+    }
+
+  h5_id_closer dcpl_closer (dcpl_id, H5Pclose);
+
+  if (parent.opts->read_dcpl && H5Pget_layout (dcpl_id) == H5D_CHUNKED)
+    {
+      int rank = H5Pget_chunk (dcpl_id, 0, nullptr);
+
+      if (rank < 0)
+        error ("h5info: unable to get chunk dims");
+
+      std::vector<hsize_t> dims (rank);
+
+      H5Pget_chunk (dcpl_id, rank, dims.data ());
+
+      chunk_size = Matrix (1, rank, 0.0);
+
+      for (int ii = 0; ii < rank; ii++)
+        chunk_size(ii) = dims[ii];
+    }
+
+  octave_scalar_map s;
+  s.assign ("Name", name);
+  s.assign ("Datatype", type_struct (type_id));
+  s.assign ("Dataspace", space_struct (space_id, true));
+  s.assign ("ChunkSize", chunk_size);
+  // FIXME: user defined fill values and filters are not reported
+  s.assign ("FillValue", 0.0);
+  s.assign ("Filters", Matrix ());
+  s.assign ("Attributes", get_attributes (dataset_id, *parent.opts));
+
+  parent.datasets.push_back (s);
+}
+
+static void
+visit_object (hid_t loc_id, const std::string& name, group_node& parent)
+{
+#if ((H5_VERS_MAJOR * 1000) + H5_VERS_MINOR) <= 1010
+  H5O_info_t oinfo;
+  if (H5Oget_info_by_name1 (loc_id, name.c_str (), &oinfo, H5P_DEFAULT) < 0)
+#else
+  H5O_info1_t oinfo;
+  if (H5Oget_info_by_name2 (loc_id, name.c_str (), &oinfo, H5O_INFO_BASIC,
+                            H5P_DEFAULT) < 0)
+#endif
+    error ("h5info: unable to get info for object '%s' (%s)", name.c_str (),
+           get_h5_error_desc ().c_str ());
+
+  switch (oinfo.type)
+    {
+    case H5O_TYPE_GROUP:
+      visit_group (loc_id, name, oinfo.addr, parent);
+      break;
+
+    case H5O_TYPE_DATASET:
+      visit_dataset (loc_id, name, parent);
+      break;
+
+    default:
+      // Named datatypes are not described
+      break;
+    }
+}
+
+// PKG_ADD: autoload ("__h5info__", "__h5info__.oct");
+// PKG_DEL: autoload ("__h5info__", "__h5info__.oct", "remove");
+DEFUN_DLD(__h5info__, args, ,
+"-*- texinfo -*-\n\
+@deftypefn {} {@var{s} =} __h5info__ (@var{fname}, @var{loc})\n\
+@deftypefnx {} {@var{s} =} __h5info__ (@var{fname}, @var{loc}, @var{read_values}, @var{max_depth}, @var{read_dcpl})\n\
+Undocumented internal function.\n\
+@seealso{h5info}\n\
+@end deftypefn")
+{
+  int nargin = args.length ();
+
+  if (nargin != 2 && nargin != 5)
+    print_usage ();
+
+  std::string filename
+    = args(0).xstring_value ("h5info: FNAME must be a string");
+
+  std::string loc = args(1).xstring_value ("h5info: LOC must be a string");
+
+  info_options opts;
+
+  if (nargin == 5)
+    {
+      opts.read_values
+        = args(2).xbool_value ("h5info: READ_VALUES must be a logical value");
+
+      opts.max_depth
+        = args(3).xdouble_value ("h5info: MAX_DEPTH must be a scalar");
+
+      if (! (opts.max_depth >= 0))
+        error ("h5info: MAX_DEPTH must be a non-negative scalar");
+
+      opts.read_dcpl
+        = args(4).xbool_value ("h5info: READ_DCPL must be a logical value");
+    }
+
+  // Errors are reported with the HDF5 error description instead
+  h5_error_silencer silencer;
+
+  hid_t file_id = H5Fopen (filename.c_str (), H5F_ACC_RDONLY, H5P_DEFAULT);
+
+  if (file_id < 0)
+    error ("h5info: unable to open file '%s' (%s)", filename.c_str (),
+           get_h5_error_desc ().c_str ());
+
+  h5_id_closer file_closer (file_id, H5Fclose);
+
+  // Fake container group, removed from the output
+  group_node root;
+  root.opts = &opts;
+  root.depth = -1;
+  root.name = "__g__";
+
+  visit_object (file_id, loc, root);
+
+  if (! root.groups.empty ())
+    return ovl (column_struct (root.groups));
+  else
+    return ovl (column_struct (root.datasets));
+}
+
+/*
+%!test
+%! fname = tempname ();
+%! fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%! gid = H5G.create (fid, '/g1', 'H5P_DEFAULT', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%! H5G.close (gid);
+%! space = H5S.create_simple (2, [4 6], []);
+%! dset = H5D.create (fid, '/g1/a', 'H5T_NATIVE_DOUBLE', space, 'H5P_DEFAULT');
+%! H5S.close (space);
+%! space = H5S.create ('H5S_SCALAR');
+%! attr = H5A.create (dset, 'att', 'H5T_NATIVE_INT', space, 'H5P_DEFAULT');
+%! H5A.write (attr, 'H5ML_DEFAULT', int32 (3));
+%! H5A.close (attr);
+%! H5S.close (space);
+%! H5D.close (dset);
+%! H5F.close (fid);
+%! s = __h5info__ (fname, '/');
+%! ds = __h5info__ (fname, '/g1/a');
+%! shallow = __h5info__ (fname, '/', true, 1, true);
+%! bare = __h5info__ (fname, '/g1', false, Inf, false);
+%! delete (fname);
+%! assert (fieldnames (s), {'Name'; 'Groups'; 'Datasets'; 'Datatypes'; ...
+%!                          'Links'; 'Attributes'; 'addr'})
+%! assert (s.Name, '/')
+%! assert (s.Groups.Name, '/g1')
+%! assert (size (s.Groups.addr), [1 2])
+%! assert (s.Groups.Groups, [])
+%! assert (s.Groups.Datasets.Name, 'a')
+%! assert (s.Groups.Datasets.Dataspace.Size, [6 4])
+%! assert (s.Groups.Datasets.Attributes.Name, 'att')
+%! assert (s.Groups.Datasets.Attributes.Dataspace.Type, 'scalar')
+%! assert (s.Groups.Datasets.Attributes.Value, int32 (3))
+%! assert (ds.Name, '/g1/a')
+%! assert (shallow.Groups.Name, '/g1')
+%! assert (shallow.Groups.Datasets, [])
+%! assert (bare.Datasets.Attributes.Value, [])
+%! assert (bare.Datasets.Dataspace.Size, [6 4])
+
+%!fail ("__h5info__ ('f', '/', true, -1, true)", "MAX_DEPTH must be a non-negative scalar")
+
+%!fail ("__h5info__ ()", "Invalid call")
+
+%!fail ("__h5info__ (tempname (), '/')", "unable to open file")
+*/
@@ -0,0 +1,1988 @@
+/*
+
+Copyright (C) 2025 Pantxo Diribarne
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <octave/oct.h>
+#include <octave/parse.h>
+#include <hdf5.h>
+
+#include "./util/h5_chunk_util.h"
+#include "./util/h5_oct_util.h"
+#include "./util/h5_data_util.h"
+
+// MAT v7.3 files are HDF5 files where each variable is a dataset or a group
+// at the root of the file, tagged with a "MATLAB_class" attribute.  Cell
+// arrays and struct arrays are stored as arrays of object references to
+// datasets in the "#refs#" group.
+
+static octave_value get_object_data (hid_t obj_id);
+
+static bool
+has_attribute (hid_t obj_id, const char *name)
+{
+  return H5Aexists (obj_id, name) > 0;
+}
+
+static octave_value
+read_attribute (hid_t obj_id, const char *name)
+{
+  hid_t attr_id = H5Aopen (obj_id, name, H5P_DEFAULT);
+
+  if (attr_id < 0)
+    error ("read_mat73: unable to open attribute '%s'", name);
+
+  h5_id_closer attr_closer (attr_id, H5Aclose);
+
+  hid_t type_id = H5Aget_type (attr_id);
+
+  if (type_id < 0)
+    error ("read_mat73: unable to retrieve data type");
+
+  h5_id_closer type_closer (type_id, H5Tclose);
+
+  hid_t space_id = H5Aget_space (attr_id);
+
+  if (space_id < 0)
+    error ("read_mat73: unable to retrieve data space");
+
+  h5_id_closer space_closer (space_id, H5Sclose);
+
+  return __h5_read__ ("H5A.read", get_dim_vector (space_id), attr_id,
+                      type_id);
+}
+
+// Value of the "MATLAB_class" attribute or an empty string
+static std::string
+var_class (hid_t obj_id)
+{
+  if (! has_attribute (obj_id, "MATLAB_class"))
+    return std::string ();
+
+  return read_attribute (obj_id, "MATLAB_class").string_value ();
+}
+
+// Field names stored in the "MATLAB_fields" attribute of structs, as
+// variable length sequences of characters without null terminator
+static std::vector<std::string>
+read_field_names (hid_t obj_id)
+{
+  hid_t attr_id = H5Aopen (obj_id, "MATLAB_fields", H5P_DEFAULT);
+
+  if (attr_id < 0)
+    error ("read_mat73: unable to open attribute 'MATLAB_fields'");
+
+  h5_id_closer attr_closer (attr_id, H5Aclose);
+
+  hid_t type_id = H5Aget_type (attr_id);
+
+  if (type_id < 0 || H5Tget_class (type_id) != H5T_VLEN)
+    error ("read_mat73: unexpected type for attribute 'MATLAB_fields'");
+
+  h5_id_closer type_closer (type_id, H5Tclose);
+
+  hid_t mem_type_id = H5Tget_native_type (type_id, H5T_DIR_DEFAULT);
+
+  h5_id_closer mem_type_closer (mem_type_id, H5Tclose);
+
+  hid_t space_id = H5Aget_space (attr_id);
+
+  h5_id_closer space_closer (space_id, H5Sclose);
+
+  hssize_t nfields = H5Sget_simple_extent_npoints (space_id);
+
+  if (mem_type_id < 0 || nfields < 0)
+    error ("read_mat73: unable to read attribute 'MATLAB_fields'");
+
+  std::vector<hvl_t> rdata (nfields);
+
+  if (nfields > 0 && H5Aread (attr_id, mem_type_id, rdata.data ()) < 0)
+    error ("read_mat73: unable to read attribute 'MATLAB_fields'");
+
+  std::vector<std::string> fields (nfields);
+
+  for (hssize_t ii = 0; ii < nfields; ii++)
+    {
+      fields[ii].assign (static_cast<const char *> (rdata[ii].p),
+                         rdata[ii].len);
+
+      // Drop the terminator of null terminated fields
+      size_t nchar = fields[ii].find ('\0');
+      if (nchar != std::string::npos)
+        fields[ii].resize (nchar);
+    }
+
+  if (nfields > 0)
+    H5Dvlen_reclaim (mem_type_id, space_id, H5P_DEFAULT, rdata.data ());
+
+  return fields;
+}
+
+// Empty arrays are stored as the vector of their dimensions
+static dim_vector
+get_empty_dims (const octave_value& val)
+{
+  NDArray dims = val.array_value ();
+
+  octave_idx_type n = dims.numel ();
+
+  if (n == 1)
+    return dim_vector (dims(0), dims(0));
+
+  dim_vector dv;
+  dv.resize (std::max (n, static_cast<octave_idx_type> (2)));
+
+  for (octave_idx_type ii = 0; ii < dv.ndims (); ii++)
+    dv(ii) = (ii < n ? dims(ii) : 1);
+
+  return dv;
+}
+
+static octave_value
+empty_value (const std::string& cls, const dim_vector& dv)
+{
+  if (cls == "double")
+    return octave_value (NDArray (dv));
+  else if (cls == "single")
+    return octave_value (FloatNDArray (dv));
+  else if (cls == "int8")
+    return octave_value (int8NDArray (dv));
+  else if (cls == "int16")
+    return octave_value (int16NDArray (dv));
+  else if (cls == "int32")
+    return octave_value (int32NDArray (dv));
+  else if (cls == "int64")
+    return octave_value (int64NDArray (dv));
+  else if (cls == "uint8")
+    return octave_value (uint8NDArray (dv));
+  else if (cls == "uint16")
+    return octave_value (uint16NDArray (dv));
+  else if (cls == "uint32")
+    return octave_value (uint32NDArray (dv));
+  else if (cls == "uint64")
+    return octave_value (uint64NDArray (dv));
+  else if (cls == "logical")
+    return octave_value (boolNDArray (dv));
+  else if (cls == "cell")
+    return octave_value (Cell (dv));
+  else
+    return octave_value (NDArray (dv));
+}
+
+// Read a whole dataset, replacing object references with the data of the
+// referenced objects
+static octave_value
+read_dataset (hid_t dataset_id)
+{
+  hid_t type_id = H5Dget_type (dataset_id);
+
+  if (type_id < 0)
+    error ("read_mat73: unable to retrieve data type");
+
+  h5_id_closer type_closer (type_id, H5Tclose);
+
+  hid_t space_id = H5Dget_space (dataset_id);
+
+  if (space_id < 0)
+    error ("read_mat73: unable to retrieve data space");
+
+  h5_id_closer space_closer (space_id, H5Sclose);
+
+  octave_value val = __h5_read__ ("read_mat73", get_dim_vector (space_id),
+                                  dataset_id, type_id);
+
+  if (H5Tget_class (type_id) != H5T_REFERENCE)
+    return val;
+
+  int64NDArray refs = val.int64_array_value ();
+
+  Cell cell (refs.dims ());
+
+  for (octave_idx_type ii = 0; ii < refs.numel (); ii++)
+    {
+      hobj_ref_t ref = refs(ii).value ();
+
+      hid_t obj_id = H5Rdereference2 (dataset_id, H5P_DEFAULT, H5R_OBJECT,
+                                      &ref);
+
+      if (obj_id < 0)
+        error ("read_mat73: unable to dereference object");
+
+      h5_id_closer obj_closer (obj_id, H5Oclose);
+
+      cell(ii) = get_object_data (obj_id);
+    }
+
+  return octave_value (cell);
+}
+
+static hid_t
+open_object (hid_t loc_id, const std::string& name)
+{
+  hid_t obj_id = H5Oopen (loc_id, name.c_str (), H5P_DEFAULT);
+
+  if (obj_id < 0)
+    error ("read_mat73: unable to open object '%s'", name.c_str ());
+
+  return obj_id;
+}
+
+static octave_value
+read_child_dataset (hid_t loc_id, const std::string& name)
+{
+  hid_t obj_id = open_object (loc_id, name);
+
+  h5_id_closer obj_closer (obj_id, H5Oclose);
+
+  return read_dataset (obj_id);
+}
+
+// Complex data are stored as compounds with "real" and "imag" members,
+// read as a struct with the corresponding fields
+static octave_value
+maybe_complex (const octave_value& val)
+{
+  if (! val.isstruct ())
+    return val;
+
+  octave_scalar_map m = val.scalar_map_value ();
+
+  if (! m.isfield ("real") || ! m.isfield ("imag"))
+    return val;
+
+  octave_value re = m.getfield ("real");
+  octave_value im = m.getfield ("imag");
+
+  if (re.is_single_type ())
+    {
+      FloatNDArray fre = re.float_array_value ();
+      FloatNDArray fim = im.float_array_value ();
+      FloatComplexNDArray out (fre.dims ());
+
+      for (octave_idx_type ii = 0; ii < out.numel (); ii++)
+        out(ii) = FloatComplex (fre(ii), fim(ii));
+
+      return octave_value (out);
+    }
+  else
+    {
+      NDArray dre = re.array_value ();
+      NDArray dim = im.array_value ();
+      ComplexNDArray out (dre.dims ());
+
+      for (octave_idx_type ii = 0; ii < out.numel (); ii++)
+        out(ii) = Complex (dre(ii), dim(ii));
+
+      return octave_value (out);
+    }
+}
+
+static bool
+is_complex_dataset (hid_t loc_id, const std::string& name)
+{
+  if (H5Lexists (loc_id, name.c_str (), H5P_DEFAULT) <= 0)
+    return false;
+
+  hid_t dataset_id = H5Dopen (loc_id, name.c_str (), H5P_DEFAULT);
+
+  if (dataset_id < 0)
+    return false;
+
+  h5_id_closer dataset_closer (dataset_id, H5Dclose);
+
+  hid_t type_id = H5Dget_type (dataset_id);
+
+  h5_id_closer type_closer (type_id, H5Tclose);
+
+  return H5Tget_class (type_id) == H5T_COMPOUND;
+}
+
+// Sparse matrices are stored in a group in compressed sparse column format:
+// "jc" holds the column pointers, "ir" the zero-based row indices and
+// "data" the non-zero values.  The last two are missing when there is no
+// non-zero element.
+
+// Number of elements of the dataset NAME of a sparse group, zero if missing
+static octave_idx_type
+sparse_component_size (hid_t obj_id, const char *name)
+{
+  if (H5Lexists (obj_id, name, H5P_DEFAULT) <= 0)
+    return 0;
+
+  hid_t dataset_id = H5Dopen (obj_id, name, H5P_DEFAULT);
+
+  if (dataset_id < 0)
+    error ("read_mat73: unable to open dataset '%s'", name);
+
+  h5_id_closer dataset_closer (dataset_id, H5Dclose);
+
+  hid_t space_id = H5Dget_space (dataset_id);
+
+  if (space_id < 0)
+    error ("read_mat73: unable to retrieve data space");
+
+  h5_id_closer space_closer (space_id, H5Sclose);
+
+  return H5Sget_simple_extent_npoints (space_id);
+}
+
+// Read the N elements of the dataset NAME of a sparse group directly into
+// BUF, converted to MEM_TYPE_ID
+static void
+read_sparse_component (hid_t obj_id, const char *name, hid_t mem_type_id,
+                       octave_idx_type n, void *buf)
+{
+  if (n == 0)
+    return;
+
+  if (sparse_component_size (obj_id, name) != n)
+    error ("read_mat73: inconsistent sparse data");
+
+  hid_t dataset_id = H5Dopen (obj_id, name, H5P_DEFAULT);
+
+  h5_id_closer dataset_closer (dataset_id, H5Dclose);
+
+  if (H5Dread (dataset_id, mem_type_id, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+               buf) < 0)
+    error ("read_mat73: unable to read sparse data '%s'", name);
+}
+
+// Read the column pointers and row indices of a NR x NC sparse matrix with
+// NZ non-zero elements into CIDX and RIDX, and check that they are valid:
+// Octave relies on them being sorted and in range.
+static void
+read_sparse_indices (hid_t obj_id, octave_idx_type nr, octave_idx_type nc,
+                     octave_idx_type nz, octave_idx_type *cidx,
+                     octave_idx_type *ridx)
+{
+  hid_t idx_type_id = (sizeof (octave_idx_type) == 8
+                       ? H5T_NATIVE_INT64 : H5T_NATIVE_INT32);
+
+  read_sparse_component (obj_id, "jc", idx_type_id, nc + 1, cidx);
+  read_sparse_component (obj_id, "ir", idx_type_id, nz, ridx);
+
+  bool valid = (cidx[0] == 0 && cidx[nc] == nz);
+
+  for (octave_idx_type jj = 0; valid && jj < nc; jj++)
+    {
+      if (cidx[jj+1] < cidx[jj] || cidx[jj+1] > nz)
+        valid = false;
+
+      for (octave_idx_type ii = cidx[jj]; valid && ii < cidx[jj+1]; ii++)
+        valid = (ridx[ii] >= 0 && ridx[ii] < nr
+                 && (ii == cidx[jj] || ridx[ii] > ridx[ii-1]));
+    }
+
+  if (! valid)
+    error ("read_mat73: inconsistent sparse data");
+}
+
+// The sparse matrix is allocated with its final number of non-zero elements
+// and the three datasets are read in place, which avoids going through
+// triplets that would have to be sorted again.
+static octave_value
+read_sparse (hid_t obj_id, const std::string& cls)
+{
+  octave_idx_type nr
+    = read_attribute (obj_id, "MATLAB_sparse").idx_type_value ();
+  octave_idx_type nc = sparse_component_size (obj_id, "jc") - 1;
+  octave_idx_type nz = sparse_component_size (obj_id, "data");
+
+  if (nr < 0 || nc < 0)
+    error ("read_mat73: inconsistent sparse data");
+
+  if (cls == "logical")
+    {
+      SparseBoolMatrix sm (nr, nc, nz);
+
+      read_sparse_indices (obj_id, nr, nc, nz, sm.xcidx (), sm.xridx ());
+
+      std::vector<unsigned char> buf (nz);
+      read_sparse_component (obj_id, "data", H5T_NATIVE_UCHAR, nz,
+                             buf.data ());
+
+      for (octave_idx_type ii = 0; ii < nz; ii++)
+        sm.xdata (ii) = (buf[ii] != 0);
+
+      return octave_value (sm);
+    }
+  else if (is_complex_dataset (obj_id, "data"))
+    {
+      SparseComplexMatrix sm (nr, nc, nz);
+
+      read_sparse_indices (obj_id, nr, nc, nz, sm.xcidx (), sm.xridx ());
+
+      // Complex is laid out as two doubles, read the compound in place
+      hid_t type_id = H5Tcreate (H5T_COMPOUND, sizeof (Complex));
+
+      h5_id_closer type_closer (type_id, H5Tclose);
+
+      H5Tinsert (type_id, "real", 0, H5T_NATIVE_DOUBLE);
+      H5Tinsert (type_id, "imag", sizeof (double), H5T_NATIVE_DOUBLE);
+
+      read_sparse_component (obj_id, "data", type_id, nz, sm.xdata ());
+
+      return octave_value (sm);
+    }
+  else
+    {
+      SparseMatrix sm (nr, nc, nz);
+
+      read_sparse_indices (obj_id, nr, nc, nz, sm.xcidx (), sm.xridx ());
+
+      read_sparse_component (obj_id, "data", H5T_NATIVE_DOUBLE, nz,
+                             sm.xdata ());
+
+      return octave_value (sm);
+    }
+}
+
+// Char arrays are stored as UTF-16 code units, while Octave strings hold
+// UTF-8 bytes.  The code units are read and written in native byte order,
+// HDF5 converting them from or to the byte order of the file.
+
+static const uint32_t replacement_char = 0xFFFD;
+
+static void
+append_utf8 (std::string& out, uint32_t cp)
+{
+  if (cp < 0x80)
+    out += static_cast<char> (cp);
+  else if (cp < 0x800)
+    {
+      out += static_cast<char> (0xC0 | (cp >> 6));
+      out += static_cast<char> (0x80 | (cp & 0x3F));
+    }
+  else if (cp < 0x10000)
+    {
+      out += static_cast<char> (0xE0 | (cp >> 12));
+      out += static_cast<char> (0x80 | ((cp >> 6) & 0x3F));
+      out += static_cast<char> (0x80 | (cp & 0x3F));
+    }
+  else
+    {
+      out += static_cast<char> (0xF0 | (cp >> 18));
+      out += static_cast<char> (0x80 | ((cp >> 12) & 0x3F));
+      out += static_cast<char> (0x80 | ((cp >> 6) & 0x3F));
+      out += static_cast<char> (0x80 | (cp & 0x3F));
+    }
+}
+
+static void
+append_utf16 (std::vector<uint16_t>& out, uint32_t cp)
+{
+  if (cp < 0x10000)
+    out.push_back (static_cast<uint16_t> (cp));
+  else
+    {
+      cp -= 0x10000;
+      out.push_back (static_cast<uint16_t> (0xD800 | (cp >> 10)));
+      out.push_back (static_cast<uint16_t> (0xDC00 | (cp & 0x3FF)));
+    }
+}
+
+// UTF-16 code units, one string per row, to a UTF-8 char matrix.  Rows
+// whose UTF-8 encoding is shorter than the longest one are padded with
+// blanks.
+static octave_value
+decode_utf16 (const octave_value& val)
+{
+  uint16NDArray units = val.uint16_array_value ();
+
+  const octave_uint16 *pu = units.data ();
+  octave_idx_type n = units.numel ();
+
+  // ASCII text maps one to one and keeps the dimensions of the array
+  bool ascii = true;
+
+  for (octave_idx_type ii = 0; ascii && ii < n; ii++)
+    ascii = (pu[ii].value () < 0x80);
+
+  if (ascii)
+    {
+      charNDArray out (units.dims ());
+
+      for (octave_idx_type ii = 0; ii < n; ii++)
+        out.xelem (ii) = static_cast<char> (pu[ii].value ());
+
+      return octave_value (out, '\'');
+    }
+
+  octave_idx_type nr = units.rows ();
+  octave_idx_type nc = n / nr;
+
+  // Transcode all rows in a single buffer before filling the char matrix
+  std::string buf;
+  buf.reserve (3 * n);
+
+  std::vector<std::size_t> offset (nr + 1, 0);
+  std::size_t len = 0;
+
+  for (octave_idx_type ii = 0; ii < nr; ii++)
+    {
+      for (octave_idx_type jj = 0; jj < nc; jj++)
+        {
+          uint32_t cp = pu[ii + jj * nr].value ();
+
+          if (cp >= 0xD800 && cp < 0xDC00 && jj + 1 < nc
+              && pu[ii + (jj+1) * nr].value () >= 0xDC00
+              && pu[ii + (jj+1) * nr].value () < 0xE000)
+            {
+              uint32_t lo = pu[ii + (++jj) * nr].value ();
+              cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+            }
+          else if (cp >= 0xD800 && cp < 0xE000)
+            cp = replacement_char;   // Unpaired surrogate
+
+          append_utf8 (buf, cp);
+        }
+
+      offset[ii+1] = buf.size ();
+      len = std::max (len, offset[ii+1] - offset[ii]);
+    }
+
+  charNDArray out (dim_vector (nr, len), ' ');
+
+  for (octave_idx_type ii = 0; ii < nr; ii++)
+    for (std::size_t kk = offset[ii]; kk < offset[ii+1]; kk++)
+      out.xelem (ii + (kk - offset[ii]) * nr) = buf[kk];
+
+  return octave_value (out, '\'');
+}
+
+// UTF-8 char matrix, one string per row, to UTF-16 code units.  Invalid
+// UTF-8 sequences are replaced by U+FFFD and rows whose encoding is shorter
+// than the longest one are padded with blanks.
+static uint16NDArray
+encode_utf16 (const charNDArray& str)
+{
+  const char *ps = str.data ();
+  octave_idx_type n = str.numel ();
+
+  bool ascii = true;
+
+  for (octave_idx_type ii = 0; ascii && ii < n; ii++)
+    ascii = (static_cast<unsigned char> (ps[ii]) < 0x80);
+
+  if (ascii)
+    {
+      uint16NDArray out (str.dims ());
+
+      for (octave_idx_type ii = 0; ii < n; ii++)
+        out.xelem (ii) = static_cast<uint16_t> (ps[ii]);
+
+      return out;
+    }
+
+  octave_idx_type nr = str.rows ();
+  octave_idx_type nc = n / nr;
+
+  std::vector<uint16_t> buf;
+  buf.reserve (n);
+
+  std::vector<std::size_t> offset (nr + 1, 0);
+  std::size_t len = 0;
+
+  for (octave_idx_type ii = 0; ii < nr; ii++)
+    {
+      octave_idx_type jj = 0;
+
+      while (jj < nc)
+        {
+          unsigned char c = ps[ii + jj * nr];
+
+          uint32_t cp = c;
+          int nbytes = 1;
+
+          if ((c & 0xE0) == 0xC0)
+            {
+              cp = c & 0x1F;
+              nbytes = 2;
+            }
+          else if ((c & 0xF0) == 0xE0)
+            {
+              cp = c & 0x0F;
+              nbytes = 3;
+            }
+          else if ((c & 0xF8) == 0xF0)
+            {
+              cp = c & 0x07;
+              nbytes = 4;
+            }
+
+          bool valid = (c < 0x80 || nbytes > 1);
+
+          for (int kk = 1; valid && kk < nbytes; kk++)
+            {
+              unsigned char cc = (jj + kk < nc ? ps[ii + (jj + kk) * nr] : 0);
+
+              valid = ((cc & 0xC0) == 0x80);
+              cp = (cp << 6) | (cc & 0x3F);
+            }
+
+          // Overlong encodings, surrogates and out of range code points
+          static const uint32_t min_cp[] = {0, 0, 0x80, 0x800, 0x10000};
+
+          if (! valid || cp < min_cp[nbytes] || cp > 0x10FFFF
+              || (cp >= 0xD800 && cp < 0xE000))
+            {
+              cp = replacement_char;
+              nbytes = 1;
+            }
+
+          append_utf16 (buf, cp);
+          jj += nbytes;
+        }
+
+      offset[ii+1] = buf.size ();
+      len = std::max (len, offset[ii+1] - offset[ii]);
+    }
+
+  uint16NDArray out (dim_vector (nr, len), octave_uint16 (' '));
+
+  for (octave_idx_type ii = 0; ii < nr; ii++)
+    for (std::size_t kk = offset[ii]; kk < offset[ii+1]; kk++)
+      out.xelem (ii + (kk - offset[ii]) * nr) = buf[kk];
+
+  return out;
+}
+
+// Classes stored as a plain dataset, unless empty or sparse
+static bool
+is_array_class (const std::string& cls)
+{
+  return (cls == "double" || cls == "single" || cls == "char"
+          || cls == "logical" || cls == "int8" || cls == "int16"
+          || cls == "int32" || cls == "int64" || cls == "uint8"
+          || cls == "uint16" || cls == "uint32" || cls == "uint64");
+}
+
+// Octave value of class CLS out of the raw dataset data VAL
+static octave_value
+decode_array (const std::string& cls, const octave_value& val)
+{
+  if (cls == "double" || cls == "single")
+    return maybe_complex (val);
+  else if (cls == "char")
+    {
+      if (val.is_uint8_type ())
+        return val.convert_to_str (false, true, '\'');   // ASCII
+      else
+        return decode_utf16 (val);
+    }
+  else if (cls == "logical")
+    return octave_value (val.bool_array_value ());
+  else
+    return val;
+}
+
+static octave_value
+read_struct (hid_t obj_id)
+{
+  std::vector<std::string> fields = read_field_names (obj_id);
+
+  octave_scalar_map tmp;
+
+  if (fields.empty ())
+    return octave_value (tmp);
+
+  // Struct arrays store each field in a dataset of references, with no
+  // named class
+  std::string cls = "struct";
+
+  if (H5Lexists (obj_id, fields[0].c_str (), H5P_DEFAULT) > 0)
+    {
+      hid_t field_id = open_object (obj_id, fields[0]);
+      h5_id_closer field_closer (field_id, H5Oclose);
+
+      cls = var_class (field_id);
+    }
+
+  if (! cls.empty ())
+    {
+      for (const auto& field : fields)
+        {
+          hid_t field_id = open_object (obj_id, field);
+          h5_id_closer field_closer (field_id, H5Oclose);
+
+          tmp.assign (field, get_object_data (field_id));
+        }
+
+      return octave_value (tmp);
+    }
+
+  bool same_dims = true;
+  dim_vector dv;
+
+  for (size_t ii = 0; ii < fields.size (); ii++)
+    {
+      octave_value val = read_child_dataset (obj_id, fields[ii]);
+
+      if (! val.iscell () || (ii > 0 && val.dims () != dv))
+        same_dims = false;
+
+      dv = val.dims ();
+
+      tmp.assign (fields[ii], val);
+    }
+
+  // Fall back to a scalar struct of cell arrays, as struct () would fail
+  if (! same_dims)
+    return octave_value (tmp);
+
+  octave_map val (dv);
+
+  for (const auto& field : fields)
+    val.setfield (field, tmp.getfield (field).cell_value ());
+
+  return octave_value (val);
+}
+
+static octave_value
+get_object_data (hid_t obj_id)
+{
+  bool empty = has_attribute (obj_id, "MATLAB_empty");
+
+  std::string cls = var_class (obj_id);
+
+  octave_value val;
+
+  if (is_array_class (cls) && ! has_attribute (obj_id, "MATLAB_sparse"))
+    {
+      if (empty && cls == "char")
+        val = octave_value ("");
+      else if (empty)
+        val = empty_value (cls, get_empty_dims (read_dataset (obj_id)));
+      else
+        val = decode_array (cls, read_dataset (obj_id));
+    }
+  else if (cls == "double" || cls == "single" || cls == "logical")
+    val = read_sparse (obj_id, cls);
+  else if (cls == "struct")
+    {
+      if (empty)
+        val = octave_value (octave_scalar_map ());
+      else
+        val = read_struct (obj_id);
+    }
+  else if (cls == "canonical empty")
+    val = empty_value (cls, get_empty_dims (read_dataset (obj_id)));
+  else if (cls == "cell")
+    {
+      val = read_dataset (obj_id);
+
+      if (empty)
+        val = empty_value (cls, get_empty_dims (val));
+    }
+  else
+    {
+      warning ("read_mat73: unhandled class %s, returning data asis",
+               cls.c_str ());
+
+      H5I_type_t obj_type = H5Iget_type (obj_id);
+
+      if (obj_type == H5I_DATASET)
+        val = read_dataset (obj_id);
+      else
+        val = Matrix ();
+    }
+
+  return val;
+}
+
+static herr_t
+var_visitor (hid_t loc_id, const char *name, const H5L_info_t * /*info*/,
+             void *op_data)
+{
+  std::vector<std::string> *names
+    = static_cast<std::vector<std::string> *> (op_data);
+
+  // Groups such as "#refs#" have no class and are not variables
+  htri_t is_var = H5Aexists_by_name (loc_id, name, "MATLAB_class",
+                                     H5P_DEFAULT);
+
+  if (is_var < 0)
+    return -1;
+  else if (is_var > 0)
+    names->push_back (name);
+
+  return 0;
+}
+
+static std::vector<std::string>
+list_variables (hid_t file_id)
+{
+  std::vector<std::string> names;
+
+  if (H5Literate (file_id, H5_INDEX_NAME, H5_ITER_NATIVE, nullptr,
+                  var_visitor, &names) < 0)
+    error ("read_mat73: unable to list variables");
+
+  return names;
+}
+
+static dim_vector
+dataset_dims (hid_t loc_id, const std::string& name)
+{
+  hid_t dataset_id = H5Dopen (loc_id, name.c_str (), H5P_DEFAULT);
+
+  if (dataset_id < 0)
+    error ("read_mat73: unable to open dataset '%s'", name.c_str ());
+
+  h5_id_closer dataset_closer (dataset_id, H5Dclose);
+
+  hid_t space_id = H5Dget_space (dataset_id);
+
+  if (space_id < 0)
+    error ("read_mat73: unable to retrieve data space");
+
+  h5_id_closer space_closer (space_id, H5Sclose);
+
+  return get_dim_vector (space_id);
+}
+
+// Name, size and class of a variable, as returned by whos, only reading
+// object headers and the small datasets holding the size of empty arrays
+static octave_scalar_map
+variable_info (hid_t file_id, const std::string& name)
+{
+  hid_t obj_id = open_object (file_id, name);
+  h5_id_closer obj_closer (obj_id, H5Oclose);
+
+  std::string cls = var_class (obj_id);
+  bool empty = has_attribute (obj_id, "MATLAB_empty");
+  bool sparse = has_attribute (obj_id, "MATLAB_sparse");
+  bool is_dataset = (H5Iget_type (obj_id) == H5I_DATASET);
+  bool iscomplex = false;
+
+  dim_vector dv (1, 1);
+
+  if (sparse)
+    {
+      octave_idx_type nr
+        = read_attribute (obj_id, "MATLAB_sparse").idx_type_value ();
+
+      dv = dim_vector (nr, dataset_dims (obj_id, "jc").numel () - 1);
+
+      iscomplex = (H5Lexists (obj_id, "data", H5P_DEFAULT) > 0
+                   && is_complex_dataset (obj_id, "data"));
+    }
+  else if (empty && cls == "char")
+    dv = dim_vector (0, 0);
+  else if (empty && is_dataset)
+    dv = get_empty_dims (read_dataset (obj_id));
+  else if (is_dataset)
+    {
+      dv = dataset_dims (file_id, name);
+      iscomplex = is_complex_dataset (file_id, name);
+    }
+  else if (cls == "struct" && ! empty)
+    {
+      // Struct arrays hold the references of each field in a dataset
+      std::vector<std::string> fields = read_field_names (obj_id);
+
+      if (! fields.empty ()
+          && H5Lexists (obj_id, fields[0].c_str (), H5P_DEFAULT) > 0)
+        {
+          hid_t field_id = open_object (obj_id, fields[0]);
+          h5_id_closer field_closer (field_id, H5Oclose);
+
+          if (var_class (field_id).empty ())
+            dv = dataset_dims (obj_id, fields[0]);
+        }
+    }
+
+  Matrix size (1, dv.ndims ());
+
+  for (int ii = 0; ii < dv.ndims (); ii++)
+    size(ii) = dv(ii);
+
+  octave_scalar_map info;
+  info.assign ("name", name);
+  info.assign ("size", size);
+  info.assign ("class", cls);
+  info.assign ("sparse", sparse);
+  info.assign ("complex", iscomplex);
+
+  return info;
+}
+
+// Datasets are compressed in chunks of about this size
+static const double chunk_bytes_target = 65536;
+
+// Chunk dimensions of a dataset with dimensions DIMS, in HDF5 order, of
+// TYPE_SIZE bytes elements.  Only datasets of at least THRESHOLD bytes are
+// compressed, an empty vector is returned for the others.  Chunks are
+// obtained by halving the slowest varying dimensions first, so that each
+// one is a contiguous part of the data.
+static std::vector<hsize_t>
+get_chunk_dims (const std::vector<hsize_t>& dims, size_t type_size,
+                int level, double threshold)
+{
+  double nbytes = type_size;
+
+  for (const auto& dim : dims)
+    nbytes *= dim;
+
+  if (level <= 0 || dims.empty () || nbytes == 0 || nbytes < threshold
+      || H5Zfilter_avail (H5Z_FILTER_DEFLATE) <= 0)
+    return std::vector<hsize_t> ();
+
+  std::vector<hsize_t> chunk = dims;
+  double chunk_bytes = nbytes;
+
+  for (size_t kk = 0; kk < chunk.size (); kk++)
+    while (chunk[kk] > 1 && chunk_bytes > chunk_bytes_target)
+      {
+        chunk_bytes /= chunk[kk];
+        chunk[kk] = (chunk[kk] + 1) / 2;
+        chunk_bytes *= chunk[kk];
+      }
+
+  return chunk;
+}
+
+// Creation property list for datasets, chunked with dimensions CHUNK_DIMS,
+// shuffled and deflated at compression LEVEL unless CHUNK_DIMS is empty.
+// Modification times are not recorded, so that saving the same data twice
+// produces the same file.
+static hid_t
+create_dcpl (const std::vector<hsize_t>& chunk_dims, size_t type_size,
+             int level)
+{
+  hid_t dcpl_id = H5Pcreate (H5P_DATASET_CREATE);
+
+  if (dcpl_id < 0)
+    error ("write_mat73: unable to create property list");
+
+  if (H5Pset_obj_track_times (dcpl_id, false) < 0
+      || (! chunk_dims.empty ()
+          && (H5Pset_chunk (dcpl_id, chunk_dims.size (),
+                            chunk_dims.data ()) < 0
+              || (type_size > 1 && H5Pset_shuffle (dcpl_id) < 0)
+              || H5Pset_deflate (dcpl_id, level) < 0)))
+    {
+      H5Pclose (dcpl_id);
+      error ("write_mat73: unable to set dataset creation properties");
+    }
+
+  return dcpl_id;
+}
+
+// Dimensions of an Octave array, in HDF5 order
+static std::vector<hsize_t>
+h5_dims (const dim_vector& dv)
+{
+  int rank = dv.ndims ();
+
+  std::vector<hsize_t> dims (rank);
+
+  for (int ii = 0; ii < rank; ii++)
+    dims[ii] = dv(rank-ii-1);
+
+  return dims;
+}
+
+// Settings of write_mat73
+struct write_options
+{
+  int level = 3;
+  double threshold = 4096;
+  int nthreads = 1;
+};
+
+// Data of an array in the layout of its dataset
+struct array_data
+{
+  // Keeps the data alive
+  std::shared_ptr<void> holder;
+
+  const void *buf = nullptr;
+  hid_t type_id = -1;
+  std::vector<hsize_t> dims;
+
+  // Empty for uncompressed datasets
+  std::vector<hsize_t> chunk_dims;
+};
+
+template <typename T>
+static array_data
+make_array_data (const T& arr, hid_t type_id)
+{
+  auto holder = std::make_shared<T> (arr);
+
+  array_data data;
+  data.buf = holder->data ();
+  data.holder = holder;
+  data.type_id = type_id;
+  data.dims = h5_dims (arr.dims ());
+
+  return data;
+}
+
+// Writer of Octave values to a MAT v7.3 file.  A single writer is used for
+// all variables saved at once: it keeps the "#refs#" group, the scalar
+// dataspace and the attribute types open, and reuses the dataspace of the
+// last written array when the next one has the same dimensions, which is
+// the common case for elements of cell arrays.
+//
+// Values are first walked by prepare, in the order in which write will
+// create their datasets, to convert arrays to their file layout and queue
+// those to be compressed in a chunk pipeline.  Chunks are then compressed
+// on worker threads while datasets are created and written in order from
+// the calling thread.
+class mat73_writer
+{
+public:
+
+  mat73_writer (hid_t file_id, const write_options& opts);
+
+  mat73_writer (const mat73_writer&) = delete;
+
+  mat73_writer& operator = (const mat73_writer&) = delete;
+
+  ~mat73_writer (void);
+
+  // Prepare VAL to be written.  Values must then be written in the same
+  // order.
+  void prepare (const octave_value& val);
+
+  // Write VAL as object NAME of LOC_ID.  Objects in "#refs#" also hold
+  // their path in an "H5PATH" attribute.
+  void write (hid_t loc_id, const std::string& name, const octave_value& val,
+              const std::string& h5path = "");
+
+private:
+
+  array_data encode_array (const std::string& cls, const octave_value& val);
+
+  hid_t write_empty (hid_t loc_id, const std::string& name,
+                     const dim_vector& dv);
+
+  hid_t write_array (hid_t loc_id, const std::string& name);
+
+  hid_t write_data (hid_t loc_id, const std::string& name, hid_t type_id,
+                    const std::vector<hsize_t>& dims, const void *buf,
+                    const std::vector<hsize_t>& chunk_dims
+                    = std::vector<hsize_t> ());
+
+  hid_t write_refs (hid_t loc_id, const std::string& name, const Cell& vals);
+
+  hid_t write_sparse (hid_t loc_id, const std::string& name,
+                      const octave_value& val);
+
+  hid_t write_struct (hid_t loc_id, const std::string& name,
+                      const octave_map& map);
+
+  void write_string_attribute (hid_t obj_id, const char *attr_name,
+                               const std::string& str);
+
+  void write_scalar_attribute (hid_t obj_id, const char *attr_name,
+                               hid_t type_id, const void *buf);
+
+  void write_field_names (hid_t obj_id, const string_vector& names);
+
+  hid_t simple_space (const std::vector<hsize_t>& dims);
+
+  hid_t refs_group (void);
+
+  hid_t complex_type (void);
+
+  std::string next_ref_name (void);
+
+  hid_t m_file_id;
+
+  write_options m_opts;
+
+  hid_t m_refs_id = -1;
+
+  octave_idx_type m_ref_count = 0;
+
+  hid_t m_scalar_space_id = -1;
+
+  // Creation property lists of uncompressed datasets and of groups
+  hid_t m_dcpl_id = -1;
+  hid_t m_gcpl_id = -1;
+
+  // Fixed length string types, by length
+  std::map<size_t, hid_t> m_str_types;
+
+  // Last created simple dataspace and its dimensions
+  hid_t m_space_id = -1;
+  std::vector<hsize_t> m_space_dims;
+
+  hid_t m_complex_type_id = -1;
+  hid_t m_float_complex_type_id = -1;
+
+  // Prepared arrays, in writing order
+  std::deque<array_data> m_arrays;
+
+  // Declared last to be destroyed first, before the arrays it compresses
+  chunk_pipeline m_pipeline;
+};
+
+mat73_writer::mat73_writer (hid_t file_id, const write_options& opts)
+  : m_file_id (file_id), m_opts (opts), m_pipeline (opts.nthreads)
+{
+  m_scalar_space_id = H5Screate (H5S_SCALAR);
+
+  if (m_scalar_space_id < 0)
+    error ("write_mat73: unable to create data space");
+
+  m_dcpl_id = create_dcpl (std::vector<hsize_t> (), 0, 0);
+
+  m_gcpl_id = H5Pcreate (H5P_GROUP_CREATE);
+
+  if (m_gcpl_id < 0 || H5Pset_obj_track_times (m_gcpl_id, false) < 0)
+    error ("write_mat73: unable to create property list");
+}
+
+mat73_writer::~mat73_writer (void)
+{
+  for (auto& str_type : m_str_types)
+    H5Tclose (str_type.second);
+
+  if (m_complex_type_id >= 0)
+    H5Tclose (m_complex_type_id);
+
+  if (m_float_complex_type_id >= 0)
+    H5Tclose (m_float_complex_type_id);
+
+  if (m_space_id >= 0)
+    H5Sclose (m_space_id);
+
+  if (m_scalar_space_id >= 0)
+    H5Sclose (m_scalar_space_id);
+
+  if (m_dcpl_id >= 0)
+    H5Pclose (m_dcpl_id);
+
+  if (m_gcpl_id >= 0)
+    H5Pclose (m_gcpl_id);
+
+  if (m_refs_id >= 0)
+    H5Gclose (m_refs_id);
+}
+
+// Same walk as write: elements of cell arrays in order, fields of structs
+// in order and, for struct arrays, the elements of each field in order
+void
+mat73_writer::prepare (const octave_value& val)
+{
+  std::string cls = val.class_name ();
+
+  // Unsupported values are reported by write, sparse matrices are written
+  // uncompressed
+  if (val.issparse () || val.isempty ())
+    return;
+  else if (cls == "cell")
+    {
+      Cell vals = val.cell_value ();
+
+      for (octave_idx_type ii = 0; ii < vals.numel (); ii++)
+        prepare (vals(ii));
+    }
+  else if (cls == "struct")
+    {
+      octave_map map = val.map_value ();
+      string_vector fields = map.keys ();
+
+      for (octave_idx_type ii = 0; ii < fields.numel (); ii++)
+        {
+          const Cell& vals = map.contents (fields(ii));
+
+          for (octave_idx_type jj = 0; jj < vals.numel (); jj++)
+            prepare (vals(jj));
+        }
+    }
+  else if (is_array_class (cls))
+    {
+      array_data data = encode_array (cls, val);
+
+      size_t type_size = H5Tget_size (data.type_id);
+
+      data.chunk_dims = get_chunk_dims (data.dims, type_size, m_opts.level,
+                                        m_opts.threshold);
+
+      if (! data.chunk_dims.empty ())
+        m_pipeline.add (data.buf, data.dims, data.chunk_dims, type_size,
+                        type_size > 1, m_opts.level);
+
+      m_arrays.push_back (data);
+    }
+}
+
+void
+mat73_writer::write (hid_t loc_id, const std::string& name,
+                     const octave_value& val, const std::string& h5path)
+{
+  std::string cls = val.class_name ();
+
+  if (! is_array_class (cls) && cls != "cell" && cls != "struct")
+    error ("write_mat73: unsupported type of variable '%s'", name.c_str ());
+
+  hid_t obj_id;
+
+  if (val.issparse ())
+    obj_id = write_sparse (loc_id, name, val);
+  else if (val.isempty ())
+    obj_id = write_empty (loc_id, name, val.dims ());
+  else if (cls == "cell")
+    obj_id = write_refs (loc_id, name, val.cell_value ());
+  else if (cls == "struct")
+    obj_id = write_struct (loc_id, name, val.map_value ());
+  else
+    obj_id = write_array (loc_id, name);
+
+  h5_id_closer obj_closer (obj_id, H5Oclose);
+
+  write_string_attribute (obj_id, "MATLAB_class", cls);
+
+  int32_t int_decode = (cls == "char" ? 2 : (cls == "logical" ? 1 : 0));
+
+  if (int_decode > 0)
+    write_scalar_attribute (obj_id, "MATLAB_int_decode", H5T_NATIVE_INT32,
+                            &int_decode);
+
+  if (val.isempty () && ! val.issparse ())
+    {
+      uint8_t empty = 1;
+      write_scalar_attribute (obj_id, "MATLAB_empty", H5T_NATIVE_UINT8,
+                              &empty);
+    }
+
+  if (! h5path.empty ())
+    write_string_attribute (obj_id, "H5PATH", h5path);
+}
+
+// Empty arrays are stored as their dimensions
+hid_t
+mat73_writer::write_empty (hid_t loc_id, const std::string& name,
+                           const dim_vector& dv)
+{
+  std::vector<uint64_t> sz (dv.ndims ());
+
+  for (int ii = 0; ii < dv.ndims (); ii++)
+    sz[ii] = dv(ii);
+
+  std::vector<hsize_t> dims (1, sz.size ());
+
+  return write_data (loc_id, name, H5T_NATIVE_UINT64, dims, sz.data ());
+}
+
+// Data of the non empty array VAL of class CLS, in the layout of its dataset
+array_data
+mat73_writer::encode_array (const std::string& cls, const octave_value& val)
+{
+  if (cls == "double" && val.iscomplex ())
+    return make_array_data (val.complex_array_value (), complex_type ());
+  else if (cls == "single" && val.iscomplex ())
+    {
+      if (m_float_complex_type_id < 0)
+        {
+          m_float_complex_type_id = H5Tcreate (H5T_COMPOUND,
+                                               sizeof (FloatComplex));
+          H5Tinsert (m_float_complex_type_id, "real", 0, H5T_NATIVE_FLOAT);
+          H5Tinsert (m_float_complex_type_id, "imag", sizeof (float),
+                     H5T_NATIVE_FLOAT);
+        }
+
+      return make_array_data (val.float_complex_array_value (),
+                              m_float_complex_type_id);
+    }
+  else if (cls == "double")
+    return make_array_data (val.array_value (), H5T_NATIVE_DOUBLE);
+  else if (cls == "single")
+    return make_array_data (val.float_array_value (), H5T_NATIVE_FLOAT);
+  else if (cls == "char")
+    {
+      charNDArray chars = val.char_array_value ();
+      dim_vector dv = chars.dims ();
+
+      if (dv.ndims () > 2)
+        {
+          bool ascii = true;
+
+          for (octave_idx_type ii = 0; ascii && ii < chars.numel (); ii++)
+            ascii = (static_cast<unsigned char> (chars(ii)) < 0x80);
+
+          if (! ascii)
+            {
+              warning ("write_mat73: Only first page of non-ASCII char array "
+                       "is written.");
+
+              charNDArray page (dim_vector (dv(0), dv(1)));
+
+              for (octave_idx_type ii = 0; ii < page.numel (); ii++)
+                page(ii) = chars(ii);
+
+              chars = page;
+            }
+        }
+
+      // UTF-16 code units, in native byte order
+      return make_array_data (encode_utf16 (chars), H5T_NATIVE_UINT16);
+    }
+  else if (cls == "logical" || cls == "uint8")
+    return make_array_data (val.uint8_array_value (), H5T_NATIVE_UINT8);
+  else if (cls == "int8")
+    return make_array_data (val.int8_array_value (), H5T_NATIVE_INT8);
+  else if (cls == "int16")
+    return make_array_data (val.int16_array_value (), H5T_NATIVE_INT16);
+  else if (cls == "uint16")
+    return make_array_data (val.uint16_array_value (), H5T_NATIVE_UINT16);
+  else if (cls == "int32")
+    return make_array_data (val.int32_array_value (), H5T_NATIVE_INT32);
+  else if (cls == "uint32")
+    return make_array_data (val.uint32_array_value (), H5T_NATIVE_UINT32);
+  else if (cls == "int64")
+    return make_array_data (val.int64_array_value (), H5T_NATIVE_INT64);
+  else
+    return make_array_data (val.uint64_array_value (), H5T_NATIVE_UINT64);
+}
+
+// Write the next prepared array to dataset NAME
+hid_t
+mat73_writer::write_array (hid_t loc_id, const std::string& name)
+{
+  if (m_arrays.empty ())
+    error ("write_mat73: internal error, array was not prepared");
+
+  array_data data = m_arrays.front ();
+  m_arrays.pop_front ();
+
+  return write_data (loc_id, name, data.type_id, data.dims, data.buf,
+                     data.chunk_dims);
+}
+
+// Create dataset NAME with dimensions DIMS, in HDF5 order, and write BUF to
+// it.  Datasets with chunk dimensions CHUNK_DIMS are compressed, their
+// chunks being taken from the pipeline.
+hid_t
+mat73_writer::write_data (hid_t loc_id, const std::string& name,
+                          hid_t type_id, const std::vector<hsize_t>& dims,
+                          const void *buf,
+                          const std::vector<hsize_t>& chunk_dims)
+{
+  hid_t space_id = simple_space (dims);
+
+  hid_t dcpl_id = m_dcpl_id;
+
+  if (! chunk_dims.empty ())
+    dcpl_id = create_dcpl (chunk_dims, H5Tget_size (type_id), m_opts.level);
+
+  hid_t dataset_id = H5Dcreate (loc_id, name.c_str (), type_id, space_id,
+                                H5P_DEFAULT, dcpl_id, H5P_DEFAULT);
+
+  if (dcpl_id != m_dcpl_id)
+    H5Pclose (dcpl_id);
+
+  if (dataset_id < 0)
+    error ("write_mat73: unable to create dataset '%s' (%s)", name.c_str (),
+           get_h5_error_desc ().c_str ());
+
+  h5_id_closer dataset_closer (dataset_id, H5Dclose);
+
+  if ((chunk_dims.empty () || ! m_pipeline.write (dataset_id))
+      && H5Dwrite (dataset_id, type_id, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                   buf) < 0)
+    error ("write_mat73: unable to write dataset '%s' (%s)", name.c_str (),
+           get_h5_error_desc ().c_str ());
+
+  return dataset_closer.release ();
+}
+
+// Write each element of VALS to a dataset in the "#refs#" group and create
+// dataset NAME, holding references to them
+hid_t
+mat73_writer::write_refs (hid_t loc_id, const std::string& name,
+                          const Cell& vals)
+{
+  hid_t refs_id = refs_group ();
+
+  std::vector<hobj_ref_t> refs (vals.numel ());
+
+  for (octave_idx_type ii = 0; ii < vals.numel (); ii++)
+    {
+      std::string ref_name = next_ref_name ();
+
+      write (refs_id, ref_name, vals(ii), "/#refs#/" + ref_name);
+
+      if (H5Rcreate (&refs[ii], refs_id, ref_name.c_str (), H5R_OBJECT,
+                     -1) < 0)
+        error ("write_mat73: unable to create reference");
+    }
+
+  return write_data (loc_id, name, H5T_STD_REF_OBJ, h5_dims (vals.dims ()),
+                     refs.data ());
+}
+
+// Row indices and column pointers of the sparse matrix SM, as stored in
+// the "ir" and "jc" datasets
+template <typename T>
+static void
+get_sparse_indices (const T& sm, std::vector<uint64_t>& ir,
+                    std::vector<uint64_t>& jc)
+{
+  octave_idx_type nc = sm.cols ();
+  octave_idx_type nz = sm.nnz ();
+
+  jc.resize (nc + 1);
+  ir.resize (nz);
+
+  for (octave_idx_type ii = 0; ii <= nc; ii++)
+    jc[ii] = sm.cidx ()[ii];
+
+  for (octave_idx_type ii = 0; ii < nz; ii++)
+    ir[ii] = sm.ridx ()[ii];
+}
+
+// Sparse matrices are groups holding the "jc", "ir" and "data" datasets read
+// by read_sparse, the latter two being omitted when there are no non-zero
+// elements.  The number of rows is the value of the "MATLAB_sparse"
+// attribute.
+hid_t
+mat73_writer::write_sparse (hid_t loc_id, const std::string& name,
+                            const octave_value& val)
+{
+  hid_t group_id = H5Gcreate (loc_id, name.c_str (), H5P_DEFAULT,
+                              m_gcpl_id, H5P_DEFAULT);
+
+  if (group_id < 0)
+    error ("write_mat73: unable to create group '%s' (%s)", name.c_str (),
+           get_h5_error_desc ().c_str ());
+
+  h5_id_closer group_closer (group_id, H5Gclose);
+
+  uint64_t nr = val.rows ();
+
+  write_scalar_attribute (group_id, "MATLAB_sparse", H5T_NATIVE_UINT64, &nr);
+
+  std::vector<uint64_t> ir;
+  std::vector<uint64_t> jc;
+  array_data data;
+
+  if (val.islogical ())
+    {
+      SparseBoolMatrix sm = val.sparse_bool_matrix_value ();
+      get_sparse_indices (sm, ir, jc);
+
+      uint8NDArray bytes (dim_vector (ir.size (), 1));
+      for (size_t ii = 0; ii < ir.size (); ii++)
+        bytes(ii) = sm.data ()[ii];
+
+      data = make_array_data (bytes, H5T_NATIVE_UINT8);
+    }
+  else if (val.iscomplex ())
+    {
+      SparseComplexMatrix sm = val.sparse_complex_matrix_value ();
+      get_sparse_indices (sm, ir, jc);
+
+      ComplexNDArray vals (dim_vector (ir.size (), 1));
+      std::copy (sm.data (), sm.data () + ir.size (), vals.fortran_vec ());
+
+      data = make_array_data (vals, complex_type ());
+    }
+  else
+    {
+      SparseMatrix sm = val.sparse_matrix_value ();
+      get_sparse_indices (sm, ir, jc);
+
+      NDArray vals (dim_vector (ir.size (), 1));
+      std::copy (sm.data (), sm.data () + ir.size (), vals.fortran_vec ());
+
+      data = make_array_data (vals, H5T_NATIVE_DOUBLE);
+    }
+
+  H5Dclose (write_data (group_id, "jc", H5T_NATIVE_UINT64,
+                        std::vector<hsize_t> (1, jc.size ()), jc.data ()));
+
+  if (! ir.empty ())
+    {
+      H5Dclose (write_data (group_id, "ir", H5T_NATIVE_UINT64,
+                            std::vector<hsize_t> (1, ir.size ()),
+                            ir.data ()));
+
+      H5Dclose (write_data (group_id, "data", data.type_id,
+                            std::vector<hsize_t> (1, ir.size ()),
+                            data.buf));
+    }
+
+  return group_closer.release ();
+}
+
+// Scalar structs are groups with one object per field.  Fields of struct
+// arrays are stored as arrays of references to the value of each element.
+hid_t
+mat73_writer::write_struct (hid_t loc_id, const std::string& name,
+                            const octave_map& map)
+{
+  hid_t group_id = H5Gcreate (loc_id, name.c_str (), H5P_DEFAULT,
+                              m_gcpl_id, H5P_DEFAULT);
+
+  if (group_id < 0)
+    error ("write_mat73: unable to create group '%s' (%s)", name.c_str (),
+           get_h5_error_desc ().c_str ());
+
+  h5_id_closer group_closer (group_id, H5Gclose);
+
+  string_vector fields = map.keys ();
+
+  write_field_names (group_id, fields);
+
+  for (octave_idx_type ii = 0; ii < fields.numel (); ii++)
+    {
+      const Cell& vals = map.contents (fields(ii));
+
+      if (map.numel () == 1)
+        write (group_id, fields(ii), vals(0));
+      else
+        {
+          hid_t refs_id = write_refs (group_id, fields(ii), vals);
+          H5Dclose (refs_id);
+        }
+    }
+
+  return group_closer.release ();
+}
+
+void
+mat73_writer::write_string_attribute (hid_t obj_id, const char *attr_name,
+                                      const std::string& str)
+{
+  auto it = m_str_types.find (str.length ());
+
+  if (it == m_str_types.end ())
+    {
+      hid_t type_id = H5Tcopy (H5T_C_S1);
+      H5Tset_size (type_id, str.length ());
+      H5Tset_cset (type_id, H5T_CSET_ASCII);
+
+      it = m_str_types.emplace (str.length (), type_id).first;
+    }
+
+  write_scalar_attribute (obj_id, attr_name, it->second, str.data ());
+}
+
+void
+mat73_writer::write_scalar_attribute (hid_t obj_id, const char *attr_name,
+                                      hid_t type_id, const void *buf)
+{
+  hid_t attr_id = H5Acreate (obj_id, attr_name, type_id, m_scalar_space_id,
+                             H5P_DEFAULT, H5P_DEFAULT);
+
+  if (attr_id < 0)
+    error ("write_mat73: unable to create attribute '%s'", attr_name);
+
+  h5_id_closer attr_closer (attr_id, H5Aclose);
+
+  if (H5Awrite (attr_id, type_id, buf) < 0)
+    error ("write_mat73: unable to write attribute '%s'", attr_name);
+}
+
+// Struct field names are stored as variable length sequences of one
+// character strings, without terminator
+void
+mat73_writer::write_field_names (hid_t obj_id, const string_vector& names)
+{
+  hid_t str_type_id = H5Tcopy (H5T_C_S1);
+
+  h5_id_closer str_type_closer (str_type_id, H5Tclose);
+
+  H5Tset_size (str_type_id, 1);
+
+  hid_t type_id = H5Tvlen_create (str_type_id);
+
+  h5_id_closer type_closer (type_id, H5Tclose);
+
+  hsize_t nfields = names.numel ();
+
+  hid_t space_id = H5Screate_simple (1, &nfields, nullptr);
+
+  h5_id_closer space_closer (space_id, H5Sclose);
+
+  hid_t attr_id = H5Acreate (obj_id, "MATLAB_fields", type_id, space_id,
+                             H5P_DEFAULT, H5P_DEFAULT);
+
+  if (attr_id < 0)
+    error ("write_mat73: unable to create attribute 'MATLAB_fields'");
+
+  h5_id_closer attr_closer (attr_id, H5Aclose);
+
+  std::vector<hvl_t> wdata (nfields);
+
+  for (hsize_t ii = 0; ii < nfields; ii++)
+    {
+      wdata[ii].len = names(ii).length ();
+      wdata[ii].p = const_cast<char *> (names(ii).data ());
+    }
+
+  if (nfields > 0 && H5Awrite (attr_id, type_id, wdata.data ()) < 0)
+    error ("write_mat73: unable to write attribute 'MATLAB_fields'");
+}
+
+// Dataspace with dimensions DIMS, reused while the dimensions do not change
+hid_t
+mat73_writer::simple_space (const std::vector<hsize_t>& dims)
+{
+  if (m_space_id >= 0 && dims == m_space_dims)
+    return m_space_id;
+
+  if (m_space_id >= 0)
+    H5Sclose (m_space_id);
+
+  m_space_dims = dims;
+  m_space_id = H5Screate_simple (dims.size (), dims.data (), nullptr);
+
+  if (m_space_id < 0)
+    error ("write_mat73: unable to create data space");
+
+  return m_space_id;
+}
+
+hid_t
+mat73_writer::refs_group (void)
+{
+  if (m_refs_id >= 0)
+    return m_refs_id;
+
+  if (H5Lexists (m_file_id, "#refs#", H5P_DEFAULT) > 0)
+    {
+      m_refs_id = H5Gopen (m_file_id, "#refs#", H5P_DEFAULT);
+
+      // Existing names are skipped by next_ref_name, start after them
+      H5G_info_t info;
+      if (m_refs_id >= 0 && H5Gget_info (m_refs_id, &info) >= 0)
+        m_ref_count = info.nlinks;
+    }
+  else
+    m_refs_id = H5Gcreate (m_file_id, "#refs#", H5P_DEFAULT, m_gcpl_id,
+                           H5P_DEFAULT);
+
+  if (m_refs_id < 0)
+    error ("write_mat73: unable to open group '#refs#'");
+
+  return m_refs_id;
+}
+
+// Compound type of double complex values, created on first use
+hid_t
+mat73_writer::complex_type (void)
+{
+  if (m_complex_type_id < 0)
+    {
+      m_complex_type_id = H5Tcreate (H5T_COMPOUND, sizeof (Complex));
+      H5Tinsert (m_complex_type_id, "real", 0, H5T_NATIVE_DOUBLE);
+      H5Tinsert (m_complex_type_id, "imag", sizeof (double),
+                 H5T_NATIVE_DOUBLE);
+    }
+
+  return m_complex_type_id;
+}
+
+// Names of referenced objects are "a", "b", ..., "z", "aa", "ab", ...
+std::string
+mat73_writer::next_ref_name (void)
+{
+  std::string name;
+
+  do
+    {
+      name.clear ();
+
+      for (octave_idx_type idx = m_ref_count++; idx >= 0;
+           idx = idx / 26 - 1)
+        name.insert (name.begin (), static_cast<char> ('a' + idx % 26));
+    }
+  while (H5Lexists (m_refs_id, name.c_str (), H5P_DEFAULT) > 0);
+
+  return name;
+}
+
+// PKG_ADD: autoload ("__read_mat73__", "__mat73__.oct");
+// PKG_DEL: autoload ("__read_mat73__", "__mat73__.oct", "remove");
+DEFUN_DLD(__read_mat73__, args, ,
+"-*- texinfo -*-\n\
+@deftypefn {} {@var{out_struct} =} __read_mat73__ (@var{fname}, @var{varnames})\n\
+Undocumented internal function.\n\
+@seealso{read_mat73}\n\
+@end deftypefn")
+{
+  if (args.length () != 2)
+    print_usage ();
+
+  std::string filename
+    = args(0).xstring_value ("read_mat73: FNAME must be a string");
+
+  // An empty list selects every variable
+  string_vector varnames
+    = args(1).xstring_vector_value ("read_mat73: VARNAMES must be a cell "
+                                    "array of strings");
+
+  // Errors are reported with the HDF5 error description instead
+  h5_error_silencer silencer;
+
+  hid_t file_id = H5Fopen (filename.c_str (), H5F_ACC_RDONLY, H5P_DEFAULT);
+
+  if (file_id < 0)
+    error ("read_mat73: unable to open '%s' (%s)", filename.c_str (),
+           get_h5_error_desc ().c_str ());
+
+  h5_id_closer file_closer (file_id, H5Fclose);
+
+  std::vector<std::string> names;
+
+  if (varnames.numel () == 0)
+    names = list_variables (file_id);
+  else
+    {
+      for (octave_idx_type ii = 0; ii < varnames.numel (); ii++)
+        {
+          if (H5Lexists (file_id, varnames(ii).c_str (), H5P_DEFAULT) <= 0)
+            error ("read_mat73: can't find variable '%s' in file '%s'",
+                   varnames(ii).c_str (), filename.c_str ());
+
+          names.push_back (varnames(ii));
+        }
+    }
+
+  octave_scalar_map rdata;
+
+  for (const auto& name : names)
+    {
+      hid_t obj_id = open_object (file_id, name);
+      h5_id_closer obj_closer (obj_id, H5Oclose);
+
+      rdata.assign (name, get_object_data (obj_id));
+    }
+
+  return ovl (rdata);
+}
+
+/*
+%!test
+%! s = __read_mat73__ (file_in_loadpath ('base_types_mat73.mat'), {});
+%! assert (isfield (s, 'cell_any'))
+%! assert (! isfield (s, '#refs#'))
+%! assert (issparse (s.sparse_double))
+%! assert (nnz (s.sparse_double), 4)
+
+%!fail ("__read_mat73__ ()", "Invalid call")
+
+%!fail ("__read_mat73__ (file_in_loadpath ('base_types_mat73.mat'), {'__none__'})", "can't find variable '__none__'")
+*/
+
+// PKG_ADD: autoload ("__mat73_whos__", "__mat73__.oct");
+// PKG_DEL: autoload ("__mat73_whos__", "__mat73__.oct", "remove");
+DEFUN_DLD(__mat73_whos__, args, ,
+"-*- texinfo -*-\n\
+@deftypefn {} {@var{info} =} __mat73_whos__ (@var{file_id})\n\
+Undocumented internal function.\n\
+@seealso{matfile73}\n\
+@end deftypefn")
+{
+  if (args.length () != 1)
+    print_usage ();
+
+  hid_t file_id = get_h5_id (args, 0, "FILE_ID", "matfile73", false);
+
+  h5_error_silencer silencer;
+
+  std::vector<std::string> names = list_variables (file_id);
+
+  std::vector<octave_scalar_map> info;
+
+  for (const auto& name : names)
+    info.push_back (variable_info (file_id, name));
+
+  if (info.empty ())
+    {
+      string_vector keys (5);
+      keys(0) = "name";
+      keys(1) = "size";
+      keys(2) = "class";
+      keys(3) = "sparse";
+      keys(4) = "complex";
+
+      return ovl (octave_map (dim_vector (0, 1), keys));
+    }
+
+  return ovl (octave_map::cat (0, info.size (), info.data ()));
+}
+
+// PKG_ADD: autoload ("__mat73_read__", "__mat73__.oct");
+// PKG_DEL: autoload ("__mat73_read__", "__mat73__.oct", "remove");
+DEFUN_DLD(__mat73_read__, args, ,
+"-*- texinfo -*-\n\
+@deftypefn {} {@var{val} =} __mat73_read__ (@var{file_id}, @var{varname})\n\
+Undocumented internal function.\n\
+@seealso{matfile73}\n\
+@end deftypefn")
+{
+  if (args.length () != 2)
+    print_usage ();
+
+  hid_t file_id = get_h5_id (args, 0, "FILE_ID", "matfile73", false);
+
+  std::string name
+    = args(1).xstring_value ("matfile73: VARNAME must be a string");
+
+  h5_error_silencer silencer;
+
+  if (H5Lexists (file_id, name.c_str (), H5P_DEFAULT) <= 0)
+    error ("matfile73: can't find variable '%s'", name.c_str ());
+
+  hid_t obj_id = open_object (file_id, name);
+  h5_id_closer obj_closer (obj_id, H5Oclose);
+
+  return ovl (get_object_data (obj_id));
+}
+
+// PKG_ADD: autoload ("__mat73_read_slab__", "__mat73__.oct");
+// PKG_DEL: autoload ("__mat73_read_slab__", "__mat73__.oct", "remove");
+DEFUN_DLD(__mat73_read_slab__, args, ,
+"-*- texinfo -*-\n\
+@deftypefn {} {@var{val} =} __mat73_read_slab__ (@var{file_id}, @var{varname}, @var{start}, @var{count}, @var{stride})\n\
+Undocumented internal function.\n\
+@seealso{matfile73}\n\
+@end deftypefn")
+{
+  if (args.length () != 5)
+    print_usage ();
+
+  hid_t file_id = get_h5_id (args, 0, "FILE_ID", "matfile73", false);
+
+  std::string name
+    = args(1).xstring_value ("matfile73: VARNAME must be a string");
+
+  h5_error_silencer silencer;
+
+  if (H5Lexists (file_id, name.c_str (), H5P_DEFAULT) <= 0)
+    error ("matfile73: can't find variable '%s'", name.c_str ());
+
+  hid_t obj_id = open_object (file_id, name);
+  h5_id_closer obj_closer (obj_id, H5Oclose);
+
+  std::string cls = var_class (obj_id);
+
+  // Only plain arrays are stored as a dataset with the variable's shape
+  if (! is_array_class (cls) || H5Iget_type (obj_id) != H5I_DATASET
+      || has_attribute (obj_id, "MATLAB_empty")
+      || has_attribute (obj_id, "MATLAB_sparse"))
+    error ("matfile73: partial loading of variable '%s' is not supported",
+           name.c_str ());
+
+  hid_t type_id = H5Dget_type (obj_id);
+
+  if (type_id < 0)
+    error ("matfile73: unable to retrieve data type");
+
+  h5_id_closer type_closer (type_id, H5Tclose);
+
+  hid_t file_space_id = H5Dget_space (obj_id);
+
+  if (file_space_id < 0)
+    error ("matfile73: unable to retrieve data space");
+
+  h5_id_closer file_space_closer (file_space_id, H5Sclose);
+
+  select_user_hyperslab ("matfile73", file_space_id, args(2), args(3),
+                         args(4));
+
+  hid_t mem_space_id = get_select_mem_space (file_space_id);
+
+  h5_id_closer mem_space_closer (mem_space_id, H5Sclose);
+
+  octave_value val = __h5_read__ ("matfile73", get_dim_vector (mem_space_id),
+                                  obj_id, type_id, mem_space_id,
+                                  file_space_id);
+
+  return ovl (decode_array (cls, val));
+}
+
+/*
+%!test
+%! file_id = H5F.open (file_in_loadpath ('base_types_mat73.mat'), 'H5F_ACC_RDONLY', 'H5P_DEFAULT');
+%! info = __mat73_whos__ (file_id);
+%! slab = __mat73_read_slab__ (file_id, 'ndim_double', [1 2 2], [1 1 Inf], []);
+%! full = __mat73_read__ (file_id, 'ndim_double');
+%! fail ("__mat73_read_slab__ (file_id, 'cell_any', 1, 1, [])", "partial loading of variable 'cell_any' is not supported");
+%! H5F.close (file_id);
+%! idx = strcmp ({info.name}, 'sparse_double');
+%! assert (info(idx).sparse)
+%! assert (info(strcmp ({info.name}, 'ndim_double')).size, size (full))
+%! assert (slab, full(1,2,2:end))
+
+%!fail ("__mat73_read_slab__ ()", "Invalid call")
+*/
+
+// PKG_ADD: autoload ("__write_mat73__", "__mat73__.oct");
+// PKG_DEL: autoload ("__write_mat73__", "__mat73__.oct", "remove");
+DEFUN_DLD(__write_mat73__, args, ,
+"-*- texinfo -*-\n\
+@deftypefn {} {} __write_mat73__ (@var{file_id}, @var{varnames}, @var{values}, @var{level}, @var{threshold}, @var{parallel})\n\
+Undocumented internal function.\n\
+@seealso{write_mat73}\n\
+@end deftypefn")
+{
+  if (args.length () != 6)
+    print_usage ();
+
+  hid_t file_id = get_h5_id (args, 0, "FILE_ID", "write_mat73", false);
+
+  string_vector varnames
+    = args(1).xstring_vector_value ("write_mat73: VARNAMES must be a cell "
+                                    "array of strings");
+
+  Cell values = args(2).xcell_value ("write_mat73: VALUES must be a cell "
+                                     "array");
+
+  if (values.numel () != varnames.numel ())
+    error ("write_mat73: VARNAMES and VALUES must have the same length");
+
+  write_options opts;
+
+  opts.level = args(3).xint_value ("write_mat73: LEVEL must be an integer");
+
+  opts.threshold
+    = args(4).xdouble_value ("write_mat73: THRESHOLD must be a scalar");
+
+  if (args(5).xbool_value ("write_mat73: PARALLEL must be a logical value"))
+    opts.nthreads = get_num_threads ();
+
+  // Errors are reported with the HDF5 error description instead
+  h5_error_silencer silencer;
+
+  mat73_writer writer (file_id, opts);
+
+  for (octave_idx_type ii = 0; ii < values.numel (); ii++)
+    writer.prepare (values(ii));
+
+  for (octave_idx_type ii = 0; ii < varnames.numel (); ii++)
+    writer.write (file_id, varnames(ii), values(ii));
+
+  return ovl ();
+}
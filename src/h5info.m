@@ -16,6 +16,7 @@
 ## -*- texinfo -*-
 ## @deftypefn {} {@var{s} =} h5info (@var{fname})
 ## @deftypefnx {} {@var{s} =} h5info (@var{fname}, @var{loc})
+## @deftypefnx {} {@var{s} =} h5info (@dots{}, @var{property}, @var{value}, @dots{})
 ## Return hdf5 file content description as a structure.
 ##
 ## If a second optionnal argument @var{loc} is present,
@@ -23,6 +24,20 @@
 ## a UNIX-like absolute path strarting from the root group,
 ## e.g. @qcode{"/GroupA/DS1"}.
 ##
+## The following @var{property}/@var{value} pairs limit what is read from
+## the file, e.g. to quickly list the structure of files with large
+## attributes or deep hierarchies:
+##  @multitable @columnfractions 0.33 0.02 0.65
+##  @item @qcode{"ReadAttributes"} @tab @tab If false, attributes are
+##     listed but their @code{Value} field is left empty (default true).
+##  @item @qcode{"MaxDepth"} @tab @tab Number of group levels below
+##     @var{loc} whose contents are described. Deeper groups are listed with
+##     empty @code{Groups} and @code{Datasets} fields (default @code{Inf}).
+##  @item @qcode{"ReadDatasetProperties"} @tab @tab If false, dataset
+##     creation properties are not queried and @code{ChunkSize} is left
+##     empty (default true).
+##  @end multitable
+##
 ## The output structure contains fields depending of the described contents.
 ##
 ## For groups the fields are
@@ -68,7 +83,7 @@
 
 ## PKG_ADD: if(exist(fullfile (fileparts (mfilename ("fullpath")), "testdir"), 'dir')) addpath (fullfile (fileparts (mfilename ("fullpath")), "testdir")); end
 ## PKG_DEL: if(exist(fullfile (fileparts (mfilename ("fullpath")), "testdir"), 'dir')) rmpath (fullfile (fileparts (mfilename ("fullpath")), "testdir")); end
-function s = h5info (fname, obj_name = "/")
+function s = h5info (fname, varargin)
 
   if (! exist ("fname", "var"))
     print_usage ()
@@ -76,293 +91,67 @@ function s = h5info (fname, obj_name = "/")
     error ("h5info: FNAME must be an existing file name")
   endif
 
-  unwind_protect
-    H5E.set_auto (false);
-    try
-      file = H5F.open (fname, "H5F_ACC_RDONLY", "H5P_DEFAULT");
-    catch
-      rethrow_h5error ()
-    end_try_catch
-
-    ## Begin iteration.
-    ## Get object info for the root group
-    infobuf = H5O.get_info_by_name (file, obj_name, "H5P_DEFAULT");
-
-    [status, s] = op_func (file, obj_name, group_struct ("__g__", []));
+  ## LOC is optional, property names may not start a location path
+  props = {"readattributes", "maxdepth", "readdatasetproperties"};
 
-    ## Remove fake container group
-    if (! isempty (s.Groups))
-      s = s.Groups;
-    else
-      s = s.Datasets;
+  obj_name = "/";
+  if (numel (varargin) > 0
+      && ! (ischar (varargin{1}) && any (strcmpi (varargin{1}, props))))
+    obj_name = varargin{1};
+    varargin(1) = [];
+    if (! ischar (obj_name) || ! isrow (obj_name))
+      error ("h5info: LOC must be a string")
     endif
-
-    ## Add Filename field for root group
-    if (strcmp (obj_name, "/"))
-      fields = fieldnames (s);
-      s.Filename = make_absolute_filename (fname);
-      fields = {'Filename', fields{:}};
-      s = orderfields (s, fields);
-    endif
-
-  unwind_protect_cleanup
-    ## Close and release resources.
-    if (exist ("file", "var"))
-      H5F.close (file);
-    endif
-
-    ## Restore previous error printing
-    H5E.set_auto (true);
-  end_unwind_protect
-endfunction
-
-function rethrow_h5error ()
-  H5E.walk ("H5E_WALK_UPWARD", @error_walker);
-endfunction
-
-function status = error_walker (n, s)
-  msg = [lasterr() " (" s.desc ")"];
-  error (msg);
-  status = -1;
-endfunction
-
-function cst = get_constants ()
-  persistent constants = {"H5S_SIMPLE", "H5S_NULL", "H5S_SCALAR", ...
-                          "H5O_TYPE_GROUP", "H5O_TYPE_DATASET", ...
-                          "H5D_CHUNKED", "H5D_FILL_VALUE_USER_DEFINED",...
-                          "H5O_TYPE_NAMED_DATATYPE"};
-  persistent vals = cellfun (@H5ML.get_constant_value, constants, "uni", false);
-  persistent s = struct ([constants; vals]{:});
-  cst = s;
-endfunction
-
-function debug_print (varargin)
-
-  persistent debug = true;
-
-  if (numel (varargin) && islogical (varargin{1}))
-    debug = varargin{1};
-  elseif (debug)
-    printf (varargin{:})
   endif
 
-endfunction
-
-function s = group_struct (name, addr = 0)
-  persistent ss = struct ("Name", name, "Groups", [], ...
-                          "Datasets", [], "Datatypes", [], ...
-                          "Links", [], "Attributes", [], "addr", addr);
-  ss.Name = name;
-  ss.addr = addr;
-  s = ss;
-endfunction
-
-function s = dataset_struct (name)
-  persistent ss  = struct ("Name", name, "Datatype", datatype_struct (""), ...
-                           "Dataspace", dataspace_struct (), ...
-                           "ChunkSize", [], "FillValue", 0, "Filters", [], ...
-                           "Attributes", []);
-  ss.Name = name;
-  s = ss;
-endfunction
-
-function s = attribute_struct (name)
-  persistent ss  = struct ("Name", name, "Datatype", datatype_struct (""), ...
-                           "Dataspace", dataspace_struct (), "Value", []);
-  ss.Name = name;
-  s = ss;
-endfunction
-
-function s = datatype_struct (name)
-  persistent ss = struct ("Name", name, "Class", "", "Type", "", "Size", 0, ...
-                          "Attributes", []);
-  ss.Name = name;
-  s = ss;
-endfunction
-
-function s = dataspace_struct ()
-  persistent ss = struct ("Size", [], "MaxSize", [], "Type", "simple");
-  s = ss;
-endfunction
-
-function status = group_check (parent_addr, target_addr)
-  status = 0;
-
-  if (any (parent_addr == target_addr))
-    status = 1; # addr match
+  if (mod (numel (varargin), 2) == 1)
+    error ("h5info: PROPERTY/VALUE arguments must occur in pairs")
   endif
-endfunction
-
-function [status, od_out] = attr_op_func (loc_id, name, od_in)
-
-  attr_id = H5A.open (loc_id, name, "H5P_DEFAULT");
-
-  as = attribute_struct (name);
-
-  ## Type info
-  type_id = H5A.get_type (attr_id);
-  as.Datatype = H5LT.dtype_to_struct (type_id);
-  H5T.close (type_id);
-
-  ## Space info
-  space_id = H5A.get_space (attr_id);
-  [n, dims, maxdims] = H5S.get_simple_extent_dims (space_id);
-  space_type = H5S.get_simple_extent_type (space_id);
 
-  persistent cst = get_constants ();
+  read_values = true;
+  max_depth = Inf;
+  read_dcpl = true;
 
-  switch (space_type)
-    case cst.H5S_SIMPLE
-      as.Dataspace.Size = dims;
-      as.Dataspace.MaxSize = maxdims;
-    case cst.H5S_NULL
-      as.Dataspace.Size = dims;
-      as.Dataspace.MaxSize = maxdims;
-      as.Dataspace.Type = "null";
-    case cst.H5S_SCALAR
-      as.Dataspace.Size = [];
-      as.Dataspace.MaxSize = [];
-      as.Dataspace.Type = "scalar";
-  endswitch
-
-  H5S.close (space_id);
-
-  try
-    as.Value = H5A.read (attr_id);
-  catch
-    disp (lasterr)
-  end_try_catch
-
-  H5A.close (attr_id);
-
-  if (isempty (od_in))
-    od_in = as;
-  else
-    od_in = [od_in; as];
+  for ii = 1:2:numel (varargin)
+    prop = varargin{ii};
+    val = varargin{ii+1};
+    if (! ischar (prop))
+      error ("h5info: PROPERTY must be a string")
+    endif
+    switch (lower (prop))
+      case "readattributes"
+        read_values = logical_value (prop, val);
+      case "maxdepth"
+        if (! isnumeric (val) || ! isreal (val) || ! isscalar (val)
+            || ! (val >= 0))
+          error ("h5info: value of '%s' must be a non-negative scalar", prop)
+        endif
+        max_depth = double (val);
+      case "readdatasetproperties"
+        read_dcpl = logical_value (prop, val);
+      otherwise
+        error ("h5info: unknown property '%s'", prop)
+    endswitch
+  endfor
+
+  s = __h5info__ (fname, obj_name, read_values, max_depth, read_dcpl);
+
+  ## Add Filename field for root group
+  if (strcmp (obj_name, "/"))
+    fields = fieldnames (s);
+    s.Filename = make_absolute_filename (fname);
+    fields = {'Filename', fields{:}};
+    s = orderfields (s, fields);
   endif
 
-  status = 0;
-  od_out = od_in;
 endfunction
 
-function [status, od_out] = op_func (loc_id, name, od_in)
-
-  status = 0;
-
-  spaces = 2*(numel (od_in.addr) + 1);
-
-  infobuf = H5O.get_info_by_name (loc_id, name, "H5P_DEFAULT");
-
-  persistent cst = get_constants ();
-
-  switch (infobuf.type)
-    case cst.H5O_TYPE_GROUP
-      ## Iterate through the links of this group
-      if (group_check (od_in.addr, infobuf.addr))
-        debug_print ("%*s  Warning: Loop detected!\n", spaces, "");
-      else
-        if (strcmp (od_in.Name, "__g__"))
-          basename = "";
-        elseif (strcmp (od_in.Name, "/"))
-          basename = "/";
-        else
-          basename = [od_in.Name "/"];
-        endif
-
-        child_od = group_struct ([basename name], [od_in.addr infobuf.addr]);
-
-        [status, ii, cod_out] = H5L.iterate_by_name (loc_id, ...
-                                                     name, ...
-                                                     "H5_INDEX_NAME", ...
-                                                     "H5_ITER_NATIVE", ...
-                                                     0, ...
-                                                     @op_func,...
-                                                     child_od, ...
-                                                     "H5P_DEFAULT");
-
-
-        ## Attributes
-        [status, ii, att_out] = H5A.iterate_by_name (loc_id, name, ...
-                                                     "H5_INDEX_NAME", ...
-                                                     "H5_ITER_NATIVE", 0,
-                                                     @attr_op_func, [],...
-                                                     "H5P_DEFAULT");
-
-        cod_out.Attributes = att_out;
-
-        od_in.Groups = [od_in.Groups; cod_out];
-      endif
-
-    case cst.H5O_TYPE_DATASET
-
-      ds = dataset_struct (name);
-
-      ## Type info
-      dset_id = H5D.open (loc_id, name, "H5P_DEFAULT");
-      type_id = H5D.get_type (dset_id);
-
-      ds.Datatype = H5LT.dtype_to_struct (type_id);
-
-      H5T.close (type_id);
-
-      ## Space info
-      space_id = H5D.get_space (dset_id);
-      [n, dims, maxdims] = H5S.get_simple_extent_dims (space_id);
-
-      space_type = H5S.get_simple_extent_type (space_id);
-
-      switch (space_type)
-        case cst.H5S_SIMPLE
-          ds.Dataspace.Size = fliplr (dims);
-          ds.Dataspace.MaxSize = fliplr (maxdims);
-        case cst.H5S_NULL
-          ds.Dataspace.Size = fliplr (dims);
-          ds.Dataspace.MaxSize = fliplr (maxdims);
-          ds.Dataspace.Type = "null";
-        case cst.H5S_SCALAR
-          ds.Dataspace.Size = 1;
-          ds.Dataspace.MaxSize = 1;
-          ds.Dataspace.Type = "scalar";
-      endswitch
-
-      H5S.close (space_id);
-
-      ## Chunk size
-      dcpl_id = H5D.get_create_plist (dset_id);
-      chunk_dims = [];
-      if (H5P.get_layout (dcpl_id) == cst.H5D_CHUNKED)
-        [~,chunk_dims] = H5P.get_chunk (dcpl_id);
-      endif
-
-      ds.ChunkSize = chunk_dims;
-
-      ## Fill value
-      fill_id = H5P.fill_value_defined (dcpl_id);
-      if (fill_id == cst.H5D_FILL_VALUE_USER_DEFINED)
-        ## FIXME: implement
-        ## ds.FillValue = H5P.get_fill_value (dcpl_id, type_id);
-      endif
-
-      H5P.close (dcpl_id);
-      H5D.close (dset_id);
-
-      ## Attributes
-      [status, ii, att_out] = H5A.iterate_by_name (loc_id, name, ...
-                                                   "H5_INDEX_NAME", ...
-                                                   "H5_ITER_NATIVE", 0,
-                                                   @attr_op_func, [], ...
-                                                   "H5P_DEFAULT");
-      ds.Attributes = att_out;
-
-      od_in.Datasets = [od_in.Datasets; ds];
-
-    case cst.H5O_TYPE_NAMED_DATATYPE
-
-    otherwise
-
-  endswitch
-
-  od_out = od_in;
+function tf = logical_value (prop, val)
+  if (! (islogical (val) || (isnumeric (val) && isreal (val)))
+      || ! isscalar (val))
+    error ("h5info: value of '%s' must be a logical scalar", prop)
+  endif
+  tf = logical (val);
 endfunction
 
 %!fail ("h5info ()", "Invalid call")
@@ -371,6 +160,23 @@ endfunction
 
 %!fail ("h5info (which ('plot'))", "file signature not found")
 
+%!fail ("h5info (which ('plot'), '/', 'Depth', 1)", "unknown property 'Depth'")
+
+%!shared fname
+%! fname = file_in_loadpath ('base_types_mat73.mat');
+
+%!error <LOC must be a string> h5info (fname, 1)
+%!error <LOC must be a string> h5info (fname, ['/'; '/'])
+%!error <must occur in pairs> h5info (fname, 'MaxDepth')
+%!error <must occur in pairs> h5info (fname, '/', 'MaxDepth')
+%!error <must occur in pairs> h5info (fname, 'MaxDepth', 1, 'ReadAttributes')
+%!error <'MaxDepth' must be a non-negative scalar> h5info (fname, 'MaxDepth', -1)
+%!error <'MaxDepth' must be a non-negative scalar> h5info (fname, 'MaxDepth', [1 2])
+%!error <'MaxDepth' must be a non-negative scalar> h5info (fname, 'MaxDepth', 'all')
+%!error <'ReadAttributes' must be a logical scalar> h5info (fname, 'ReadAttributes', 'no')
+%!error <'ReadDatasetProperties' must be a logical scalar>
+%! h5info (fname, '/', 'ReadDatasetProperties', [true false])
+
 ## Make sure Octave's output is consistent with ML's. Skip 'FillValue' which
 ## is currently not implemented in Octave.
 
@@ -0,0 +1,141 @@
+/*
+
+Copyright (C) 2025 Pantxo Diribarne
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#include <octave/oct.h>
+#include <hdf5.h>
+
+#include "./util/h5_oct_util.h"
+#include "./util/h5_data_util.h"
+
+// PKG_ADD: autoload ("h5read", "h5read.oct");
+// PKG_DEL: autoload ("h5read", "h5read.oct", "remove");
+DEFUN_DLD(h5read, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {@var{data} =} h5read (@var{filename}, @var{dsname})\n\
+@deftypefnx {} {@var{data} =} h5read (@var{filename}, @var{dsname}, @var{start}, @var{count})\n\
+@deftypefnx {} {@var{data} =} h5read (@var{filename}, @var{dsname}, @var{start}, @var{count}, @var{stride})\n\
+Read data from dataset @var{dsname} in HDF5 file @var{filename}.\n\
+\n\
+With @var{start} and @var{count}, only @var{count}(@var{n}) elements are \
+read along each dimension @var{n}, starting at the one-based index \
+@var{start}(@var{n}) and taking every @var{stride}(@var{n})-th element \
+(every element by default). Elements of @var{count} may be @code{Inf} to \
+read up to the end of the corresponding dimension. All three vectors have \
+one element per dataset dimension, in the same order as the output of \
+@code{size}.\n\
+\n\
+The file is opened, read and closed in a single call, with the data \
+converted as @code{H5D.read} does with @qcode{\"H5ML_DEFAULT\"}.\n\
+\n\
+@example\n\
+## Read every other row of the first 10 columns of dataset \"/x\"\n\
+x = h5read (\"some_file.h5\", \"/x\", [1 1], [Inf 10], [2 1]);\n\
+@end example\n\
+@seealso{h5write,h5readatt,h5info,H5D.read}\n\
+@end deftypefn")
+{
+  int nargin = args.length ();
+
+  if (nargin != 2 && nargin != 4 && nargin != 5)
+    print_usage ();
+
+  std::string filename
+    = args(0).xstring_value ("h5read: FILENAME must be a string");
+
+  std::string dsname
+    = args(1).xstring_value ("h5read: DSNAME must be a string");
+
+  // Errors are reported with the HDF5 error description instead
+  h5_error_silencer silencer;
+
+  hid_t file_id = H5Fopen (filename.c_str (), H5F_ACC_RDONLY, H5P_DEFAULT);
+
+  if (file_id < 0)
+    error ("h5read: unable to open file '%s' (%s)", filename.c_str (),
+           get_h5_error_desc ().c_str ());
+
+  h5_id_closer file_closer (file_id, H5Fclose);
+
+  hid_t dataset_id = H5Dopen (file_id, dsname.c_str (), H5P_DEFAULT);
+
+  if (dataset_id < 0)
+    error ("h5read: unable to open dataset '%s' (%s)", dsname.c_str (),
+           get_h5_error_desc ().c_str ());
+
+  h5_id_closer dataset_closer (dataset_id, H5Dclose);
+
+  hid_t type_id = H5Dget_type (dataset_id);
+
+  if (type_id < 0)
+    error ("h5read: unable to retrieve data type");
+
+  h5_id_closer type_closer (type_id, H5Tclose);
+
+  hid_t file_space_id = H5Dget_space (dataset_id);
+
+  if (file_space_id < 0)
+    error ("h5read: unable to retrieve data space");
+
+  h5_id_closer file_space_closer (file_space_id, H5Sclose);
+
+  // Only read the selected elements in a buffer shaped after the hyperslab
+  hid_t mem_space_id = H5S_ALL;
+
+  if (nargin > 2)
+    {
+      select_user_hyperslab ("h5read", file_space_id, args(2), args(3),
+                             nargin > 4 ? args(4) : octave_value (Matrix ()));
+
+      mem_space_id = get_select_mem_space (file_space_id);
+    }
+
+  h5_id_closer mem_space_closer (mem_space_id, H5Sclose);
+
+  dim_vector dv = get_dim_vector (mem_space_id != H5S_ALL ? mem_space_id
+                                                          : file_space_id);
+
+  return ovl (__h5_read__ ("h5read", dv, dataset_id, type_id, mem_space_id,
+                           file_space_id));
+}
+
+/*
+%!test
+%! fname = tempname ();
+%! fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%! space = H5S.create_simple (2, [4 6], []);
+%! dset = H5D.create (fid, '/a', 'H5T_NATIVE_DOUBLE', space, 'H5P_DEFAULT');
+%! data = reshape (1:24, 6, 4);
+%! H5D.write (dset, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT', data);
+%! H5D.close (dset);
+%! H5S.close (space);
+%! H5F.close (fid);
+%! full = h5read (fname, '/a');
+%! slab = h5read (fname, '/a', [2 1], [3 2]);
+%! strided = h5read (fname, '/a', [1 2], [Inf 2], [2 2]);
+%! fail ("h5read (fname, '/a', [1 1], [7 1])", "COUNT\\(1\\) must be an integer between 0 and 6");
+%! fail ("h5read (fname, '/b')", "unable to open dataset '/b'");
+%! delete (fname);
+%! assert (full, data)
+%! assert (slab, data(2:4,1:2))
+%! assert (strided, data(1:2:end,[2 4]))
+
+%!fail ("h5read ()", "Invalid call");
+
+%!fail ("h5read (tempname (), '/a')", "unable to open file");
+*/
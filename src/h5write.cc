@@ -0,0 +1,128 @@
+/*
+
+Copyright (C) 2025 Pantxo Diribarne
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#include <octave/oct.h>
+#include <hdf5.h>
+
+#include "./util/h5_oct_util.h"
+#include "./util/h5_data_util.h"
+
+// PKG_ADD: autoload ("h5write", "h5write.oct");
+// PKG_DEL: autoload ("h5write", "h5write.oct", "remove");
+DEFUN_DLD(h5write, args, , 
+"-*- texinfo -*-\n\
+@deftypefn {} {} h5write (@var{filename}, @var{dsname}, @var{data})\n\
+@deftypefnx {} {} h5write (@var{filename}, @var{dsname}, @var{data}, @var{start}, @var{count})\n\
+@deftypefnx {} {} h5write (@var{filename}, @var{dsname}, @var{data}, @var{start}, @var{count}, @var{stride})\n\
+Write @var{data} to the existing dataset @var{dsname} in HDF5 file \
+@var{filename}.\n\
+\n\
+With @var{start} and @var{count}, only the hyperslab of @var{count}(@var{n}) \
+elements along each dimension @var{n}, starting at the one-based index \
+@var{start}(@var{n}) and taking every @var{stride}(@var{n})-th element \
+(every element by default), is written and @var{data} must hold as many \
+elements as the hyperslab. Elements of @var{count} may be @code{Inf} to \
+extend the hyperslab up to the end of the corresponding dimension. All \
+three vectors have one element per dataset dimension, in the same order \
+as the output of @code{size}.\n\
+\n\
+The file is opened, written and closed in a single call, with the data \
+converted to the dataset type as @code{H5D.write} does with \
+@qcode{\"H5ML_DEFAULT\"}.\n\
+\n\
+@example\n\
+## Overwrite the 10-by-10 block at the top left corner of dataset \"/x\"\n\
+h5write (\"some_file.h5\", \"/x\", zeros (10), [1 1], [10 10]);\n\
+@end example\n\
+@seealso{h5read,H5D.write}\n\
+@end deftypefn")
+{
+  int nargin = args.length ();
+
+  if (nargin != 3 && nargin != 5 && nargin != 6)
+    print_usage ();
+
+  std::string filename
+    = args(0).xstring_value ("h5write: FILENAME must be a string");
+
+  std::string dsname
+    = args(1).xstring_value ("h5write: DSNAME must be a string");
+
+  // Errors are reported with the HDF5 error description instead
+  h5_error_silencer silencer;
+
+  hid_t file_id = H5Fopen (filename.c_str (), H5F_ACC_RDWR, H5P_DEFAULT);
+
+  if (file_id < 0)
+    error ("h5write: unable to open file '%s' (%s)", filename.c_str (),
+           get_h5_error_desc ().c_str ());
+
+  h5_id_closer file_closer (file_id, H5Fclose);
+
+  hid_t dataset_id = H5Dopen (file_id, dsname.c_str (), H5P_DEFAULT);
+
+  if (dataset_id < 0)
+    error ("h5write: unable to open dataset '%s' (%s)", dsname.c_str (),
+           get_h5_error_desc ().c_str ());
+
+  h5_id_closer dataset_closer (dataset_id, H5Dclose);
+
+  hid_t file_space_id = H5Dget_space (dataset_id);
+
+  if (file_space_id < 0)
+    error ("h5write: unable to retrieve data space");
+
+  h5_id_closer file_space_closer (file_space_id, H5Sclose);
+
+  if (nargin > 3)
+    select_user_hyperslab ("h5write", file_space_id, args(3), args(4),
+                           nargin > 5 ? args(5) : octave_value (Matrix ()));
+
+  // DATA is checked against the selection, H5ML_DEFAULT memory type
+  __h5write__ ("h5write", args(2), dataset_id, -1234, H5S_ALL,
+               file_space_id, H5P_DEFAULT);
+
+  return octave_value_list ();
+}
+
+/*
+%!test
+%! fname = tempname ();
+%! fid = H5F.create (fname, 'H5F_ACC_TRUNC', 'H5P_DEFAULT', 'H5P_DEFAULT');
+%! space = H5S.create_simple (2, [4 6], []);
+%! dset = H5D.create (fid, '/a', 'H5T_NATIVE_DOUBLE', space, 'H5P_DEFAULT');
+%! H5D.close (dset);
+%! H5S.close (space);
+%! H5F.close (fid);
+%! data = reshape (1:24, 6, 4);
+%! h5write (fname, '/a', data);
+%! h5write (fname, '/a', -ones (3, 2), [2 1], [3 2]);
+%! h5write (fname, '/a', [0 0], [6 2], [1 Inf], [1 2]);
+%! fail ("h5write (fname, '/a', 1:5, [1 1], [2 2])", "DATA has 5 elements");
+%! fail ("h5write (fname, '/b', 1)", "unable to open dataset '/b'");
+%! rdata = h5read (fname, '/a');
+%! delete (fname);
+%! data(2:4,1:2) = -1;
+%! data(6,[2 4]) = 0;
+%! assert (rdata, data)
+
+%!fail ("h5write ()", "Invalid call");
+
+%!fail ("h5write (tempname (), '/a', 1)", "unable to open file");
+*/
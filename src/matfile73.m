@@ -0,0 +1,284 @@
+## Copyright (C) 2025 Pantxo Diribarne
+##
+## This program is free software: you can redistribute it and/or modify
+## it under the terms of the GNU General Public License as published by
+## the Free Software Foundation, either version 3 of the License, or
+## (at your option) any later version.
+##
+## This program is distributed in the hope that it will be useful,
+## but WITHOUT ANY WARRANTY; without even the implied warranty of
+## MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+## GNU General Public License for more details.
+##
+## You should have received a copy of the GNU General Public License
+## along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+## -*- texinfo -*-
+## @deftypefn {} {@var{m} =} matfile73 (@var{fname})
+## Open a Matlab v7.3 file for reading variables on demand.
+##
+## The file is kept open until @var{m} is deleted. Variables are listed with
+## @code{who (@var{m})} or @code{whos (@var{m})}, without reading their
+## data, and are read as fields of @var{m}:
+##
+## @example
+## m = matfile73 ("data.mat");
+## x = m.x;              # read the whole variable x
+## y = m.y(1000:2000,:); # only read rows 1000 to 2000 of y
+## @end example
+##
+## Indexing a numeric or logical variable with parentheses only reads the
+## indexed region from the file: the smallest block containing the indexed
+## elements along each dimension, or exactly the indexed elements when they
+## are evenly spaced. Other variables, including char arrays whose stored
+## UTF-16 code units do not map to characters one to one, and linear
+## indexing of matrices, are read whole before being indexed. The @code{end}
+## keyword is not supported in indices and raises an error, use the sizes
+## returned by @code{whos} instead.
+##
+## @seealso{read_mat73, whos}
+## @end deftypefn
+
+classdef matfile73 < handle
+
+  properties (SetAccess = private)
+    ## Absolute name of the file
+    Filename = "";
+  endproperties
+
+  properties (Access = private)
+    file_id = -1;
+    info = [];
+  endproperties
+
+  methods
+
+    function obj = matfile73 (fname)
+      if (nargin != 1)
+        print_usage ();
+      elseif (! ischar (fname))
+        error ("matfile73: FNAME must be a string")
+      endif
+
+      fullname = file_in_loadpath (fname);
+      if (isempty (fullname) || ! exist (fullname, "file"))
+        error ("matfile73: FNAME must be a valid file name")
+      endif
+
+      obj.file_id = H5F.open (fullname, "H5F_ACC_RDONLY", "H5P_DEFAULT");
+      obj.Filename = make_absolute_filename (fullname);
+      obj.info = __mat73_whos__ (obj.file_id);
+    endfunction
+
+    function delete (obj)
+      if (obj.file_id >= 0)
+        H5F.close (obj.file_id);
+        obj.file_id = -1;
+      endif
+    endfunction
+
+    ## -*- texinfo -*-
+    ## @deftypefn {} {@var{names} =} who (@var{m})
+    ## Return the names of the variables in the file as a cell array.
+    ## @end deftypefn
+    function names = who (obj)
+      names = {obj.info.name}.';
+      if (nargout == 0)
+        printf ("Variables in the file %s:\n\n", obj.Filename);
+        printf ("  %s\n", names{:});
+        printf ("\n");
+        clear names
+      endif
+    endfunction
+
+    ## -*- texinfo -*-
+    ## @deftypefn {} {@var{s} =} whos (@var{m})
+    ## Return a struct array with the @code{name}, @code{size},
+    ## @code{class}, @code{sparse} and @code{complex} fields of each variable
+    ## in the file.
+    ## @end deftypefn
+    function s = whos (obj)
+      s = obj.info;
+    endfunction
+
+    function disp (obj)
+      printf ("  matfile73 object for file %s\n\n", obj.Filename);
+      for ii = 1:numel (obj.info)
+        sz = sprintf ("%dx", obj.info(ii).size)(1:end-1);
+        printf ("  %-20s %-12s %s\n", obj.info(ii).name, sz,
+                obj.info(ii).class);
+      endfor
+    endfunction
+
+    function n = numel (obj, varargin)
+      n = 1;
+    endfunction
+
+    ## The variable being indexed is not known here
+    function idx = end (obj, k, n)
+      error ("matfile73: 'end' is not supported in indices of variables, use the sizes returned by whos");
+    endfunction
+
+    function varargout = subsref (obj, s)
+      if (strcmp (s(1).type, ".")
+          && any (strcmp (s(1).subs, {obj.info.name})))
+        name = s(1).subs;
+        info = obj.info(strcmp ({obj.info.name}, name));
+
+        val = [];
+        if (numel (s) > 1 && strcmp (s(2).type, "()"))
+          [val, subs] = read_slab (obj, info, s(2).subs);
+          if (! isempty (subs))
+            s(2).subs = subs;
+            s(1) = [];
+          endif
+        endif
+
+        if (isempty (s) || strcmp (s(1).type, "."))
+          val = __mat73_read__ (obj.file_id, name);
+          s(1) = [];
+        endif
+
+        if (! isempty (s))
+          val = subsref (val, s);
+        endif
+
+        varargout = {val};
+      else
+        varargout = cell (1, max (nargout, 1));
+        [varargout{:}] = builtin ("subsref", obj, s);
+      endif
+    endfunction
+
+    function obj = subsasgn (obj, s, val)
+      error ("matfile73: variables are read-only");
+    endfunction
+
+  endmethods
+
+  methods (Access = private)
+
+    ## Read the region of a variable indexed by SUBS. The returned SUBS,
+    ## relative to the region that was read, are empty if the variable must be
+    ## read whole.
+    function [val, rsubs] = read_slab (obj, info, subs)
+      val = [];
+      rsubs = {};
+
+      array_classes = {"double", "single", "logical", "int8", "int16", ...
+                       "int32", "int64", "uint8", "uint16", "uint32", "uint64"};
+
+      sz = info.size;
+      nd = numel (sz);
+      ns = numel (subs);
+
+      if (! any (strcmp (info.class, array_classes)) || info.sparse
+          || any (sz == 0) || ns == 0)
+        return;
+      endif
+
+      ## Linear indexing is only handled for vectors, along their non-singleton
+      ## dimension
+      dim_map = 1:min (ns, nd);
+      if (ns == 1 && nd > 1)
+        if (sum (sz != 1) > 1)
+          return;
+        endif
+        dim_map = max ([find(sz != 1, 1), 1]);
+      elseif (ns < nd)
+        return;
+      endif
+
+      start = ones (1, nd);
+      count = sz;
+      stride = ones (1, nd);
+      rsubs = subs;
+
+      for ii = 1:numel (dim_map)
+        kk = dim_map(ii);
+        idx = subs{ii};
+
+        if (ischar (idx) && strcmp (idx, ":"))
+          continue;
+        elseif (islogical (idx))
+          if (numel (idx) > sz(kk))
+            error ("matfile73: index (%d): out of bound %d", numel (idx), sz(kk));
+          endif
+          idx = find (idx);
+        elseif (! isnumeric (idx))
+          rsubs = {};
+          return;
+        endif
+
+        idx = double (idx);
+        if (any (idx(:) < 1) || any (idx(:) != fix (idx(:))))
+          error ("matfile73: subscripts must be either integers 1 to (2^63)-1 or logicals");
+        elseif (any (idx(:) > sz(kk)))
+          error ("matfile73: index (%d): out of bound %d", max (idx(:)), sz(kk));
+        endif
+
+        if (isempty (idx))
+          count(kk) = 1;
+          rsubs{ii} = idx;
+          continue;
+        endif
+
+        lo = min (idx(:));
+        hi = max (idx(:));
+        step = diff (idx(:));
+
+        if (numel (idx) > 1 && all (step == step(1)) && step(1) > 0)
+          ## Evenly spaced indices are exactly selected
+          start(kk) = lo;
+          count(kk) = numel (idx);
+          stride(kk) = step(1);
+          rsubs{ii} = reshape (1:numel (idx), size (idx));
+        else
+          start(kk) = lo;
+          count(kk) = hi - lo + 1;
+          rsubs{ii} = idx - lo + 1;
+        endif
+      endfor
+
+      val = __mat73_read_slab__ (obj.file_id, info.name, start, count, stride);
+    endfunction
+
+  endmethods
+
+endclassdef
+
+%!test
+%! m = matfile73 ('base_types_mat73.mat');
+%! v73 = read_mat73 ('base_types_mat73.mat');
+%! assert (any (strcmp (who (m), 'ndim_double')))
+%! assert (m.ndim_double, v73.ndim_double)
+%! assert (m.ndim_double(1,2,:), v73.ndim_double(1,2,:))
+%! assert (m.ndim_double(1,[2 1],[3 1]), v73.ndim_double(1,[2 1],[3 1]))
+%! assert (m.ndim_int16(:,:,2:3), v73.ndim_int16(:,:,2:3))
+%! assert (m.ndim_logical(1,1,[true false true]), v73.ndim_logical(1,1,[true false true]))
+%! assert (m.cplx_ndim_double(1:2,3,[4 2]), v73.cplx_ndim_double(1:2,3,[4 2]))
+%! assert (m.char_matrix(2,3:5), v73.char_matrix(2,3:5))
+%! assert (m.char_vector(2:4), v73.char_vector(2:4))
+%! assert (m.cell_any(2), v73.cell_any(2))
+%! assert (m.scalar_struct.field1, v73.scalar_struct.field1)
+
+%!test
+%! ## Characters outside the BMP span two UTF-16 code units
+%! fname = [tempname() ".mat"];
+%! unwind_protect
+%!   s = char ([97 195 169 240 157 132 158 98]);
+%!   write_mat73 (fname, s);
+%!   m = matfile73 (fname);
+%!   assert (m.s, s)
+%!   assert (m.s(2:7), s(2:7))
+%!   assert (m.s(1,[8 1]), s([8 1]))
+%!   clear m
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+%!error <out of bound> m = matfile73 ('base_types_mat73.mat'); m.ndim_double(1,3,1)
+
+%!error <'end' is not supported> m = matfile73 ('base_types_mat73.mat'); m.ndim_double(end,1,1)
+
+%!error <FNAME must be a valid file name> matfile73 ('__some_non_existing_file__')
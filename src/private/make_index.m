@@ -24,7 +24,8 @@ function make_index (basedir)
   dirs = {"H5A", "H5D", "H5E", "H5F", "H5G", "H5I", "H5L", "H5LT", ...
           "H5ML", "H5O", "H5P", "H5R", "H5S", "H5T"};
 
-  hl_fun = {"h5info", "h5readatt", "read_mat73", "write_mat73"};
+  hl_fun = {"h5info", "h5read", "h5readatt", "h5write", "matfile73", ...
+            "read_mat73", "write_mat73"};
 
   try
     delete (fname);
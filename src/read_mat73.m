@@ -38,317 +38,13 @@ function rdata = read_mat73 (fname, varnames = "__all__")
     error ("read_mat73: FNAME must be a valid file name")
   endif
 
-  ## Disable automatic display of hdf5 library errors
-  H5E.set_auto (false);
-
-  unwind_protect
-    ## Open file
-    try
-      file_id = H5F.open (fname, "H5F_ACC_RDONLY", "H5P_DEFAULT");
-
-    catch
-      error ("read_mat73: unbale to open '%s'.", fname)
-
-      ## Walk the error stack to print the last error from hdf5
-      H5E.walk ("H5E_WALK_UPWARD", @error_walker);
-    end_try_catch
-
-    ## List available variables in file and check the requested ones existvar
-    if (strcmp (varnames, "__all__"))
-      varnames = {};
-    elseif (! iscellstr (varnames))
-      varnames = {varnames};
-    endif
-
-    ## Read variables
-    rdata = read_vars (file_id, varnames);
-
-    if (any (varnames))
-      for ii = 1:numel (varnames)
-        if (! isfield (rdata, (varnames{ii})))
-          error ("read_mat73: can't find variable '%s' in file '%s'", ...
-                 varnames{ii}, fname)
-        endif
-      endfor
-    endif
-
-  unwind_protect_cleanup
-    H5F.close (file_id);
-
-    ## Restore previous error printing
-    H5E.set_auto (true);
-
-  end_unwind_protect
-endfunction
-
-
-function status = error_walker (n, s)
-  disp (s.desc)
-  status = -1;
-endfunction
-
-function rdata = read_vars (obj_id, varnames, as_dset = false)
-
-  if (isempty (varnames))
-    ## Read every variable
-    varnames = get_named_variables (obj_id);
+  if (strcmp (varnames, "__all__"))
+    varnames = {};
+  elseif (! iscellstr (varnames))
+    varnames = {varnames};
   endif
 
-  rdata = struct ([varnames(:).'; cell(size (varnames(:).'))]{:});
-
-  for ii = 1:numel (varnames)
-
-    name = varnames{ii};
-
-    obj = H5O.open (obj_id, name, "H5P_DEFAULT");
-    unwind_protect
-      if (! as_dset)
-        rdata.(name) = get_object_data (obj);
-      else
-        rdata.(name) = read_dataset (obj);
-      endif
-
-    unwind_protect_cleanup
-      H5O.close (obj);
-    end_unwind_protect
-
-  endfor
-
-endfunction
-
-function vars = get_named_variables (obj_id)
-  [status, ii, vars] = H5L.iterate_by_name (obj_id, "/", "H5_INDEX_NAME", ...
-                                            "H5_ITER_NATIVE", 0, @var_func, ...
-                                            {}, "H5P_DEFAULT");
-endfunction
-
-function [status, data_out] = var_func (obj_id, name, data_in)
-  obj = H5O.open (obj_id, name, "H5P_DEFAULT");
-  cls = var_class (obj);
-
-  data_out = data_in;
-
-  if (! isempty (cls))
-    data_out = [data_out name];
-  endif
-
-  H5O.close (obj);
-
-  status = 0;
-endfunction
-
-function val = read_dataset (obj_id)
-
-  type_id = H5D.get_type (obj_id);
-  dtype = H5LT.dtype_to_struct (type_id);
-  H5T.close (type_id);
-
-  val = H5D.read(obj_id, "H5ML_DEFAULT", "H5S_ALL", ...
-                 "H5S_ALL", "H5P_DEFAULT");
-
-  if (strcmp (dtype.Class, "H5T_REFERENCE"))
-    refs = val;
-    tmp = {};
-    for jj = 1:numel (refs)
-
-      obj_id = H5R.dereference (obj_id, "H5R_OBJECT", refs(jj));
-      try
-        tmp{jj} = get_object_data (obj_id);
-      catch ee
-        H5O.close (obj_id);
-        rethrow (ee)
-      end_try_catch
-
-    endfor
-
-    val = reshape (tmp, size (refs));
-  endif
-endfunction
-
-function tf = is_sparse (id)
-
-  tf = false;
-
-  try
-    attr_id = H5A.open (id, "MATLAB_sparse", "H5P_DEFAULT");
-    tf = true;
-    H5A.close (attr_id)
-  catch
-  end_try_catch
-
-endfunction
-
-function tf = is_empty (id)
-
-  tf = false;
-
-  try
-    attr_id = H5A.open (id, "MATLAB_empty", "H5P_DEFAULT");
-    tf = true;
-    H5A.close (attr_id)
-  catch
-  end_try_catch
-
-endfunction
-
-function cls = var_class (id)
-
-  try
-    attr_id = H5A.open (id, "MATLAB_class", "H5P_DEFAULT");
-    cls = H5A.read (attr_id);
-    H5A.close (attr_id)
-  catch
-    cls = "";
-  end_try_catch
-
-endfunction
-
-function ic = jc2ic (jc)
-  nc = numel (jc) - 1;
-  ic = zeros (jc(end),1);
-
-  for jj = 1:nc
-    ic((jc(jj)+1):(jc(jj+1))) = jj;
-  endfor
-
-endfunction
-
-function val = get_object_data (obj_id)
-
-  empty = is_empty (obj_id);
-
-  cls = var_class (obj_id);
-
-  switch cls
-    case {"int8", "int16", "int32", "int64",...
-          "uint8", "uint16", "uint32", "uint64"}
-
-      val = read_dataset (obj_id);
-
-      if (empty)
-        val = zeros (val, cls);
-      endif
-
-    case {"double", "single"}
-
-      if (! is_sparse (obj_id))
-        val = read_dataset (obj_id);
-
-        ## complex
-        if (isstruct (val) && all (isfield (val, {"real", "imag"})))
-          val = complex (val.real, val.imag);
-        endif
-
-        if (empty)
-          val = zeros (val, cls);
-        endif
-
-      else
-        val = read_vars (obj_id, {"data", "ir", "jc"}, true);
-
-        ## complex
-        if (isstruct (val.data) && all (isfield (val.data, {"real", "imag"})))
-          val.data = complex (val.data.real, val.data.imag);
-        endif
-
-        ## Convert CSR format to row idx
-        val = sparse (val.ir + 1, jc2ic (val.jc), val.data);
-
-      endif
-
-    case "char"
-
-      val = read_dataset (obj_id);
-
-      if (strcmp (class (val), "uint8"))
-        ## ASCII
-        val = char (val);
-      else
-        ## UTF-16
-        type_id = H5D.get_type (obj_id);
-        order = H5T.get_order (type_id);
-        is_le = order == H5ML.get_constant_value ("H5T_ORDER_LE");
-        H5T.close (type_id);
-        tmpval = '';
-        for ii = 1:rows (val)
-          if (is_le)
-            tmp = native2unicode(typecast (val(ii,:), "uint8"), ...
-                                 "utf-16le");
-          else
-            tmp = native2unicode(typecast (val(ii,:), "uint8"), ...
-                                 "utf-16be");
-          endif
-          tmpval = [tmpval; tmp];
-        endfor
-        val = tmpval;
-      endif
-
-      if (empty)
-        val = '';
-      endif
-
-    case "logical"
-
-      val = read_dataset (obj_id);
-
-      if (empty)
-        val = zeros (val, cls);
-      else
-        val = logical (val);
-      endif
-
-    case "struct"
-
-      val = struct ();
-
-      if (! empty)
-        attr_id = H5A.open (obj_id, "MATLAB_fields", "H5P_DEFAULT");
-        fields = H5A.read (attr_id);
-        H5A.close (attr_id)
-
-        try
-          obj = H5O.open (obj_id, fields{1}, "H5P_DEFAULT");
-          cls = var_class (obj);
-          H5O.close (obj);
-        catch
-        end_try_catch
-
-        if (isempty (cls))
-          ## Struct arrays store data in datasets with no named class
-          tmp = read_vars (obj_id, fields, true);
-
-          args = {};
-          for ii = 1:numel (fields)
-            args{end+1} = fields{ii};
-            args{end+1} = tmp.(fields{ii});
-          endfor
-
-          try
-            val = struct (args{:});
-          catch
-            val = tmp;
-          end_try_catch
-        else
-          val = read_vars (obj_id, fields);
-        endif
-      endif
-    case "canonical empty"
-
-      val = read_dataset (obj_id);
-      val = resize ([], val);
-
-    case "cell"
-
-      val = read_dataset (obj_id);
-
-      if (empty)
-        val = resize ({}, val);
-      endif
-
-    otherwise
-      warning ("read_mat73: unhandled class %s, returning data asis", ...
-               cls)
-  endswitch
+  rdata = __read_mat73__ (fname, varnames);
 
 endfunction
 
@@ -537,6 +233,40 @@ endfunction
 %! v73 = read_mat73 ('base_types_mat73.mat', 'sparse_double');
 %! assert (v7.sparse_double, v73.sparse_double)
 
+%!test
+%! fname = [tempname() ".mat"];
+%! unwind_protect
+%!   sc = sparse ([1 3 2 4], [1 1 3 3], [1+2i, -3, 4i, 5], 4, 3);
+%!   sl = sparse ([2 1 3], [1 2 2], true, 3, 4);
+%!   sz = sparse (2, 5);
+%!   write_mat73 (fname, sc, sl, sz);
+%!   v73 = read_mat73 (fname);
+%!   assert (v73.sc, sc)
+%!   assert (issparse (v73.sl) && islogical (v73.sl))
+%!   assert (v73.sl, sl)
+%!   assert (issparse (v73.sz))
+%!   assert (v73.sz, sz)
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+%!test
+%! ## Column pointers must not decrease
+%! fname = [tempname() ".mat"];
+%! unwind_protect
+%!   s = sparse ([1 2 3], [1 2 3], [1 2 3]);
+%!   write_mat73 (fname, s);
+%!   fid = H5F.open (fname, 'H5F_ACC_RDWR', 'H5P_DEFAULT');
+%!   dset = H5D.open (fid, '/s/jc');
+%!   H5D.write (dset, 'H5ML_DEFAULT', 'H5S_ALL', 'H5S_ALL', 'H5P_DEFAULT',
+%!              uint64 ([0 2 1 3]));
+%!   H5D.close (dset);
+%!   H5F.close (fid);
+%!   fail ("read_mat73 (fname)", "inconsistent sparse data");
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
 %!test
 %! v7 = load ('base_types_mat7.mat', 'cplx_scalar_double');
 %! v73 = read_mat73 ('base_types_mat73.mat', 'cplx_scalar_double');
@@ -0,0 +1,1257 @@
+/*
+
+Copyright (C) 2025 Pantxo Diribarne
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#include "h5_chunk_util.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#include <zlib.h>
+
+#if ! defined (_WIN32)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+int
+get_num_threads (void)
+{
+  const char *env = std::getenv ("OCT_HDF5_NUM_THREADS");
+
+  if (env)
+    {
+      int nthreads = std::atoi (env);
+
+      if (nthreads > 0)
+        return nthreads;
+    }
+
+  return std::max (1u, std::thread::hardware_concurrency ());
+}
+
+task_pool::task_pool (int nthreads, size_t max_queued)
+  : m_max_queued (std::max<size_t> (max_queued, 1)), m_active (0),
+    m_stop (false)
+{
+  for (int ii = 0; ii < nthreads; ii++)
+    m_threads.emplace_back (&task_pool::worker, this);
+}
+
+task_pool::~task_pool (void)
+{
+  {
+    std::lock_guard<std::mutex> lock (m_mutex);
+    m_stop = true;
+  }
+
+  m_task_cv.notify_all ();
+
+  for (auto& thread : m_threads)
+    thread.join ();
+}
+
+void
+task_pool::submit (std::function<void (void)> task)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+
+  m_space_cv.wait (lock, [this] { return m_tasks.size () < m_max_queued; });
+
+  m_tasks.push_back (std::move (task));
+
+  lock.unlock ();
+  m_task_cv.notify_one ();
+}
+
+void
+task_pool::wait (void)
+{
+  std::unique_lock<std::mutex> lock (m_mutex);
+
+  m_done_cv.wait (lock, [this] { return m_tasks.empty () && m_active == 0; });
+}
+
+void
+task_pool::worker (void)
+{
+  while (true)
+    {
+      std::function<void (void)> task;
+
+      {
+        std::unique_lock<std::mutex> lock (m_mutex);
+
+        m_task_cv.wait (lock, [this] { return m_stop || ! m_tasks.empty (); });
+
+        if (m_tasks.empty ())
+          return;
+
+        task = std::move (m_tasks.front ());
+        m_tasks.pop_front ();
+        m_active++;
+      }
+
+      m_space_cv.notify_one ();
+
+      task ();
+
+      {
+        std::lock_guard<std::mutex> lock (m_mutex);
+        m_active--;
+      }
+
+      m_done_cv.notify_all ();
+    }
+}
+
+// Selections
+
+// Copy the intersection of a chunk, at CHUNK_START with dimensions
+// CHUNK_DIMS, with the selected block, at BLOCK_START with dimensions
+// BLOCK_DIMS, from SRC to DST.  If TO_CHUNK is true, SRC holds the block
+// and DST the chunk, otherwise SRC holds the chunk and DST the block.
+static void
+copy_chunk (const unsigned char *src, unsigned char *dst,
+            const std::vector<hsize_t>& chunk_start,
+            const std::vector<hsize_t>& chunk_dims,
+            const std::vector<hsize_t>& block_start,
+            const std::vector<hsize_t>& block_dims, size_t elem_size,
+            bool to_chunk)
+{
+  int rank = chunk_dims.size ();
+
+  std::vector<hsize_t> lo (rank);
+  std::vector<hsize_t> hi (rank);
+
+  for (int ii = 0; ii < rank; ii++)
+    {
+      lo[ii] = std::max (chunk_start[ii], block_start[ii]);
+      hi[ii] = std::min (chunk_start[ii] + chunk_dims[ii],
+                         block_start[ii] + block_dims[ii]);
+
+      if (lo[ii] >= hi[ii])
+        return;
+    }
+
+  // Row major strides, in elements
+  std::vector<size_t> chunk_strides (rank, 1);
+  std::vector<size_t> block_strides (rank, 1);
+
+  for (int ii = rank - 2; ii >= 0; ii--)
+    {
+      chunk_strides[ii] = chunk_strides[ii+1] * chunk_dims[ii+1];
+      block_strides[ii] = block_strides[ii+1] * block_dims[ii+1];
+    }
+
+  // Copy contiguous runs along the fastest varying dimension
+  size_t run = (hi[rank-1] - lo[rank-1]) * elem_size;
+  std::vector<hsize_t> idx (lo);
+
+  while (true)
+    {
+      size_t chunk_offset = 0;
+      size_t block_offset = 0;
+
+      for (int ii = 0; ii < rank; ii++)
+        {
+          chunk_offset += (idx[ii] - chunk_start[ii]) * chunk_strides[ii];
+          block_offset += (idx[ii] - block_start[ii]) * block_strides[ii];
+        }
+
+      if (to_chunk)
+        std::memcpy (dst + chunk_offset * elem_size,
+                     src + block_offset * elem_size, run);
+      else
+        std::memcpy (dst + block_offset * elem_size,
+                     src + chunk_offset * elem_size, run);
+
+      int dim = rank - 2;
+      for (; dim >= 0; dim--)
+        {
+          if (++idx[dim] < hi[dim])
+            break;
+
+          idx[dim] = lo[dim];
+        }
+
+      if (dim < 0)
+        break;
+    }
+}
+
+// Retrieve the block of elements selected in FILE_SPACE_ID, if the
+// selection is a single contiguous block
+static bool
+get_selected_block (hid_t dataset_id, hid_t file_space_id,
+                    std::vector<hsize_t>& start, std::vector<hsize_t>& dims)
+{
+  hid_t space_id = file_space_id;
+
+  if (file_space_id == H5S_ALL)
+    space_id = H5Dget_space (dataset_id);
+
+  bool ok = false;
+  int rank = H5Sget_simple_extent_ndims (space_id);
+
+  if (rank > 0 && H5Sget_simple_extent_type (space_id) == H5S_SIMPLE)
+    {
+      start.resize (rank);
+      dims.resize (rank);
+
+      H5S_sel_type sel_type = H5Sget_select_type (space_id);
+
+      if (sel_type == H5S_SEL_ALL)
+        {
+          H5Sget_simple_extent_dims (space_id, dims.data (), nullptr);
+          std::fill (start.begin (), start.end (), 0);
+          ok = true;
+        }
+      else if (sel_type == H5S_SEL_HYPERSLABS
+               && H5Sis_regular_hyperslab (space_id) > 0)
+        {
+          // Adjacent blocks form a single block
+          std::vector<hsize_t> stride (rank);
+          std::vector<hsize_t> count (rank);
+          std::vector<hsize_t> block (rank);
+
+          H5Sget_regular_hyperslab (space_id, start.data (), stride.data (),
+                                    count.data (), block.data ());
+
+          ok = true;
+          for (int ii = 0; ii < rank; ii++)
+            {
+              dims[ii] = count[ii] * block[ii];
+              ok = ok && (count[ii] == 1 || stride[ii] == block[ii]);
+            }
+        }
+      else if (sel_type == H5S_SEL_HYPERSLABS
+               && H5Sget_select_hyper_nblocks (space_id) == 1)
+        {
+          std::vector<hsize_t> end (rank);
+          H5Sget_select_bounds (space_id, start.data (), end.data ());
+
+          for (int ii = 0; ii < rank; ii++)
+            dims[ii] = end[ii] - start[ii] + 1;
+
+          ok = true;
+        }
+    }
+
+  if (space_id != file_space_id)
+    H5Sclose (space_id);
+
+  return ok;
+}
+
+// Check that the memory dataspace receives the selected block as is
+static bool
+mem_space_matches_block (hid_t mem_space_id, hid_t file_space_id,
+                         const std::vector<hsize_t>& dims)
+{
+  // With H5S_ALL, the memory dataspace is the file dataspace
+  if (mem_space_id == H5S_ALL)
+    return (file_space_id == H5S_ALL
+            || H5Sget_select_type (file_space_id) == H5S_SEL_ALL);
+
+  if (H5Sget_select_type (mem_space_id) != H5S_SEL_ALL)
+    return false;
+
+  int rank = H5Sget_simple_extent_ndims (mem_space_id);
+
+  if (rank != static_cast<int> (dims.size ()))
+    return false;
+
+  std::vector<hsize_t> mem_dims (rank);
+  H5Sget_simple_extent_dims (mem_space_id, mem_dims.data (), nullptr);
+
+  return mem_dims == dims;
+}
+
+#if H5_VERSION_GE(1, 10, 5)
+
+// Filter pipeline
+
+// Same algorithm as H5_checksum_fletcher32 in the HDF5 library
+static uint32_t
+checksum_fletcher32 (const unsigned char *data, size_t nbytes)
+{
+  size_t len = nbytes / 2;
+  uint32_t sum1 = 0;
+  uint32_t sum2 = 0;
+
+  while (len)
+    {
+      size_t tlen = std::min<size_t> (len, 360);
+      len -= tlen;
+
+      do
+        {
+          sum1 += static_cast<uint32_t> ((data[0] << 8) | data[1]);
+          data += 2;
+          sum2 += sum1;
+        }
+      while (--tlen);
+
+      sum1 = (sum1 & 0xffff) + (sum1 >> 16);
+      sum2 = (sum2 & 0xffff) + (sum2 >> 16);
+    }
+
+  if (nbytes % 2)
+    {
+      sum1 += static_cast<uint32_t> (data[0] << 8);
+      sum2 += sum1;
+      sum1 = (sum1 & 0xffff) + (sum1 >> 16);
+      sum2 = (sum2 & 0xffff) + (sum2 >> 16);
+    }
+
+  sum1 = (sum1 & 0xffff) + (sum1 >> 16);
+  sum2 = (sum2 & 0xffff) + (sum2 >> 16);
+
+  return (sum2 << 16) | sum1;
+}
+
+static bool
+verify_fletcher32 (std::vector<unsigned char>& data)
+{
+  if (data.size () < 4)
+    return false;
+
+  size_t nbytes = data.size () - 4;
+  const unsigned char *src = data.data () + nbytes;
+
+  // The checksum is stored little endian
+  uint32_t stored = (static_cast<uint32_t> (src[0])
+                     | (static_cast<uint32_t> (src[1]) << 8)
+                     | (static_cast<uint32_t> (src[2]) << 16)
+                     | (static_cast<uint32_t> (src[3]) << 24));
+
+  uint32_t fletcher = checksum_fletcher32 (data.data (), nbytes);
+
+  // Files written by HDF5 1.6 store the bytes of each half swapped
+  uint32_t reversed = (((fletcher & 0x00ff00ff) << 8)
+                       | ((fletcher & 0xff00ff00) >> 8));
+
+  if (stored != fletcher && stored != reversed)
+    return false;
+
+  data.resize (nbytes);
+
+  return true;
+}
+
+static bool
+inflate_chunk (std::vector<unsigned char>& data, size_t max_nbytes)
+{
+  std::vector<unsigned char> out (max_nbytes);
+  uLongf len = max_nbytes;
+
+  if (uncompress (out.data (), &len, data.data (), data.size ()) != Z_OK)
+    return false;
+
+  out.resize (len);
+  data.swap (out);
+
+  return true;
+}
+
+static void
+unshuffle_chunk (std::vector<unsigned char>& data, size_t elem_size)
+{
+  size_t nel = data.size () / elem_size;
+
+  if (elem_size < 2 || nel < 2)
+    return;
+
+  std::vector<unsigned char> out (data.size ());
+
+  for (size_t jj = 0; jj < elem_size; jj++)
+    {
+      const unsigned char *src = data.data () + jj * nel;
+
+      for (size_t ii = 0; ii < nel; ii++)
+        out[ii * elem_size + jj] = src[ii];
+    }
+
+  // Trailing bytes that do not form a full element are not shuffled
+  std::copy (data.begin () + nel * elem_size, data.end (),
+             out.begin () + nel * elem_size);
+
+  data.swap (out);
+}
+
+static void
+shuffle_chunk (std::vector<unsigned char>& data, size_t elem_size)
+{
+  size_t nel = data.size () / elem_size;
+
+  if (elem_size < 2 || nel < 2)
+    return;
+
+  std::vector<unsigned char> out (data.size ());
+
+  for (size_t jj = 0; jj < elem_size; jj++)
+    {
+      unsigned char *dst = out.data () + jj * nel;
+
+      for (size_t ii = 0; ii < nel; ii++)
+        dst[ii] = data[ii * elem_size + jj];
+    }
+
+  std::copy (data.begin () + nel * elem_size, data.end (),
+             out.begin () + nel * elem_size);
+
+  data.swap (out);
+}
+
+static bool
+deflate_chunk (std::vector<unsigned char>& data, int level)
+{
+  uLongf len = compressBound (data.size ());
+  std::vector<unsigned char> out (len);
+
+  if (compress2 (out.data (), &len, data.data (), data.size (), level)
+      != Z_OK)
+    return false;
+
+  out.resize (len);
+  data.swap (out);
+
+  return true;
+}
+
+static void
+append_fletcher32 (std::vector<unsigned char>& data)
+{
+  uint32_t fletcher = checksum_fletcher32 (data.data (), data.size ());
+
+  for (int ii = 0; ii < 4; ii++)
+    data.push_back ((fletcher >> (8 * ii)) & 0xff);
+}
+
+// Undo the filters of the pipeline, in reverse order, skipping those
+// flagged in FILTER_MASK
+static bool
+decode_chunk (std::vector<unsigned char>& data,
+              const std::vector<H5Z_filter_t>& filters, unsigned filter_mask,
+              size_t elem_size, size_t chunk_nbytes)
+{
+  for (size_t ii = filters.size (); ii-- > 0; )
+    {
+      if (filter_mask & (1u << ii))
+        continue;
+
+      switch (filters[ii])
+        {
+        case H5Z_FILTER_FLETCHER32:
+          if (! verify_fletcher32 (data))
+            return false;
+          break;
+
+        case H5Z_FILTER_DEFLATE:
+          // Leave room for checksums applied before compression
+          if (! inflate_chunk (data, chunk_nbytes + 4 * filters.size ()))
+            return false;
+          break;
+
+        case H5Z_FILTER_SHUFFLE:
+          unshuffle_chunk (data, elem_size);
+          break;
+
+        default:
+          return false;
+        }
+    }
+
+  return data.size () == chunk_nbytes;
+}
+
+// Storage layout of a chunked dataset and of the selected block
+struct chunk_layout
+{
+  std::vector<H5Z_filter_t> filters;
+  int deflate_level = 6;
+  size_t elem_size = 0;
+  std::vector<hsize_t> dims;
+  std::vector<hsize_t> chunk_dims;
+  std::vector<hsize_t> block_start;
+  std::vector<hsize_t> block_dims;
+
+  // User defined fill value, in the dataset type, empty for zeros
+  std::vector<unsigned char> fill;
+
+  size_t chunk_nbytes (void) const
+  {
+    size_t nbytes = elem_size;
+    for (auto dim : chunk_dims)
+      nbytes *= dim;
+    return nbytes;
+  }
+
+  // Allocate the chunk at ORIGIN in DATA.  Chunks crossing the dataset edge
+  // are padded with the fill value, as HDF5 does.
+  void init_chunk (std::vector<unsigned char>& data,
+                   const std::vector<hsize_t>& origin) const
+  {
+    size_t nbytes = chunk_nbytes ();
+
+    bool crosses_edge = false;
+    for (size_t ii = 0; ii < dims.size (); ii++)
+      crosses_edge = crosses_edge || origin[ii] + chunk_dims[ii] > dims[ii];
+
+    if (fill.empty () || ! crosses_edge)
+      data.assign (nbytes, 0);
+    else
+      {
+        data.resize (nbytes);
+        for (size_t ii = 0; ii < nbytes; ii += elem_size)
+          std::memcpy (data.data () + ii, fill.data (), elem_size);
+      }
+  }
+};
+
+// Fill LAYOUT if DATASET_ID is chunked with a pipeline we know how to apply,
+// MEM_TYPE_ID is the dataset type and the selection is a contiguous block
+// stored as is in memory.
+static bool
+get_chunk_layout (hid_t dataset_id, hid_t mem_type_id, hid_t mem_space_id,
+                  hid_t file_space_id, chunk_layout& layout)
+{
+  hid_t dcpl_id = H5Dget_create_plist (dataset_id);
+
+  if (dcpl_id < 0)
+    return false;
+
+  bool ok = (H5Pget_layout (dcpl_id) == H5D_CHUNKED);
+
+  int nfilters = ok ? H5Pget_nfilters (dcpl_id) : 0;
+
+  for (int ii = 0; ok && ii < nfilters; ii++)
+    {
+      unsigned int flags;
+      unsigned int cd_values[1] = {6};
+      size_t cd_nelmts = 1;
+      unsigned int filter_config;
+
+      H5Z_filter_t filter = H5Pget_filter2 (dcpl_id, ii, &flags, &cd_nelmts,
+                                            cd_values, 0, nullptr,
+                                            &filter_config);
+
+      if (filter == H5Z_FILTER_DEFLATE)
+        layout.deflate_level = cd_values[0];
+
+      if (filter == H5Z_FILTER_DEFLATE || filter == H5Z_FILTER_SHUFFLE
+          || filter == H5Z_FILTER_FLETCHER32)
+        layout.filters.push_back (filter);
+      else
+        ok = false;
+    }
+
+  // Nothing to (de)compress
+  if (layout.filters.empty ())
+    ok = false;
+
+  if (ok)
+    {
+      hid_t space_id = H5Dget_space (dataset_id);
+      int rank = H5Sget_simple_extent_ndims (space_id);
+
+      if (rank > 0)
+        {
+          layout.dims.resize (rank);
+          layout.chunk_dims.resize (rank);
+          H5Sget_simple_extent_dims (space_id, layout.dims.data (), nullptr);
+        }
+
+      H5Sclose (space_id);
+
+      ok = (rank > 0 && H5Pget_chunk (dcpl_id, rank,
+                                      layout.chunk_dims.data ()) == rank);
+
+      H5D_fill_value_t fill_status;
+      if (ok && H5Pfill_value_defined (dcpl_id, &fill_status) >= 0
+          && fill_status == H5D_FILL_VALUE_USER_DEFINED)
+        {
+          hid_t type_id = H5Dget_type (dataset_id);
+          layout.fill.resize (H5Tget_size (type_id));
+          ok = (H5Pget_fill_value (dcpl_id, type_id,
+                                   layout.fill.data ()) >= 0);
+          H5Tclose (type_id);
+        }
+    }
+
+  H5Pclose (dcpl_id);
+
+  if (! ok)
+    return false;
+
+  // Data are copied as is between memory and chunks
+  hid_t type_id = H5Dget_type (dataset_id);
+  ok = (H5Tequal (type_id, mem_type_id) > 0
+        && H5Tdetect_class (type_id, H5T_VLEN) == 0
+        && H5Tdetect_class (type_id, H5T_STRING) == 0);
+  layout.elem_size = H5Tget_size (type_id);
+  H5Tclose (type_id);
+
+  if (! ok || ! get_selected_block (dataset_id, file_space_id,
+                                    layout.block_start, layout.block_dims)
+      || ! mem_space_matches_block (mem_space_id, file_space_id,
+                                    layout.block_dims))
+    return false;
+
+  for (auto dim : layout.block_dims)
+    if (dim == 0)
+      return false;
+
+  return true;
+}
+
+// Origins of the chunks intersecting the selected block, in storage order
+static std::vector<std::vector<hsize_t>>
+get_chunk_origins (const chunk_layout& layout)
+{
+  int rank = layout.chunk_dims.size ();
+
+  std::vector<hsize_t> first (rank);
+  std::vector<hsize_t> last (rank);
+
+  for (int ii = 0; ii < rank; ii++)
+    {
+      hsize_t cdim = layout.chunk_dims[ii];
+
+      first[ii] = layout.block_start[ii] / cdim * cdim;
+      last[ii] = ((layout.block_start[ii] + layout.block_dims[ii] - 1)
+                  / cdim * cdim);
+    }
+
+  std::vector<std::vector<hsize_t>> origins;
+  std::vector<hsize_t> coord (first);
+
+  while (true)
+    {
+      origins.push_back (coord);
+
+      int dim = rank - 1;
+      for (; dim >= 0; dim--)
+        {
+          coord[dim] += layout.chunk_dims[dim];
+
+          if (coord[dim] <= last[dim])
+            break;
+
+          coord[dim] = first[dim];
+        }
+
+      if (dim < 0)
+        break;
+    }
+
+  return origins;
+}
+
+// Apply the filter pipeline, in order, to a full chunk
+static bool
+encode_chunk (std::vector<unsigned char>& data, const chunk_layout& layout)
+{
+  for (auto filter : layout.filters)
+    {
+      switch (filter)
+        {
+        case H5Z_FILTER_SHUFFLE:
+          shuffle_chunk (data, layout.elem_size);
+          break;
+
+        case H5Z_FILTER_DEFLATE:
+          if (! deflate_chunk (data, layout.deflate_level))
+            return false;
+          break;
+
+        case H5Z_FILTER_FLETCHER32:
+          append_fletcher32 (data);
+          break;
+
+        default:
+          return false;
+        }
+    }
+
+  return true;
+}
+
+#endif
+
+bool
+read_chunks_parallel (hid_t dataset_id, hid_t mem_type_id,
+                      hid_t mem_space_id, hid_t file_space_id,
+                      hid_t xfer_plist_id, void *buf)
+{
+#if H5_VERSION_GE(1, 10, 5)
+  int nthreads = get_num_threads ();
+
+  if (nthreads < 2)
+    return false;
+
+  chunk_layout layout;
+
+  if (! get_chunk_layout (dataset_id, mem_type_id, mem_space_id,
+                          file_space_id, layout))
+    return false;
+
+  // Make sure all chunks are allocated, otherwise let HDF5 handle fill
+  // values.
+  struct chunk_info
+  {
+    std::vector<hsize_t> start;
+    unsigned filter_mask;
+    hsize_t nbytes;
+  };
+
+  std::vector<chunk_info> chunks;
+
+  for (const auto& origin : get_chunk_origins (layout))
+    {
+      chunk_info info;
+      info.start = origin;
+
+      haddr_t addr;
+      if (H5Dget_chunk_info_by_coord (dataset_id, origin.data (),
+                                      &info.filter_mask, &addr,
+                                      &info.nbytes) < 0
+          || addr == HADDR_UNDEF || info.nbytes == 0)
+        return false;
+
+      chunks.push_back (info);
+    }
+
+  // A single chunk is not worth starting worker threads
+  if (chunks.size () < 2)
+    return false;
+
+  nthreads = std::min<size_t> (nthreads, chunks.size ());
+
+  // Raw chunks are read sequentially by this thread, while worker threads
+  // decode them and copy their content to the output buffer.
+  size_t chunk_nbytes = layout.chunk_nbytes ();
+
+  std::atomic<bool> failed (false);
+  unsigned char *out = static_cast<unsigned char *> (buf);
+
+  {
+    task_pool pool (nthreads, 2 * nthreads);
+
+    for (const auto& info : chunks)
+      {
+        if (failed)
+          break;
+
+        auto raw = std::make_shared<std::vector<unsigned char>> (info.nbytes);
+        uint32_t filter_mask = info.filter_mask;
+
+        if (H5Dread_chunk (dataset_id, xfer_plist_id, info.start.data (),
+                           &filter_mask, raw->data ()) < 0)
+          {
+            failed = true;
+            break;
+          }
+
+        const std::vector<hsize_t> *start = &info.start;
+
+        pool.submit ([&, raw, filter_mask, start] (void)
+                     {
+                       if (failed)
+                         return;
+
+                       try
+                         {
+                           if (! decode_chunk (*raw, layout.filters,
+                                               filter_mask, layout.elem_size,
+                                               chunk_nbytes))
+                             failed = true;
+                           else
+                             copy_chunk (raw->data (), out, *start,
+                                         layout.chunk_dims,
+                                         layout.block_start,
+                                         layout.block_dims, layout.elem_size,
+                                         false);
+                         }
+                       catch (const std::bad_alloc&)
+                         {
+                           failed = true;
+                         }
+                     });
+      }
+
+    pool.wait ();
+  }
+
+  return ! failed;
+#else
+  (void) dataset_id;
+  (void) mem_type_id;
+  (void) mem_space_id;
+  (void) file_space_id;
+  (void) xfer_plist_id;
+  (void) buf;
+
+  return false;
+#endif
+}
+
+bool
+write_chunks_parallel (hid_t dataset_id, hid_t mem_type_id,
+                       hid_t mem_space_id, hid_t file_space_id,
+                       hid_t xfer_plist_id, const void *buf, size_t nel)
+{
+#if H5_VERSION_GE(1, 10, 5)
+  int nthreads = get_num_threads ();
+
+  if (nthreads < 2)
+    return false;
+
+  chunk_layout layout;
+
+  if (! get_chunk_layout (dataset_id, mem_type_id, mem_space_id,
+                          file_space_id, layout))
+    return false;
+
+  // Chunks are written as a whole: the selected block must start on a
+  // chunk boundary and end on a chunk boundary or at the dataset edge.
+  size_t block_nel = 1;
+
+  for (size_t ii = 0; ii < layout.dims.size (); ii++)
+    {
+      hsize_t end = layout.block_start[ii] + layout.block_dims[ii];
+
+      if (layout.block_start[ii] % layout.chunk_dims[ii] != 0
+          || (end % layout.chunk_dims[ii] != 0 && end != layout.dims[ii]))
+        return false;
+
+      block_nel *= layout.block_dims[ii];
+    }
+
+  if (block_nel != nel)
+    return false;
+
+  // Worker threads extract and compress chunks, which are written in order
+  // by this thread as soon as they are ready.
+  struct encoded_chunk
+  {
+    std::vector<hsize_t> start;
+    std::vector<unsigned char> data;
+    std::future<bool> done;
+  };
+
+  // A single chunk is not worth starting worker threads
+  std::vector<std::vector<hsize_t>> origins = get_chunk_origins (layout);
+
+  if (origins.size () < 2)
+    return false;
+
+  nthreads = std::min<size_t> (nthreads, origins.size ());
+
+  size_t window = 2 * nthreads;
+  const unsigned char *in = static_cast<const unsigned char *> (buf);
+
+  bool failed = false;
+  std::deque<std::shared_ptr<encoded_chunk>> pending;
+
+  auto write_oldest = [&] (void)
+  {
+    auto chunk = pending.front ();
+    pending.pop_front ();
+
+    bool ok = false;
+    try
+      {
+        ok = chunk->done.get ();
+      }
+    catch (const std::bad_alloc&)
+      {
+        ok = false;
+      }
+
+    if (! ok || failed
+        || H5Dwrite_chunk (dataset_id, xfer_plist_id, 0,
+                           chunk->start.data (), chunk->data.size (),
+                           chunk->data.data ()) < 0)
+      failed = true;
+  };
+
+  {
+    task_pool pool (nthreads, window);
+
+    for (const auto& origin : origins)
+      {
+        auto chunk = std::make_shared<encoded_chunk> ();
+        chunk->start = origin;
+
+        auto task = std::make_shared<std::packaged_task<bool (void)>>
+          ([&layout, chunk, in] (void)
+           {
+             layout.init_chunk (chunk->data, chunk->start);
+             copy_chunk (in, chunk->data.data (), chunk->start,
+                         layout.chunk_dims, layout.block_start,
+                         layout.block_dims, layout.elem_size, true);
+
+             return encode_chunk (chunk->data, layout);
+           });
+
+        chunk->done = task->get_future ();
+        pending.push_back (chunk);
+
+        pool.submit ([task] (void) { (*task) (); });
+
+        if (pending.size () >= window)
+          write_oldest ();
+
+        if (failed)
+          break;
+      }
+
+    while (! pending.empty ())
+      write_oldest ();
+  }
+
+  return ! failed;
+#else
+  (void) dataset_id;
+  (void) mem_type_id;
+  (void) mem_space_id;
+  (void) file_space_id;
+  (void) xfer_plist_id;
+  (void) buf;
+  (void) nel;
+
+  return false;
+#endif
+}
+
+// Pipeline of datasets compressed ahead of their writing
+
+struct chunk_pipeline::impl
+{
+#if H5_VERSION_GE(1, 10, 5)
+  struct dataset_job
+  {
+    chunk_layout layout;
+    const unsigned char *buf;
+    std::vector<std::vector<hsize_t>> origins;
+  };
+
+  struct encoded_chunk
+  {
+    std::vector<unsigned char> data;
+    std::future<bool> done;
+  };
+
+  // Extract and compress the chunk of JOB at ORIGIN into DATA
+  static bool encode (const dataset_job& job,
+                      const std::vector<hsize_t>& origin,
+                      std::vector<unsigned char>& data)
+  {
+    job.layout.init_chunk (data, origin);
+    copy_chunk (job.buf, data.data (), origin, job.layout.chunk_dims,
+                job.layout.block_start, job.layout.block_dims,
+                job.layout.elem_size, true);
+
+    return encode_chunk (data, job.layout);
+  }
+
+  // Submit chunks, following the queue order, until WINDOW are pending
+  void submit (void)
+  {
+    while (pending.size () < window && next_job < jobs.size ())
+      {
+        const dataset_job& job = jobs[next_job];
+
+        if (next_chunk == job.origins.size ())
+          {
+            next_job++;
+            next_chunk = 0;
+            continue;
+          }
+
+        const std::vector<hsize_t>& origin = job.origins[next_chunk++];
+
+        auto chunk = std::make_shared<encoded_chunk> ();
+
+        auto task = std::make_shared<std::packaged_task<bool (void)>>
+          ([&job, &origin, chunk] (void)
+           {
+             return encode (job, origin, chunk->data);
+           });
+
+        chunk->done = task->get_future ();
+        pending.push_back (chunk);
+
+        pool->submit ([task] (void) { (*task) (); });
+      }
+  }
+
+  // Queued datasets, references to which remain valid as the deque grows
+  std::deque<dataset_job> jobs;
+
+  // Next dataset to write, next dataset and chunk to submit
+  size_t next_write = 0;
+  size_t next_job = 0;
+  size_t next_chunk = 0;
+
+  // Submitted chunks, in writing order
+  std::deque<std::shared_ptr<encoded_chunk>> pending;
+
+  size_t window = 0;
+
+  // Declared last to be destroyed first, once workers are done with jobs
+  std::unique_ptr<task_pool> pool;
+#endif
+};
+
+chunk_pipeline::chunk_pipeline (int nthreads)
+  : m_impl (new impl ())
+{
+#if H5_VERSION_GE(1, 10, 5)
+  if (nthreads > 1)
+    {
+      m_impl->window = 2 * nthreads;
+      m_impl->pool.reset (new task_pool (nthreads, m_impl->window));
+    }
+#else
+  (void) nthreads;
+#endif
+}
+
+chunk_pipeline::~chunk_pipeline (void) = default;
+
+void
+chunk_pipeline::add (const void *buf, const std::vector<hsize_t>& dims,
+                     const std::vector<hsize_t>& chunk_dims, size_t elem_size,
+                     bool shuffle, int level)
+{
+#if H5_VERSION_GE(1, 10, 5)
+  impl::dataset_job job;
+
+  if (shuffle)
+    job.layout.filters.push_back (H5Z_FILTER_SHUFFLE);
+
+  job.layout.filters.push_back (H5Z_FILTER_DEFLATE);
+  job.layout.deflate_level = level;
+  job.layout.elem_size = elem_size;
+  job.layout.dims = dims;
+  job.layout.chunk_dims = chunk_dims;
+  job.layout.block_start.assign (dims.size (), 0);
+  job.layout.block_dims = dims;
+  job.buf = static_cast<const unsigned char *> (buf);
+  job.origins = get_chunk_origins (job.layout);
+
+  m_impl->jobs.push_back (std::move (job));
+#else
+  (void) buf;
+  (void) dims;
+  (void) chunk_dims;
+  (void) elem_size;
+  (void) shuffle;
+  (void) level;
+#endif
+}
+
+bool
+chunk_pipeline::write (hid_t dataset_id)
+{
+#if H5_VERSION_GE(1, 10, 5)
+  if (m_impl->next_write >= m_impl->jobs.size ())
+    return false;
+
+  impl::dataset_job& job = m_impl->jobs[m_impl->next_write++];
+
+  // Chunks of the dataset are all consumed, even after a failure, so that
+  // the pending ones keep belonging to the following datasets
+  bool ok = true;
+  std::vector<unsigned char> data;
+
+  for (const auto& origin : job.origins)
+    {
+      bool encoded = false;
+
+      try
+        {
+          if (m_impl->pool)
+            {
+              m_impl->submit ();
+
+              auto chunk = m_impl->pending.front ();
+              m_impl->pending.pop_front ();
+
+              encoded = chunk->done.get ();
+              data.swap (chunk->data);
+            }
+          else
+            encoded = impl::encode (job, origin, data);
+        }
+      catch (const std::bad_alloc&)
+        {
+          encoded = false;
+        }
+
+      if (! ok || ! encoded
+          || H5Dwrite_chunk (dataset_id, H5P_DEFAULT, 0, origin.data (),
+                             data.size (), data.data ()) < 0)
+        ok = false;
+    }
+
+  return ok;
+#else
+  (void) dataset_id;
+
+  return false;
+#endif
+}
+
+// Datasets smaller than this are read with H5Dread
+static const hsize_t min_mapped_nbytes = 1 << 20;
+
+bool
+read_contiguous_mapped (hid_t dataset_id, hid_t mem_type_id,
+                        hid_t mem_space_id, hid_t file_space_id, void *buf)
+{
+#if ! defined (_WIN32)
+  // Contiguous storage, without filters or external files
+  hid_t dcpl_id = H5Dget_create_plist (dataset_id);
+
+  if (dcpl_id < 0)
+    return false;
+
+  bool ok = (H5Pget_layout (dcpl_id) == H5D_CONTIGUOUS
+             && H5Pget_nfilters (dcpl_id) == 0
+             && H5Pget_external_count (dcpl_id) == 0);
+
+  H5Pclose (dcpl_id);
+
+  if (! ok)
+    return false;
+
+  haddr_t addr = H5Dget_offset (dataset_id);
+  hsize_t nbytes = H5Dget_storage_size (dataset_id);
+
+  if (addr == HADDR_UNDEF || nbytes < min_mapped_nbytes)
+    return false;
+
+  // Data are copied as is from the file to memory
+  hid_t type_id = H5Dget_type (dataset_id);
+  ok = (H5Tequal (type_id, mem_type_id) > 0
+        && H5Tdetect_class (type_id, H5T_VLEN) == 0
+        && H5Tdetect_class (type_id, H5T_STRING) == 0);
+  size_t elem_size = H5Tget_size (type_id);
+  H5Tclose (type_id);
+
+  hid_t space_id = H5Dget_space (dataset_id);
+  int rank = H5Sget_simple_extent_ndims (space_id);
+  std::vector<hsize_t> dims (rank > 0 ? rank : 0);
+
+  if (rank > 0)
+    H5Sget_simple_extent_dims (space_id, dims.data (), nullptr);
+
+  H5Sclose (space_id);
+
+  std::vector<hsize_t> block_start;
+  std::vector<hsize_t> block_dims;
+
+  if (! ok || rank <= 0
+      || ! get_selected_block (dataset_id, file_space_id, block_start,
+                               block_dims)
+      || ! mem_space_matches_block (mem_space_id, file_space_id, block_dims))
+    return false;
+
+  hsize_t nel = 1;
+  for (auto dim : dims)
+    nel *= dim;
+
+  if (nel * elem_size != nbytes)
+    return false;
+
+  // Only files opened read-only with the default driver are mapped, so
+  // that HDF5 holds no pending raw data for them
+  hid_t file_id = H5Iget_file_id (dataset_id);
+
+  if (file_id < 0)
+    return false;
+
+  unsigned intent = 0;
+  hid_t fapl_id = H5Fget_access_plist (file_id);
+  void *handle = nullptr;
+
+  ok = (H5Fget_intent (file_id, &intent) >= 0
+        && (intent & H5F_ACC_RDWR) == 0
+        && fapl_id >= 0 && H5Pget_driver (fapl_id) == H5FD_SEC2
+        && H5Fget_vfd_handle (file_id, fapl_id, &handle) >= 0 && handle);
+
+  if (fapl_id >= 0)
+    H5Pclose (fapl_id);
+
+  H5Fclose (file_id);
+
+  if (! ok)
+    return false;
+
+  int fd = *static_cast<int *> (handle);
+
+  // Do not map past the end of a truncated file
+  struct stat st;
+  if (fstat (fd, &st) != 0
+      || static_cast<hsize_t> (st.st_size) < addr + nbytes)
+    return false;
+
+  long page_size = sysconf (_SC_PAGESIZE);
+  haddr_t map_start = addr - addr % (page_size > 0 ? page_size : 1);
+  size_t map_nbytes = nbytes + (addr - map_start);
+
+  void *map = mmap (nullptr, map_nbytes, PROT_READ, MAP_PRIVATE, fd,
+                    static_cast<off_t> (map_start));
+
+  if (map == MAP_FAILED)
+    return false;
+
+  madvise (map, map_nbytes, MADV_SEQUENTIAL);
+
+  const unsigned char *data
+    = static_cast<const unsigned char *> (map) + (addr - map_start);
+
+  if (block_dims == dims)
+    std::memcpy (buf, data, nbytes);
+  else
+    copy_chunk (data, static_cast<unsigned char *> (buf),
+                std::vector<hsize_t> (rank, 0), dims, block_start,
+                block_dims, elem_size, false);
+
+  munmap (map, map_nbytes);
+
+  return true;
+#else
+  (void) dataset_id;
+  (void) mem_type_id;
+  (void) mem_space_id;
+  (void) file_space_id;
+  (void) buf;
+
+  return false;
+#endif
+}
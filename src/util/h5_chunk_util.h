@@ -0,0 +1,148 @@
+/*
+
+Copyright (C) 2025 Pantxo Diribarne
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+*/
+
+#ifndef H5_CHUNK_UTIL_H
+#define H5_CHUNK_UTIL_H
+
+#if defined(__APPLE__) || defined(_WIN32)
+    #include <hdf5.h>
+#else
+    #include <hdf5/serial/hdf5.h>
+#endif
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Number of worker threads used to (de)compress chunks.  It is read from
+// the OCT_HDF5_NUM_THREADS environment variable and defaults to the number
+// of hardware threads.
+int get_num_threads (void);
+
+// Fixed size pool of worker threads processing tasks in submission order.
+// Submission blocks while MAX_QUEUED tasks are waiting so that the memory
+// held by pending tasks stays bounded.
+class task_pool
+{
+public:
+
+  task_pool (int nthreads, size_t max_queued);
+
+  task_pool (const task_pool&) = delete;
+
+  task_pool& operator = (const task_pool&) = delete;
+
+  ~task_pool (void);
+
+  void submit (std::function<void (void)> task);
+
+  // Wait until all submitted tasks are done
+  void wait (void);
+
+private:
+
+  void worker (void);
+
+  std::vector<std::thread> m_threads;
+  std::deque<std::function<void (void)>> m_tasks;
+  std::mutex m_mutex;
+  std::condition_variable m_task_cv;
+  std::condition_variable m_space_cv;
+  std::condition_variable m_done_cv;
+  size_t m_max_queued;
+  size_t m_active;
+  bool m_stop;
+};
+
+// Read the selection FILE_SPACE_ID of a chunked and compressed dataset into
+// BUF, decompressing chunks on a pool of worker threads.  Only deflate,
+// shuffle and fletcher32 filters, memory types identical to the dataset
+// type and selections spanning a single block are handled.  Return false,
+// leaving the caller to use H5Dread, when these conditions are not met or
+// the chunks could not be decoded.
+bool read_chunks_parallel (hid_t dataset_id, hid_t mem_type_id,
+                           hid_t mem_space_id, hid_t file_space_id,
+                           hid_t xfer_plist_id, void *buf);
+
+// Write the NEL elements of BUF to the selection FILE_SPACE_ID of a chunked
+// and compressed dataset, compressing chunks on a pool of worker threads
+// and writing them with H5Dwrite_chunk from the calling thread.  The same
+// filters as read_chunks_parallel are handled and the selection must cover
+// whole chunks.  Return false, leaving the caller to use H5Dwrite, when these
+// conditions are not met or a chunk could not be written.
+bool write_chunks_parallel (hid_t dataset_id, hid_t mem_type_id,
+                            hid_t mem_space_id, hid_t file_space_id,
+                            hid_t xfer_plist_id, const void *buf,
+                            size_t nel);
+
+// Compression of the chunks of several datasets on a pool of worker threads,
+// ahead of their writing.  Whole datasets are queued with add, in the order
+// in which they will be written and possibly before they are created.  They
+// are then written with write, in the same order, from the calling thread,
+// while the chunks of the following datasets are being compressed.  With a
+// single thread, chunks are compressed by write: the chunks and the order
+// in which they are written, thus the resulting files, are identical.
+class chunk_pipeline
+{
+public:
+
+  chunk_pipeline (int nthreads);
+
+  chunk_pipeline (const chunk_pipeline&) = delete;
+
+  chunk_pipeline& operator = (const chunk_pipeline&) = delete;
+
+  ~chunk_pipeline (void);
+
+  // Queue the data BUF of a dataset with dimensions DIMS, stored in chunks
+  // with dimensions CHUNK_DIMS of ELEM_SIZE bytes elements, shuffled if
+  // SHUFFLE is true and deflated at compression LEVEL.  BUF must remain
+  // valid until the dataset is written.
+  void add (const void *buf, const std::vector<hsize_t>& dims,
+            const std::vector<hsize_t>& chunk_dims, size_t elem_size,
+            bool shuffle, int level);
+
+  // Write the chunks of the next queued dataset to DATASET_ID, created with
+  // the same layout and filters, with H5Dwrite_chunk.  Return false, leaving
+  // the caller to use H5Dwrite, if they could not all be written.
+  bool write (hid_t dataset_id);
+
+private:
+
+  struct impl;
+
+  std::unique_ptr<impl> m_impl;
+};
+
+// Read the selection FILE_SPACE_ID of a large contiguous dataset into BUF
+// by mapping its raw data in memory, bypassing the HDF5 sieve buffer.  Only
+// datasets without filters, stored in files opened read-only with the
+// default (sec2) driver, whose type is identical to the memory type and
+// selections spanning a single block are handled.  Return false, leaving
+// the caller to use H5Dread, when these conditions are not met.
+bool read_contiguous_mapped (hid_t dataset_id, hid_t mem_type_id,
+                             hid_t mem_space_id, hid_t file_space_id,
+                             void *buf);
+
+#endif
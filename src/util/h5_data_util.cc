@@ -18,108 +18,996 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
 #include "h5_data_util.h"
+#include "h5_chunk_util.h"
+#include "h5_oct_util.h"
+
+#include <octave/ov-re-mat.h>
+#include <octave/ov-flt-re-mat.h>
+#include <octave/ov-int8.h>
+#include <octave/ov-int16.h>
+#include <octave/ov-int32.h>
+#include <octave/ov-int64.h>
+#include <octave/ov-uint8.h>
+#include <octave/ov-uint16.h>
+#include <octave/ov-uint32.h>
+#include <octave/ov-uint64.h>
+
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Attributes are read and written by the H5A functions, datasets by all
+// other callers
+static bool
+is_attribute_caller (const std::string& caller)
+{
+  return caller.compare (0, 4, "H5A.") == 0;
+}
 
-octave_value
-__h5_read__ (const std::string& caller, dim_vector dv, hid_t object_id,
-             hid_t mem_type_id, hid_t mem_space_id,
-             hid_t file_space_id, hid_t xfer_plist_id,
-             hid_t field_type_id)
+// Type descriptor cache
+
+hid_t
+h5_type_desc::native_type (void) const
 {
-  octave_value retval;
+  if (native_encoding.empty ())
+    return -1;
 
-  // Decide which hdf5 function to call based on caller name
-  int read_fcn;
+  return H5Tdecode (native_encoding.data ());
+}
 
-  if (caller == "H5D.read")
-    read_fcn = 0;
-  else // H5A.read
-    read_fcn = 1;
+static h5_type_desc::kind_type
+get_type_kind (H5T_class_t cls, size_t sz, H5T_sign_t sign, hid_t type_id)
+{
+  bool is_signed = (sign == H5T_SGN_2);
 
-  // Get type info
-  octave_scalar_map info_struct;
+  switch (cls)
+    {
+    case H5T_INTEGER:
+    case H5T_BITFIELD:
+      if (sz == 1)
+        return is_signed ? h5_type_desc::INT8 : h5_type_desc::UINT8;
+      else if (sz == 2)
+        return is_signed ? h5_type_desc::INT16 : h5_type_desc::UINT16;
+      else if (sz == 4)
+        return is_signed ? h5_type_desc::INT32 : h5_type_desc::UINT32;
+      else if (sz == 8)
+        return is_signed ? h5_type_desc::INT64 : h5_type_desc::UINT64;
+      break;
+
+    case H5T_FLOAT:
+      if (sz == sizeof (float))
+        return h5_type_desc::FLOAT;
+      else if (sz == sizeof (double))
+        return h5_type_desc::DOUBLE;
+      break;
+
+    case H5T_REFERENCE:
+      if (sz == sizeof (hobj_ref_t))
+        return h5_type_desc::REFERENCE;
+      break;
+
+    case H5T_STRING:
+      if (H5Tis_variable_str (type_id) > 0)
+        return h5_type_desc::VLSTRING;
+      else
+        return h5_type_desc::STRING;
 
-  if (field_type_id != H5_INDEX_UNKNOWN)
+    case H5T_COMPOUND:
+      return h5_type_desc::COMPOUND;
+
+    case H5T_VLEN:
+      return h5_type_desc::VLEN;
+
+    case H5T_ARRAY:
+      return h5_type_desc::ARRAY;
+
+    default:
+      break;
+    }
+
+  return h5_type_desc::UNSUPPORTED;
+}
+
+static std::shared_ptr<const h5_type_desc>
+make_type_desc (hid_t type_id)
+{
+  auto desc = std::make_shared<h5_type_desc> ();
+
+  desc->cls = H5Tget_class (type_id);
+  desc->order = H5Tget_order (type_id);
+
+  // Compound members are packed in memory
+  hid_t native_id = H5Tget_native_type (type_id, H5T_DIR_DEFAULT);
+
+  if (native_id < 0)
+    native_id = H5Tcopy (type_id);
+  else if (desc->cls == H5T_COMPOUND)
+    H5Tpack (native_id);
+
+  h5_id_closer native_closer (native_id, H5Tclose);
+
+  size_t nalloc = 0;
+  if (H5Tencode (native_id, nullptr, &nalloc) >= 0 && nalloc > 0)
     {
-      if (! dtype_to_struct (field_type_id, info_struct))
-        error ("%s: unable to determine type", caller.c_str ());
+      desc->native_encoding.assign (nalloc, '\0');
+      if (H5Tencode (native_id, &desc->native_encoding[0], &nalloc) < 0)
+        desc->native_encoding.clear ();
     }
-  else if (! dtype_to_struct (mem_type_id, info_struct))
-    error ("%s: unable to determine type", caller.c_str ());
 
-  std::string cls = info_struct.getfield ("Class").string_value ();
+  desc->size = H5Tget_size (native_id);
+  desc->sign = (desc->cls == H5T_INTEGER ? H5Tget_sign (native_id)
+                : H5T_SGN_NONE);
+  desc->kind = get_type_kind (desc->cls, desc->size, desc->sign, native_id);
+  desc->has_vlen = (desc->kind == h5_type_desc::VLSTRING
+                    || desc->cls == H5T_VLEN);
 
-  if (cls == "H5T_INTEGER")
+  if (desc->kind == h5_type_desc::STRING
+      && H5Tget_strpad (native_id) == H5T_STR_SPACEPAD)
+    desc->strpad = ' ';
+
+  if (desc->cls == H5T_COMPOUND)
     {
-      std::string typ = info_struct.getfield ("Type").string_value ();
-      if (typ.find ("I8") != std::string::npos)
-        {
-          int8NDArray data (dv);
-          H5READ ();
-        }
-      else if (typ.find ("U8") != std::string::npos)
-        {
-          uint8NDArray data (dv);
-          H5READ ();
-        }
-      else if (typ.find ("I16") != std::string::npos)
-        {
-          int16NDArray data (dv);
-          H5READ ();
-        }
-      else if (typ.find ("U16") != std::string::npos)
-        {
-          uint16NDArray data (dv);
-          H5READ ();
-        }
-      else if (typ.find ("I32") != std::string::npos)
-        {
-          int32NDArray data (dv);
-          H5READ ();
-        }
-      else if (typ.find ("U32") != std::string::npos)
+      int nfields = H5Tget_nmembers (native_id);
+
+      for (int ii = 0; ii < nfields; ii++)
         {
-          uint32NDArray data (dv);
-          H5READ ();
+          char *name = H5Tget_member_name (native_id, ii);
+          hid_t field_type_id = H5Tget_member_type (native_id, ii);
+
+          h5_type_desc::member field;
+          field.name = name;
+          field.offset = H5Tget_member_offset (native_id, ii);
+          field.type = get_type_desc (field_type_id);
+
+          desc->has_vlen = desc->has_vlen || field.type->has_vlen;
+          desc->members.push_back (field);
+
+          H5Tclose (field_type_id);
+          H5free_memory (name);
         }
-      else if (typ.find ("I64") != std::string::npos)
+    }
+  else if (desc->cls == H5T_VLEN || desc->cls == H5T_ARRAY)
+    {
+      hid_t base_type_id = H5Tget_super (native_id);
+      desc->super = get_type_desc (base_type_id);
+      H5Tclose (base_type_id);
+
+      if (desc->cls == H5T_ARRAY)
         {
-          int64NDArray data (dv);
-          H5READ ();
+          int rank = H5Tget_array_ndims (native_id);
+          desc->array_dims.resize (std::max (rank, 0));
+          H5Tget_array_dims2 (native_id, desc->array_dims.data ());
         }
-      else if (typ.find ("U64") != std::string::npos)
+    }
+
+  return desc;
+}
+
+// Descriptors are memoized by the serialized form of the datatype, which
+// identifies transient and committed types alike.  The cache may be
+// accessed from several threads and is emptied when the library closes.
+static std::mutex type_desc_mutex;
+
+static std::unordered_map<std::string, std::shared_ptr<const h5_type_desc>>
+type_desc_cache;
+
+#if H5_VERSION_GE(1, 14, 0)
+static void
+clear_type_desc_cache (void *)
+{
+  std::lock_guard<std::mutex> lock (type_desc_mutex);
+  type_desc_cache.clear ();
+}
+#endif
+
+std::shared_ptr<const h5_type_desc>
+get_type_desc (hid_t type_id)
+{
+  static const std::size_t max_cache_size = 256;
+
+  size_t nalloc = 0;
+  if (H5Tencode (type_id, nullptr, &nalloc) < 0 || nalloc == 0)
+    return make_type_desc (type_id);
+
+  std::string key (nalloc, '\0');
+  if (H5Tencode (type_id, &key[0], &nalloc) < 0)
+    return make_type_desc (type_id);
+
+  {
+    std::lock_guard<std::mutex> lock (type_desc_mutex);
+
+    auto it = type_desc_cache.find (key);
+    if (it != type_desc_cache.end ())
+      return it->second;
+  }
+
+  // Member descriptors are looked up recursively, the lock is not held
+  auto desc = make_type_desc (type_id);
+
+  std::lock_guard<std::mutex> lock (type_desc_mutex);
+
+#if H5_VERSION_GE(1, 14, 0)
+  static bool atclose_registered = false;
+  if (! atclose_registered)
+    atclose_registered = (H5atclose (clear_type_desc_cache, nullptr) >= 0);
+#endif
+
+  if (type_desc_cache.size () >= max_cache_size)
+    type_desc_cache.clear ();
+
+  type_desc_cache[key] = desc;
+
+  return desc;
+}
+
+static const char *
+get_class_name (H5T_class_t cls)
+{
+  switch (cls)
+    {
+    case H5T_INTEGER:
+      return "H5T_INTEGER";
+    case H5T_FLOAT:
+      return "H5T_FLOAT";
+    case H5T_TIME:
+      return "H5T_TIME";
+    case H5T_STRING:
+      return "H5T_STRING";
+    case H5T_BITFIELD:
+      return "H5T_BITFIELD";
+    case H5T_OPAQUE:
+      return "H5T_OPAQUE";
+    case H5T_COMPOUND:
+      return "H5T_COMPOUND";
+    case H5T_REFERENCE:
+      return "H5T_REFERENCE";
+    case H5T_ENUM:
+      return "H5T_ENUM";
+    case H5T_VLEN:
+      return "H5T_VLEN";
+    case H5T_ARRAY:
+      return "H5T_ARRAY";
+    default:
+      return "H5T_NO_CLASS";
+    }
+}
+
+// Dispatch tables, indexed by descriptor kind, for numeric arrays
+
+typedef octave_value (*numeric_reader) (const std::string&, const dim_vector&,
+                                        hid_t, hid_t, hid_t, hid_t, hid_t,
+                                        int);
+
+typedef octave_value (*numeric_unpacker) (const char *, size_t,
+                                          const dim_vector&);
+
+typedef void (*numeric_packer) (char *, size_t, const octave_value&);
+
+typedef void (*numeric_record_unpacker) (const char *, size_t, Cell&);
+
+typedef void (*numeric_record_packer) (const std::string&, char *, size_t,
+                                       const Cell&);
+
+typedef octave_value (*numeric_inplace_reader) (const std::string&,
+                                        const octave_value&, hid_t, hid_t,
+                                        hid_t, hid_t, hid_t, int);
+
+template <typename T>
+static octave_value
+read_numeric (const std::string& caller, const dim_vector& dv,
+              hid_t object_id, hid_t mem_type_id, hid_t mem_space_id,
+              hid_t file_space_id, hid_t xfer_plist_id, int read_fcn)
+{
+  octave_value retval;
+
+  // Elements not selected in the memory space are zero
+  T data (dv, 0);
+
+  // Compressed chunks are decoded in parallel and large contiguous
+  // datasets are mapped in memory when possible
+  if (read_fcn == 0
+      && (read_chunks_parallel (object_id, mem_type_id, mem_space_id,
+                                file_space_id, xfer_plist_id,
+                                data.fortran_vec ())
+          || read_contiguous_mapped (object_id, mem_type_id, mem_space_id,
+                                     file_space_id, data.fortran_vec ())))
+    return octave_value (data);
+
+  H5READ ();
+
+  return retval;
+}
+
+// Read into the storage of the full array held by DATA, which is only
+// reused if no other array shares it.  Values bound to DATA by plain
+// assignment share the array itself rather than its storage, so they all
+// see the new values.  Arrays sharing the storage of DATA, e.g. obtained
+// with reshape, are left unchanged and the values are read into a copy.
+// Return an undefined value if DATA does not hold an array of the
+// expected representation.
+template <typename T, typename OV_T>
+static octave_value
+read_numeric_inplace (const std::string& caller, const octave_value& data,
+                      hid_t object_id, hid_t mem_type_id, hid_t mem_space_id,
+                      hid_t file_space_id, hid_t xfer_plist_id, int read_fcn)
+{
+  const OV_T *rep = dynamic_cast<const OV_T *> (&data.get_rep ());
+
+  if (! rep)
+    return octave_value ();
+
+  T& matrix = const_cast<OV_T *> (rep)->matrix_ref ();
+
+  // Unselected elements of the memory space keep their previous values
+  T copy;
+  T *buf = &matrix;
+
+  // fortran_vec makes the copy unique
+  if (matrix.is_shared ())
+    {
+      copy = matrix;
+      buf = &copy;
+    }
+
+  herr_t status = 0;
+  if (read_fcn != 0)
+    status = H5Aread (object_id, mem_type_id, buf->fortran_vec ());
+  else if (! read_chunks_parallel (object_id, mem_type_id, mem_space_id,
+                                   file_space_id, xfer_plist_id,
+                                   buf->fortran_vec ())
+           && ! read_contiguous_mapped (object_id, mem_type_id, mem_space_id,
+                                        file_space_id, buf->fortran_vec ()))
+    status = H5Dread (object_id, mem_type_id, mem_space_id, file_space_id,
+                      xfer_plist_id, buf->fortran_vec ());
+
+  if (status < 0)
+    error ("%s: unable to read data (status %d)", caller.c_str (), status);
+
+  if (buf == &copy)
+    return octave_value (copy);
+
+  return data;
+}
+
+template <typename T>
+static octave_value
+unpack_numeric (const char *base, size_t stride, const dim_vector& dv)
+{
+  T data (dv);
+  typename T::element_type *ptr = data.fortran_vec ();
+  size_t sz = sizeof (typename T::element_type);
+
+  octave_idx_type nel = data.numel ();
+  for (octave_idx_type ii = 0; ii < nel; ii++)
+    std::memcpy (ptr + ii, base + ii * stride, sz);
+
+  return octave_value (data);
+}
+
+template <typename T>
+static void
+pack_numeric (char *base, size_t stride, const octave_value& ov)
+{
+  const T data = octave_value_extract<T> (ov);
+  const typename T::element_type *ptr = data.data ();
+  size_t sz = sizeof (typename T::element_type);
+
+  octave_idx_type nel = data.numel ();
+  for (octave_idx_type ii = 0; ii < nel; ii++)
+    std::memcpy (base + ii * stride, ptr + ii, sz);
+}
+
+// One scalar per element of CELL, taken from interleaved records
+template <typename T>
+static void
+unpack_numeric_records (const char *base, size_t stride, Cell& cell)
+{
+  typename T::element_type val;
+  octave_value *ptr = cell.fortran_vec ();
+
+  octave_idx_type nel = cell.numel ();
+  for (octave_idx_type ii = 0; ii < nel; ii++)
+    {
+      std::memcpy (&val, base + ii * stride, sizeof (val));
+      ptr[ii] = octave_value (val);
+    }
+}
+
+template <typename T> static T record_scalar (const octave_value& ov);
+
+template <> double
+record_scalar<double> (const octave_value& ov)
+{ return ov.double_value (); }
+
+template <> float
+record_scalar<float> (const octave_value& ov)
+{ return ov.float_value (); }
+
+#define RECORD_SCALAR(T, FCN)                   \
+  template <> T                                 \
+  record_scalar<T> (const octave_value& ov)     \
+  { return ov.FCN (); }
+
+RECORD_SCALAR (octave_int8, int8_scalar_value)
+RECORD_SCALAR (octave_uint8, uint8_scalar_value)
+RECORD_SCALAR (octave_int16, int16_scalar_value)
+RECORD_SCALAR (octave_uint16, uint16_scalar_value)
+RECORD_SCALAR (octave_int32, int32_scalar_value)
+RECORD_SCALAR (octave_uint32, uint32_scalar_value)
+RECORD_SCALAR (octave_int64, int64_scalar_value)
+RECORD_SCALAR (octave_uint64, uint64_scalar_value)
+
+#undef RECORD_SCALAR
+
+// Interleave the scalars held by the elements of CELL into records
+template <typename T>
+static void
+pack_numeric_records (const std::string& caller, char *base, size_t stride,
+                      const Cell& cell)
+{
+  typedef typename T::element_type elt_type;
+  const octave_value *ptr = cell.data ();
+
+  octave_idx_type nel = cell.numel ();
+  for (octave_idx_type ii = 0; ii < nel; ii++)
+    {
+      if (ptr[ii].numel () != 1)
+        error ("%s: expecting 1 elements for each field of the input "
+               "structure, got %ld", caller.c_str (),
+               static_cast<long> (ptr[ii].numel ()));
+
+      elt_type val = record_scalar<elt_type> (ptr[ii]);
+      std::memcpy (base + ii * stride, &val, sizeof (val));
+    }
+}
+
+#define NUMERIC_TABLE(FCN)                                              \
+  {                                                                     \
+    nullptr,                                                            \
+    FCN<int8NDArray>, FCN<uint8NDArray>, FCN<int16NDArray>,             \
+    FCN<uint16NDArray>, FCN<int32NDArray>, FCN<uint32NDArray>,          \
+    FCN<int64NDArray>, FCN<uint64NDArray>, FCN<FloatNDArray>,           \
+    FCN<NDArray>, FCN<int64NDArray>,                                    \
+    nullptr, nullptr, nullptr, nullptr, nullptr                         \
+  }
+
+static const numeric_reader numeric_readers[h5_type_desc::NUM_KINDS]
+  = NUMERIC_TABLE (read_numeric);
+
+static const numeric_unpacker numeric_unpackers[h5_type_desc::NUM_KINDS]
+  = NUMERIC_TABLE (unpack_numeric);
+
+static const numeric_packer numeric_packers[h5_type_desc::NUM_KINDS]
+  = NUMERIC_TABLE (pack_numeric);
+
+static const numeric_record_unpacker
+numeric_record_unpackers[h5_type_desc::NUM_KINDS]
+  = NUMERIC_TABLE (unpack_numeric_records);
+
+static const numeric_record_packer
+numeric_record_packers[h5_type_desc::NUM_KINDS]
+  = NUMERIC_TABLE (pack_numeric_records);
+
+#undef NUMERIC_TABLE
+
+static const numeric_inplace_reader
+numeric_inplace_readers[h5_type_desc::NUM_KINDS] =
+  {
+    nullptr,
+    read_numeric_inplace<int8NDArray, octave_int8_matrix>,
+    read_numeric_inplace<uint8NDArray, octave_uint8_matrix>,
+    read_numeric_inplace<int16NDArray, octave_int16_matrix>,
+    read_numeric_inplace<uint16NDArray, octave_uint16_matrix>,
+    read_numeric_inplace<int32NDArray, octave_int32_matrix>,
+    read_numeric_inplace<uint32NDArray, octave_uint32_matrix>,
+    read_numeric_inplace<int64NDArray, octave_int64_matrix>,
+    read_numeric_inplace<uint64NDArray, octave_uint64_matrix>,
+    read_numeric_inplace<FloatNDArray, octave_float_matrix>,
+    read_numeric_inplace<NDArray, octave_matrix>,
+    read_numeric_inplace<int64NDArray, octave_int64_matrix>,
+    nullptr, nullptr, nullptr, nullptr, nullptr
+  };
+
+static const char *numeric_class_names[h5_type_desc::NUM_KINDS] =
+  {
+    nullptr, "int8", "uint8", "int16", "uint16", "int32", "uint32", "int64",
+    "uint64", "single", "double", "int64", nullptr, nullptr, nullptr, nullptr,
+    nullptr
+  };
+
+// Extract the values of one compound member, located at BASE in the first
+// record, from a buffer of interleaved records of size STRIDE.
+static octave_value
+unpack_member (const std::string& caller, const char *base, size_t stride,
+               const h5_type_desc& desc, const dim_vector& dv)
+{
+  size_t sz = desc.size;
+  octave_idx_type nel = dv.numel ();
+
+  if (numeric_unpackers[desc.kind])
+    return numeric_unpackers[desc.kind] (base, stride, dv);
+
+  switch (desc.kind)
+    {
+    case h5_type_desc::VLSTRING:
+      {
+        // Elements of the memory buffer that are not part of the selection
+        // are left null
+        if (nel == 1)
+          {
+            const char *str = *reinterpret_cast<char * const *> (base);
+            return octave_value (std::string (str ? str : ""));
+          }
+
+        Cell cell_str (dv);
+
+        for (octave_idx_type ii = 0; ii < nel; ii++)
+          {
+            const char *str
+              = *reinterpret_cast<char * const *> (base + ii * stride);
+            cell_str(ii) = octave_value (std::string (str ? str : ""));
+          }
+
+        return octave_value (cell_str);
+      }
+
+    case h5_type_desc::STRING:
+      {
+        std::vector<std::string> strs (nel);
+        size_t maxlen = 0;
+
+        for (octave_idx_type ii = 0; ii < nel; ii++)
+          {
+            const char *str = base + ii * stride;
+            strs[ii] = std::string (str, strnlen (str, sz));
+            maxlen = std::max (maxlen, strs[ii].length ());
+          }
+
+        if (nel == 1)
+          return octave_value (strs[0]);
+
+        charMatrix cm (dim_vector (nel, maxlen), ' ');
+        for (octave_idx_type ii = 0; ii < nel; ii++)
+          cm.insert (strs[ii].c_str (), ii, 0);
+
+        return octave_value (cm);
+      }
+
+    case h5_type_desc::ARRAY:
+      if (numeric_unpackers[desc.super->kind])
         {
-          uint64NDArray data (dv);
-          H5READ ();
+          // Each record holds a column of the output, the array elements
+          // of all records are first gathered contiguously
+          size_t esz = desc.super->size;
+          octave_idx_type n = sz / esz;
+
+          std::vector<char> tmp (nel * sz);
+
+          for (octave_idx_type ii = 0; ii < nel; ii++)
+            std::memcpy (tmp.data () + ii * sz, base + ii * stride, sz);
+
+          return numeric_unpackers[desc.super->kind] (tmp.data (), esz,
+                                                      dim_vector (n, nel));
         }
+      break;
+
+    case h5_type_desc::COMPOUND:
+      {
+        octave_scalar_map data;
+
+        for (const auto& field : desc.members)
+          data.assign (field.name,
+                       unpack_member (caller, base + field.offset, stride,
+                                      *field.type, dv));
+
+        return octave_value (data);
+      }
+
+    default:
+      break;
+    }
+
+  error ("%s: unhandled compound member type (class %d, size %ld)",
+         caller.c_str (), static_cast<int> (desc.cls),
+         static_cast<long> (sz));
+}
+
+// Build a struct array of dimensions DV with one element per record.
+// Numeric members are converted in a single strided pass each.
+static octave_value
+unpack_records (const std::string& caller, const char *buf, size_t stride,
+                const h5_type_desc& desc, const dim_vector& dv)
+{
+  octave_idx_type nel = dv.numel ();
+  dim_vector scalar_dv (1, 1);
+
+  octave_map retval (dv);
+
+  for (const auto& field : desc.members)
+    {
+      Cell cell (dv);
+      const char *base = buf + field.offset;
+
+      if (numeric_record_unpackers[field.type->kind])
+        numeric_record_unpackers[field.type->kind] (base, stride, cell);
+      else
+        for (octave_idx_type kk = 0; kk < nel; kk++)
+          cell(kk) = unpack_member (caller, base + kk * stride, stride,
+                                    *field.type, scalar_dv);
+
+      retval.assign (field.name, cell);
+    }
+
+  return octave_value (retval);
+}
+
+// Compound data are read in a single pass into a buffer of packed native
+// records, which are then split into one Octave array per member or, if
+// AS_RECORDS is true, into a struct array with one element per record.
+static octave_value
+read_compound (const std::string& caller, const dim_vector& dv,
+               hid_t object_id, const h5_type_desc& desc, hid_t mem_space_id,
+               hid_t file_space_id, hid_t xfer_plist_id, bool as_records)
+{
+  bool is_dataset = ! is_attribute_caller (caller);
+
+  hid_t native_type_id = desc.native_type ();
+  h5_id_closer type_closer (native_type_id, H5Tclose);
+
+  size_t stride = desc.size;
+  octave_idx_type nel = dv.numel ();
+
+  std::vector<char> buf (nel * stride, 0);
+
+  herr_t status;
+  if (is_dataset)
+    status = H5Dread (object_id, native_type_id, mem_space_id, file_space_id,
+                      xfer_plist_id, buf.data ());
+  else
+    status = H5Aread (object_id, native_type_id, buf.data ());
+
+  // Variable length members are allocated by HDF5 and must be reclaimed
+  auto reclaim = [&desc, native_type_id, nel, &buf] ()
+  {
+    if (desc.has_vlen)
+      {
+        hsize_t dims[1] = {static_cast<hsize_t> (nel)};
+        hid_t space_id = H5Screate_simple (1, dims, nullptr);
+        H5Dvlen_reclaim (native_type_id, space_id, H5P_DEFAULT, buf.data ());
+        H5Sclose (space_id);
+      }
+  };
+
+  if (status < 0)
+    {
+      reclaim ();
+      error ("%s: unable to read compound data", caller.c_str ());
+    }
+
+  octave_value retval;
+
+  try
+    {
+      if (as_records)
+        retval = unpack_records (caller, buf.data (), stride, desc, dv);
       else
-        error ("H5D.read: unexpected mem type");
+        retval = unpack_member (caller, buf.data (), stride, desc, dv);
+    }
+  catch (const octave::execution_exception&)
+    {
+      reclaim ();
+      throw;
+    }
+
+  reclaim ();
+
+  return retval;
+}
+
+// Copy the values of OV into one member, located at BASE in the first
+// record, of a buffer of NEL interleaved records of size STRIDE.
+// Variable length strings point to copies kept alive in STRINGS.
+static void
+pack_member (const std::string& caller, char *base, size_t stride,
+             const h5_type_desc& desc, const octave_value& ov,
+             octave_idx_type nel, std::deque<std::string>& strings)
+{
+  size_t sz = desc.size;
+
+  if (numeric_packers[desc.kind])
+    {
+      if (ov.numel () != nel)
+        error ("%s: expecting %ld elements for each field of the input "
+               "structure, got %ld", caller.c_str (), static_cast<long> (nel),
+               static_cast<long> (ov.numel ()));
+
+      numeric_packers[desc.kind] (base, stride, ov);
+      return;
     }
-  else if (cls == "H5T_FLOAT")
+
+  switch (desc.kind)
     {
-      std::string typ = info_struct.getfield ("Type").string_value ();
-      if (typ.find ("F32") != std::string::npos)
+    case h5_type_desc::STRING:
+    case h5_type_desc::VLSTRING:
+      {
+        std::vector<std::string> strs;
+
+        if (ov.iscellstr ())
+          {
+            Cell cellstr = ov.cell_value ();
+            for (octave_idx_type ii = 0; ii < cellstr.numel (); ii++)
+              {
+                // For compatibility with ML, transform vertical char
+                // arrays into row strings
+                charMatrix cm = cellstr(ii).char_matrix_value ();
+                strs.push_back (cm.reshape (1, cm.numel ()).row_as_string (0));
+              }
+          }
+        else if (ov.is_string () && nel == 1)
+          strs.push_back (ov.string_value ());
+        else if (ov.is_string ())
+          {
+            charMatrix cm = ov.char_matrix_value ();
+            for (octave_idx_type ii = 0; ii < cm.rows (); ii++)
+              strs.push_back (cm.row_as_string (ii));
+          }
+        else
+          error ("%s: expecting char array or cell array of strings for "
+                 "string fields", caller.c_str ());
+
+        if (static_cast<octave_idx_type> (strs.size ()) != nel)
+          error ("%s: expecting %ld strings for each string field of the "
+                 "input structure, got %ld", caller.c_str (),
+                 static_cast<long> (nel), static_cast<long> (strs.size ()));
+
+        if (desc.kind == h5_type_desc::VLSTRING)
+          for (octave_idx_type ii = 0; ii < nel; ii++)
+            {
+              strings.push_back (strs[ii]);
+              const char *str = strings.back ().c_str ();
+              std::memcpy (base + ii * stride, &str, sizeof (str));
+            }
+        else
+          for (octave_idx_type ii = 0; ii < nel; ii++)
+            {
+              // Truncated or padded to the string size
+              size_t len = std::min (sz, strs[ii].length ());
+              std::memcpy (base + ii * stride, strs[ii].c_str (), len);
+              std::memset (base + ii * stride + len, desc.strpad, sz - len);
+            }
+      }
+      return;
+
+    case h5_type_desc::ARRAY:
+      if (numeric_packers[desc.super->kind])
         {
-          FloatNDArray data (dv);
-          H5READ ();
+          size_t esz = desc.super->size;
+
+          if (ov.numel () != nel * static_cast<octave_idx_type> (sz / esz))
+            error ("%s: expecting %ld elements for each array field of the "
+                   "input structure, got %ld", caller.c_str (),
+                   static_cast<long> (nel * (sz / esz)),
+                   static_cast<long> (ov.numel ()));
+
+          std::vector<char> tmp (nel * sz);
+
+          numeric_packers[desc.super->kind] (tmp.data (), esz, ov);
+
+          for (octave_idx_type ii = 0; ii < nel; ii++)
+            std::memcpy (base + ii * stride, tmp.data () + ii * sz, sz);
+
+          return;
         }
-      else if (typ.find ("F64") != std::string::npos)
+      break;
+
+    case h5_type_desc::COMPOUND:
+      {
+        octave_scalar_map data
+          = ov.xscalar_map_value ("%s: expecting a scalar structure for "
+                                  "compound data type", caller.c_str ());
+
+        for (const auto& field : desc.members)
+          pack_member (caller, base + field.offset, stride, *field.type,
+                       data.getfield (field.name), nel, strings);
+      }
+      return;
+
+    default:
+      break;
+    }
+
+  error ("%s: unhandled compound member type (class %d, size %ld)",
+         caller.c_str (), static_cast<int> (desc.cls),
+         static_cast<long> (sz));
+}
+
+// Fill the record buffer BUF from the field contents of a struct array
+// with one element per record
+static void
+pack_records (const std::string& caller, char *buf, size_t stride,
+              const std::vector<const h5_type_desc::member *>& fields,
+              const std::vector<size_t>& offsets,
+              const std::vector<Cell>& cells, octave_idx_type nel,
+              std::deque<std::string>& strings)
+{
+  for (size_t ii = 0; ii < fields.size (); ii++)
+    {
+      const h5_type_desc& field_desc = *fields[ii]->type;
+      const Cell& cell = cells[ii];
+      char *base = buf + offsets[ii];
+
+      if (numeric_record_packers[field_desc.kind])
+        numeric_record_packers[field_desc.kind] (caller, base, stride, cell);
+      else
+        for (octave_idx_type kk = 0; kk < nel; kk++)
+          pack_member (caller, base + kk * stride, stride, field_desc,
+                       cell(kk), 1, strings);
+    }
+}
+
+// Number of elements of the memory buffer expected by H5Dwrite/H5Awrite
+static octave_idx_type
+get_mem_npoints (hid_t object_id, hid_t mem_space_id, hid_t file_space_id,
+                 bool is_dataset)
+{
+  hid_t space_id = mem_space_id;
+
+  if (space_id == H5S_ALL)
+    space_id = file_space_id;
+
+  bool own_space = (space_id == H5S_ALL || ! is_dataset);
+
+  if (! is_dataset)
+    space_id = H5Aget_space (object_id);
+  else if (space_id == H5S_ALL)
+    space_id = H5Dget_space (object_id);
+
+  hssize_t npoints = H5Sget_simple_extent_npoints (space_id);
+
+  if (own_space)
+    H5Sclose (space_id);
+
+  return static_cast<octave_idx_type> (npoints);
+}
+
+// Compound data are packed into a single buffer of native records holding
+// the members present in the input structure and written at once.  The
+// input is either a scalar structure whose fields hold one value per record
+// or a struct array with one element per record.
+static herr_t
+write_compound (const std::string& caller, const octave_value& ov,
+                hid_t object_id, hid_t type_id, hid_t mem_space_id,
+                hid_t file_space_id, hid_t xfer_plist_id)
+{
+  bool is_dataset = ! is_attribute_caller (caller);
+
+  bool as_records = ov.isstruct () && ov.numel () != 1;
+
+  octave_scalar_map data;
+  octave_map records;
+
+  if (as_records)
+    records = ov.map_value ();
+  else
+    data = ov.xscalar_map_value ("%s: expecting a structure "
+                                 "for compound data type", caller.c_str ());
+
+  // Build a packed native memory type holding the members that are
+  // present in the input structure
+  auto desc = get_type_desc (type_id);
+
+  std::vector<const h5_type_desc::member *> fields;
+  std::vector<size_t> offsets;
+  size_t stride = 0;
+
+  for (const auto& field : desc->members)
+    {
+      bool present;
+      if (as_records)
+        present = records.isfield (field.name);
+      else
+        present = data.isfield (field.name);
+
+      if (present)
         {
-          NDArray data (dv);
-          H5READ ();
+          fields.push_back (&field);
+          offsets.push_back (stride);
+          stride += field.type->size;
         }
-      else
-        error ("H5D.read: unexpected mem type");
     }
-  else if (cls == "H5T_STRING")
+
+  if (fields.empty ())
+    return -1;
+
+  octave_idx_type nel = get_mem_npoints (object_id, mem_space_id,
+                                         file_space_id, is_dataset);
+
+  if (as_records && records.numel () != nel)
+    error ("%s: expecting %ld elements in the input struct array, got %ld",
+           caller.c_str (), static_cast<long> (nel),
+           static_cast<long> (records.numel ()));
+
+  std::vector<char> buf (nel * stride, 0);
+  std::deque<std::string> strings;
+
+  if (as_records)
+    {
+      std::vector<Cell> cells;
+      for (const auto *field : fields)
+        cells.push_back (records.contents (field->name));
+
+      pack_records (caller, buf.data (), stride, fields, offsets, cells, nel,
+                    strings);
+    }
+  else
+    for (size_t ii = 0; ii < fields.size (); ii++)
+      pack_member (caller, buf.data () + offsets[ii], stride,
+                   *fields[ii]->type, data.getfield (fields[ii]->name), nel,
+                   strings);
+
+  hid_t mem_type_id = H5Tcreate (H5T_COMPOUND, stride);
+
+  for (size_t ii = 0; ii < fields.size (); ii++)
     {
-      // FIXME: This section is messy (at least). Separate variable and fixed
-      // length sections for readability and see if this can be simplified.
-      std::string typ = info_struct.getfield ("Type").scalar_map_value ()
-        .getfield ("CharacterType").string_value ();
+      hid_t field_type_id = fields[ii]->type->native_type ();
+      H5Tinsert (mem_type_id, fields[ii]->name.c_str (), offsets[ii],
+                 field_type_id);
+      H5Tclose (field_type_id);
+    }
+
+  herr_t status;
+
+  if (is_dataset)
+    status = H5Dwrite (object_id, mem_type_id, mem_space_id, file_space_id,
+                       xfer_plist_id, buf.data ());
+  else
+    status = H5Awrite (object_id, mem_type_id, buf.data ());
+
+  H5Tclose (mem_type_id);
+
+  return status;
+}
+
+octave_value
+__h5_read__ (const std::string& caller, dim_vector dv, hid_t object_id,
+             hid_t mem_type_id, hid_t mem_space_id,
+             hid_t file_space_id, hid_t xfer_plist_id,
+             hid_t field_type_id, bool as_records)
+{
+  octave_value retval;
+
+  // Decide which hdf5 function to call based on caller name
+  int read_fcn = is_attribute_caller (caller) ? 1 : 0;
+
+  // Get type info
+  auto desc = get_type_desc (field_type_id != H5_INDEX_UNKNOWN
+                             ? field_type_id : mem_type_id);
+
+  if (desc->cls < 0)
+    error ("%s: unable to determine type", caller.c_str ());
+
+  H5T_class_t cls = desc->cls;
 
-      if (typ != "H5T_C_S1")
-        error ("H5D.read: unhandled string type %s", typ.c_str ());
+  // Numeric data are read into the matching native array type
+  numeric_reader reader = numeric_readers[desc->kind];
+
+  if (reader)
+    {
+      hid_t native_type_id = desc->native_type ();
+      h5_id_closer type_closer (native_type_id, H5Tclose);
 
+      retval = reader (caller, dv, object_id, native_type_id, mem_space_id,
+                       file_space_id, xfer_plist_id, read_fcn);
+    }
+  else if (cls == H5T_INTEGER || cls == H5T_FLOAT)
+    error ("%s: unexpected mem type", caller.c_str ());
+  else if (cls == H5T_STRING)
+    {
+      // FIXME: This section is messy (at least). Separate variable and fixed
+      // length sections for readability and see if this can be simplified.
       int slen = H5Tget_size (mem_type_id);
 
       octave_idx_type ndims = dv.ndims ();
@@ -135,32 +1023,36 @@ __h5_read__ (const std::string& caller, dim_vector dv, hid_t object_id,
         }
 
       herr_t status;
+      bool own_mem_space = false;
 
       // H5Dread expects a char** with memory allocated for dimensions only
       // for vlstrings . In this case HDF5 allocates the necessary
       // memory for the actual char internally so we finally have to reclaim
       // owwnership of the pointer and free it ourselves.
       char **rdata;
-      rdata = (char **)malloc (nstrings * sizeof (char *));
+      rdata = (char **)calloc (nstrings, sizeof (char *));
 
       // Check if this is a vl string
-      octave_value sz = info_struct.getfield ("Type").scalar_map_value ()
-        .getfield ("Length");
-      bool is_vlstring = sz.is_string ()
-        && sz.string_value ().compare ("H5T_VARIABLE") == 0;
+      bool is_vlstring = (desc->kind == h5_type_desc::VLSTRING);
 
       if (! is_vlstring)
         {
-          rdata[0] = (char *)malloc ((slen+1) * nstrings * sizeof (char));
+          rdata[0] = (char *)calloc ((slen+1) * nstrings, sizeof (char));
           for (int ii = 1; ii < nstrings; ii++)
             rdata[ii] = rdata[0] + ii * (slen + 1);
           mem_type_id = H5Tcopy (H5T_C_S1);
           H5Tset_size (mem_type_id, slen + 1);
         }
-      else if (read_fcn == 0)
-        mem_space_id = H5Dget_space (object_id);
-      else
-        mem_space_id = H5Aget_space (object_id);
+      else if (mem_space_id == H5S_ALL)
+        {
+          // A dataspace is needed to reclaim vlen memory
+          own_mem_space = true;
+
+          if (read_fcn == 0)
+            mem_space_id = H5Dget_space (object_id);
+          else
+            mem_space_id = H5Aget_space (object_id);
+        }
 
       if (read_fcn == 0)
         if (is_vlstring)
@@ -175,14 +1067,17 @@ __h5_read__ (const std::string& caller, dim_vector dv, hid_t object_id,
         else
           status = H5Aread (object_id, mem_type_id, rdata[0]);
 
+      // Elements of the memory buffer that are not part of the selection
+      // are left null
       if (nstrings == 1)
-        retval = octave_value (std::string (rdata[0]));
+        retval = octave_value (std::string (rdata[0] ? rdata[0] : ""));
       else if (is_vlstring)
         {
           Cell cell_str (dv);
 
           for (int ii = 0; ii < nstrings; ii++)
-            cell_str(ii) = octave_value (std::string (rdata[ii]));
+            cell_str(ii) = octave_value (std::string (rdata[ii] ? rdata[ii]
+                                                      : ""));
 
           retval = octave_value (cell_str);
         }
@@ -204,7 +1099,9 @@ __h5_read__ (const std::string& caller, dim_vector dv, hid_t object_id,
       if (is_vlstring)
         {
           H5Dvlen_reclaim (mem_type_id, mem_space_id, H5P_DEFAULT, rdata);
-          H5Sclose (mem_space_id);
+
+          if (own_mem_space)
+            H5Sclose (mem_space_id);
         }
       else
         H5Tclose (mem_type_id);
@@ -214,49 +1111,16 @@ __h5_read__ (const std::string& caller, dim_vector dv, hid_t object_id,
       if (status < 0)
         error ("%s: unable to read string data", caller.c_str ());
     }
-  else if (cls == "H5T_REFERENCE")
-    {
-      int64NDArray data (dv);
-      H5READ ();
-    }
-  else if (cls == "H5T_COMPOUND")
-    {
-      octave_scalar_map data;
-      size_t nfields = H5Tget_nmembers (mem_type_id);
-
-      for (size_t ii = 0; ii < nfields; ii++)
-        {
-          char *name = H5Tget_member_name (mem_type_id, ii);
-
-          field_type_id  = H5Tget_member_type (mem_type_id, ii);
-
-          size_t sz = H5Tget_size (field_type_id);
-
-          hid_t type_id = H5Tcreate (H5T_COMPOUND, sz);
-
-          H5Tinsert (type_id, name, 0, field_type_id);
-
-          octave_value val = __h5_read__ (caller, dv, object_id,
-                                          type_id, mem_space_id,
-                                          file_space_id, xfer_plist_id,
-                                          field_type_id);
-
-          data.assign (std::string (name), val);
-
-          H5Tclose(type_id);
-        }
-
-      retval = octave_value (data);
-    }
-  else if (cls == "H5T_VLEN")
+  else if (cls == H5T_COMPOUND)
+    retval = read_compound (caller, dv, object_id, *desc, mem_space_id,
+                            file_space_id, xfer_plist_id, as_records);
+  else if (cls == H5T_VLEN)
     {
       if (dv.ndims () > 0)
         {
-          hid_t base_type_id = H5Tget_super (mem_type_id);
-          dtype_to_struct (base_type_id, info_struct);
-
-          if (info_struct.getfield ("Class").string_value () != "H5T_STRING")
-            error ("%s: unhandled type %s", caller.c_str (), cls.c_str ());
+          if (desc->super->cls != H5T_STRING)
+            error ("%s: unhandled type %s", caller.c_str (),
+                   get_class_name (cls));
 
           hvl_t *rdata = (hvl_t *)malloc(dv.ndims () * sizeof(hvl_t));
 
@@ -290,34 +1154,233 @@ __h5_read__ (const std::string& caller, dim_vector dv, hid_t object_id,
         retval = octave_value ();
     }
   else
-    error ("%s: unhandled type %s", caller.c_str (), cls.c_str ());
+    error ("%s: unhandled type %s", caller.c_str (), get_class_name (cls));
 
   return retval;
 }
 
+octave_value
+__h5_read_into__ (const std::string& caller, const octave_value& data,
+                  const dim_vector& dv, hid_t object_id, hid_t mem_type_id,
+                  hid_t mem_space_id, hid_t file_space_id,
+                  hid_t xfer_plist_id)
+{
+  int read_fcn = is_attribute_caller (caller) ? 1 : 0;
+
+  auto desc = get_type_desc (mem_type_id);
+
+  numeric_inplace_reader reader = numeric_inplace_readers[desc->kind];
+
+  if (! reader)
+    error ("%s: only numeric data can be read into an existing array",
+           caller.c_str ());
+
+  const char *class_name = numeric_class_names[desc->kind];
+
+  if (data.class_name () != class_name || data.iscomplex ())
+    error ("%s: DATA must be a real %s array", caller.c_str (), class_name);
+
+  if (data.dims () != dv)
+    error ("%s: DATA must be of size %s", caller.c_str (),
+           dv.str ().c_str ());
+
+  hid_t native_type_id = desc->native_type ();
+  h5_id_closer type_closer (native_type_id, H5Tclose);
+
+  octave_value retval = reader (caller, data, object_id, native_type_id,
+                                mem_space_id, file_space_id, xfer_plist_id,
+                                read_fcn);
+  if (retval.is_defined ())
+    return retval;
+
+  // DATA is not stored as a full array (e.g. a scalar or a range)
+  return numeric_readers[desc->kind] (caller, dv, object_id, native_type_id,
+                                      mem_space_id, file_space_id,
+                                      xfer_plist_id, read_fcn);
+}
+
+// Number of records held by the value OV of a compound member, as
+// expected by pack_member, or -1 if it cannot be determined.
+static octave_idx_type
+get_member_numel (const h5_type_desc& desc, const octave_value& ov)
+{
+  if (numeric_packers[desc.kind])
+    return ov.numel ();
+
+  switch (desc.kind)
+    {
+    case h5_type_desc::STRING:
+    case h5_type_desc::VLSTRING:
+      if (ov.iscellstr ())
+        return ov.numel ();
+      else if (ov.is_string ())
+        return ov.rows ();
+      break;
+
+    case h5_type_desc::ARRAY:
+      if (numeric_packers[desc.super->kind])
+        return ov.numel () / (desc.size / desc.super->size);
+      break;
+
+    case h5_type_desc::COMPOUND:
+      if (ov.isstruct () && ov.numel () == 1)
+        {
+          octave_scalar_map data = ov.scalar_map_value ();
+
+          for (const auto& field : desc.members)
+            if (data.isfield (field.name))
+              return get_member_numel (*field.type,
+                                       data.getfield (field.name));
+        }
+      break;
+
+    default:
+      break;
+    }
+
+  return -1;
+}
+
+// Number of dataset elements held by the data OV written with type
+// TYPE_ID, or -1 if it is only known once the data are packed.
+static octave_idx_type
+get_write_numel (const octave_value& ov, hid_t type_id)
+{
+  H5T_class_t cls = H5Tget_class (type_id);
+
+  if (cls == H5T_STRING)
+    {
+      if (H5Tis_variable_str (type_id) > 0)
+        return ov.is_string () ? 1 : ov.numel ();
+
+      // Single characters are written one per element, longer strings
+      // one per row of the char array
+      if (H5Tget_size (type_id) == 1)
+        return ov.numel ();
+
+      return ov.is_string () ? ov.rows () : -1;
+    }
+  else if (cls == H5T_COMPOUND && ov.isstruct () && ov.numel () == 1)
+    {
+      // Fields of a scalar structure hold one value per record, their
+      // number is checked against the others when packing
+      auto desc = get_type_desc (type_id);
+      return get_member_numel (*desc, ov);
+    }
+  else if (H5Tequal (type_id, H5T_STD_REF_DSETREG) > 0)
+    return ov.rows ();
+
+  return ov.numel ();
+}
+
+// Check that the selections of a dataset write are consistent with the NEL
+// elements of the input data (if NEL >= 0).  The input holds the whole
+// extent of MEM_SPACE_ID or, if it is H5S_ALL, either the whole extent of
+// the file dataspace or only the elements selected in FILE_SPACE_ID.  In
+// the latter case MEM_SPACE_ID is replaced with a dataspace holding the
+// selected elements, to be closed by the caller, and true is returned.
+static bool
+check_write_selection (const std::string& caller, hid_t dataset_id,
+                       octave_idx_type nel, hid_t& mem_space_id,
+                       hid_t file_space_id)
+{
+  hid_t space_id = file_space_id;
+
+  if (file_space_id == H5S_ALL)
+    space_id = H5Dget_space (dataset_id);
+
+  if (space_id < 0)
+    error ("%s: unable to retrieve data space", caller.c_str ());
+
+  hssize_t nfile = H5Sget_select_npoints (space_id);
+  hssize_t nextent = H5Sget_simple_extent_npoints (space_id);
+  bool is_simple = (H5Sget_simple_extent_type (space_id) == H5S_SIMPLE);
+
+  hssize_t nmem = -1;
+  hssize_t nbuf = nextent;
+
+  if (mem_space_id != H5S_ALL)
+    {
+      nmem = H5Sget_select_npoints (mem_space_id);
+      nbuf = H5Sget_simple_extent_npoints (mem_space_id);
+    }
+
+  bool own_mem_space = false;
+
+  if (mem_space_id == H5S_ALL && nel >= 0 && nel != nextent && is_simple
+      && nel == nfile)
+    {
+      mem_space_id = get_select_mem_space (space_id);
+      own_mem_space = true;
+      nbuf = nel;
+    }
+
+  if (space_id != file_space_id)
+    H5Sclose (space_id);
+
+  if (nfile < 0)
+    error ("%s: invalid FILE_SPACE_ID", caller.c_str ());
+  else if (mem_space_id != H5S_ALL && ! own_mem_space)
+    {
+      if (nmem < 0)
+        error ("%s: invalid MEM_SPACE_ID", caller.c_str ());
+      else if (nmem != nfile)
+        error ("%s: number of selected elements in MEM_SPACE_ID (%ld) "
+               "and FILE_SPACE_ID (%ld) differ", caller.c_str (),
+               static_cast<long> (nmem), static_cast<long> (nfile));
+    }
+
+  if (nel >= 0 && nel != nbuf)
+    {
+      if (own_mem_space)
+        H5Sclose (mem_space_id);
+
+      if (mem_space_id != H5S_ALL)
+        error ("%s: DATA has %ld elements but MEM_SPACE_ID holds %ld",
+               caller.c_str (), static_cast<long> (nel),
+               static_cast<long> (nbuf));
+      else
+        error ("%s: DATA has %ld elements but the dataset holds %ld and "
+               "FILE_SPACE_ID selects %ld", caller.c_str (),
+               static_cast<long> (nel), static_cast<long> (nextent),
+               static_cast<long> (nfile));
+    }
+
+  return own_mem_space;
+}
+
+// Write numeric DATA to a dataset, compressing its chunks in parallel when
+// possible, or to an attribute if WRT_FCN is 1.
+template <typename T>
+static herr_t
+write_numeric (int wrt_fcn, hid_t object_id, hid_t mem_type_id,
+               hid_t mem_space_id, hid_t file_space_id, hid_t xfer_plist_id,
+               const T& data)
+{
+  if (wrt_fcn != 0)
+    return H5Awrite (object_id, mem_type_id, data.data ());
+
+  if (write_chunks_parallel (object_id, mem_type_id, mem_space_id,
+                             file_space_id, xfer_plist_id, data.data (),
+                             data.numel ()))
+    return 0;
+
+  return H5Dwrite (object_id, mem_type_id, mem_space_id, file_space_id,
+                   xfer_plist_id, data.data ());
+}
+
 void
 __h5write__ (const std::string& caller, const octave_value& ov,
              hid_t object_id, hid_t mem_type_id, hid_t mem_space_id,
              hid_t file_space_id, hid_t xfer_plist_id, hid_t field_type_id)
 {
   // Decide which hdf5 function to call based on caller name
-  int wrt_fcn;
-
-  if (caller == "H5D.write")
-    wrt_fcn = 0;
-  else // H5A.write
-    wrt_fcn = 1;
+  int wrt_fcn = is_attribute_caller (caller) ? 1 : 0;
 
   herr_t status = -1;
 
   if (ov.iscomplex ())
-    error ("H5D.write: complex data are currently not handled");
-
-  if (mem_space_id != H5S_ALL)
-    {
-      warning ("H5D.write: substituting MEM_SPACE_ID with 'H5S_ALL'");
-      mem_space_id = H5S_ALL;
-    }
+    error ("%s: complex data are currently not handled", caller.c_str ());
 
   bool auto_type = (mem_type_id == -1234);
 
@@ -334,115 +1397,92 @@ __h5write__ (const std::string& caller, const octave_value& ov,
   if (field_type_id != H5_INDEX_UNKNOWN)
     sub_type_id = field_type_id;
 
-  if (H5Tequal (sub_type_id, H5T_NATIVE_DOUBLE) > 0)
-    {
-      if (wrt_fcn == 0)
-        status = H5Dwrite (object_id, mem_type_id, mem_space_id, file_space_id,
-                           xfer_plist_id, ov.array_value ().data ());
-      else
-        status = H5Awrite (object_id, mem_type_id,
-                           ov.array_value ().data ());
+  // Only write the selected elements
+  bool own_mem_space = false;
 
-    }
+  if (wrt_fcn == 0)
+    own_mem_space
+      = check_write_selection (caller, object_id,
+                               get_write_numel (ov, sub_type_id),
+                               mem_space_id, file_space_id);
+
+  if (H5Tequal (sub_type_id, H5T_NATIVE_DOUBLE) > 0)
+    status = write_numeric (wrt_fcn, object_id, mem_type_id, mem_space_id,
+                            file_space_id, xfer_plist_id,
+                            ov.array_value ());
   else if (H5Tequal (sub_type_id, H5T_NATIVE_FLOAT) > 0)
-    {
-      if (wrt_fcn == 0)
-        status = H5Dwrite (object_id, mem_type_id, mem_space_id, file_space_id,
-                           xfer_plist_id,
-                           ov.float_array_value ().data ());
-      else
-        status = H5Awrite (object_id, mem_type_id,
-                           ov.float_array_value ().data ());
-    }
+    status = write_numeric (wrt_fcn, object_id, mem_type_id, mem_space_id,
+                            file_space_id, xfer_plist_id,
+                            ov.float_array_value ());
   else if (H5Tequal (sub_type_id, H5T_NATIVE_INT8) > 0)
-    {
-      if (wrt_fcn == 0)
-        status = H5Dwrite (object_id, mem_type_id, mem_space_id, file_space_id,
-                           xfer_plist_id,
-                           ov.int8_array_value ().data ());
-      else
-        status = H5Awrite (object_id, mem_type_id,
-                           ov.int8_array_value ().data ());
-    }
+    status = write_numeric (wrt_fcn, object_id, mem_type_id, mem_space_id,
+                            file_space_id, xfer_plist_id,
+                            ov.int8_array_value ());
   else if (H5Tequal (sub_type_id, H5T_NATIVE_INT16) > 0)
-    {
-      if (wrt_fcn == 0)
-        status = H5Dwrite (object_id, mem_type_id, mem_space_id, file_space_id,
-                           xfer_plist_id,
-                           ov.int16_array_value ().data ());
-      else
-        status = H5Awrite (object_id, mem_type_id,
-                           ov.int16_array_value ().data ());
-    }
+    status = write_numeric (wrt_fcn, object_id, mem_type_id, mem_space_id,
+                            file_space_id, xfer_plist_id,
+                            ov.int16_array_value ());
   else if (H5Tequal (sub_type_id, H5T_NATIVE_INT32) > 0)
-    {
-      if (wrt_fcn == 0)
-        status = H5Dwrite (object_id, mem_type_id, mem_space_id, file_space_id,
-                           xfer_plist_id,
-                           ov.int32_array_value ().data ());
-      else
-        status = H5Awrite (object_id, mem_type_id,
-                           ov.int32_array_value ().data ());
-    }
+    status = write_numeric (wrt_fcn, object_id, mem_type_id, mem_space_id,
+                            file_space_id, xfer_plist_id,
+                            ov.int32_array_value ());
   else if (H5Tequal (sub_type_id, H5T_NATIVE_INT64) > 0)
-    {
-      if (wrt_fcn == 0)
-        status = H5Dwrite (object_id, mem_type_id, mem_space_id, file_space_id,
-                           xfer_plist_id,
-                           ov.int64_array_value ().data ());
-      else
-        status = H5Awrite (object_id, mem_type_id,
-                           ov.int64_array_value ().data ());
-    }
+    status = write_numeric (wrt_fcn, object_id, mem_type_id, mem_space_id,
+                            file_space_id, xfer_plist_id,
+                            ov.int64_array_value ());
   else if (H5Tequal (sub_type_id, H5T_NATIVE_UINT8) > 0)
-    {
-      if (wrt_fcn == 0)
-        status = H5Dwrite (object_id, mem_type_id, mem_space_id, file_space_id,
-                           xfer_plist_id,
-                           ov.uint8_array_value ().data ());
-      else
-        status = H5Awrite (object_id, mem_type_id,
-                           ov.uint8_array_value ().data ());
-    }
+    status = write_numeric (wrt_fcn, object_id, mem_type_id, mem_space_id,
+                            file_space_id, xfer_plist_id,
+                            ov.uint8_array_value ());
   else if (H5Tequal (sub_type_id, H5T_NATIVE_UINT16) > 0)
-    {
-      if (wrt_fcn == 0)
-        status = H5Dwrite (object_id, mem_type_id, mem_space_id, file_space_id,
-                           xfer_plist_id,
-                           ov.uint16_array_value ().data ());
-      else
-        status = H5Awrite (object_id, mem_type_id,
-                           ov.uint16_array_value ().data ());
-    }
+    status = write_numeric (wrt_fcn, object_id, mem_type_id, mem_space_id,
+                            file_space_id, xfer_plist_id,
+                            ov.uint16_array_value ());
   else if (H5Tequal (sub_type_id, H5T_NATIVE_UINT32) > 0)
-    {
-      if (wrt_fcn == 0)
-        status = H5Dwrite (object_id, mem_type_id, mem_space_id, file_space_id,
-                           xfer_plist_id,
-                           ov.uint32_array_value ().data ());
-      else
-        status = H5Awrite (object_id, mem_type_id,
-                           ov.uint32_array_value ().data ());
-    }
+    status = write_numeric (wrt_fcn, object_id, mem_type_id, mem_space_id,
+                            file_space_id, xfer_plist_id,
+                            ov.uint32_array_value ());
   else if (H5Tequal (sub_type_id, H5T_NATIVE_UINT64) > 0)
+    status = write_numeric (wrt_fcn, object_id, mem_type_id, mem_space_id,
+                            file_space_id, xfer_plist_id,
+                            ov.uint64_array_value ());
+  else if (H5Tequal (sub_type_id, H5T_STD_REF_OBJ) > 0)
     {
       if (wrt_fcn == 0)
         status = H5Dwrite (object_id, mem_type_id, mem_space_id, file_space_id,
                            xfer_plist_id,
-                           ov.uint64_array_value ().data ());
+                           ov.int64_array_value ().data ());
       else
         status = H5Awrite (object_id, mem_type_id,
-                           ov.uint64_array_value ().data ());
+                           ov.int64_array_value ().data ());
     }
-  else if (H5Tequal (sub_type_id, H5T_STD_REF_OBJ) > 0)
+  else if (H5Tequal (sub_type_id, H5T_STD_REF_DSETREG) > 0)
     {
+      // One reference per row, as returned by H5R.create
+      int64NDArray bytes
+        = ov.xint64_array_value ("%s: expecting int64 dataset region "
+                                 "references", caller.c_str ());
+
+      octave_idx_type nrefs = bytes.rows ();
+
+      if (bytes.ndims () != 2
+          || bytes.columns () != sizeof (hdset_reg_ref_t))
+        error ("%s: dataset region references must be stored in rows of %d "
+               "elements", caller.c_str (),
+               static_cast<int> (sizeof (hdset_reg_ref_t)));
+
+      std::vector<unsigned char> refs (nrefs * sizeof (hdset_reg_ref_t));
+
+      for (octave_idx_type ii = 0; ii < nrefs; ii++)
+        for (size_t jj = 0; jj < sizeof (hdset_reg_ref_t); jj++)
+          refs[ii*sizeof (hdset_reg_ref_t)+jj]
+            = static_cast<unsigned char> (bytes(ii,jj).value ());
+
       if (wrt_fcn == 0)
         status = H5Dwrite (object_id, mem_type_id, mem_space_id, file_space_id,
-                           xfer_plist_id,
-                           ov.int64_array_value ().data ());
+                           xfer_plist_id, refs.data ());
       else
-        status = H5Awrite (object_id, mem_type_id,
-                           ov.int64_array_value ().data ());
+        status = H5Awrite (object_id, mem_type_id, refs.data ());
     }
   else if (H5Tget_class (sub_type_id) == H5T_STRING)
     {
@@ -499,51 +1539,41 @@ __h5write__ (const std::string& caller, const octave_value& ov,
         {
           charMatrix cm = ov.xchar_matrix_value ("%s: expecting char array for fixed length strings", caller.c_str ());
 
+          // Each row is truncated or padded to the string size
+          size_t sz = H5Tget_size (sub_type_id);
+          const char *str = cm.data ();
+          std::vector<char> buf;
+
+          if (sz > 1)
+            {
+              char pad = (H5Tget_strpad (sub_type_id) == H5T_STR_SPACEPAD
+                          ? ' ' : '\0');
+              octave_idx_type nrows = cm.rows ();
+              octave_idx_type ncols
+                = std::min<octave_idx_type> (cm.columns (), sz);
+
+              buf.assign (nrows * sz, pad);
+              for (octave_idx_type ii = 0; ii < nrows; ii++)
+                for (octave_idx_type jj = 0; jj < ncols; jj++)
+                  buf[ii * sz + jj] = cm(ii, jj);
+
+              str = buf.data ();
+            }
+
           if (wrt_fcn == 0)
             status = H5Dwrite (object_id, mem_type_id, mem_space_id,
-                               file_space_id, xfer_plist_id,
-                               cm.data ());
+                               file_space_id, xfer_plist_id, str);
           else
-            status = H5Awrite (object_id, mem_type_id,
-                               cm.data ());
+            status = H5Awrite (object_id, mem_type_id, str);
         }
     }
   else if (H5Tget_class (sub_type_id) == H5T_COMPOUND)
-    {
-      // Expect a scalar input structure
-      octave_scalar_map data =
-        ov.xscalar_map_value ("H5D.write: expecting a scalar structure "
-                              "for compound data type");
-
-      size_t nfields = H5Tget_nmembers (sub_type_id);
-
-      for (size_t ii = 0; ii < nfields; ii++)
-        {
-          char *name = H5Tget_member_name (sub_type_id, ii);
-          if (data.isfield (name))
-            {
-              field_type_id = H5Tget_member_type (sub_type_id, ii);
-
-              size_t sz = H5Tget_size (field_type_id);
+    status = write_compound (caller, ov, object_id, sub_type_id,
+                             mem_space_id, file_space_id, xfer_plist_id);
 
-              hid_t type_id = H5Tcreate (H5T_COMPOUND, sz);
+  if (own_mem_space)
+    H5Sclose (mem_space_id);
 
-              H5Tinsert (type_id, name, 0, field_type_id);
-
-              const octave_value val = data.getfield (name);
-
-              __h5write__ (caller, val, object_id, type_id,
-                           mem_space_id, file_space_id, xfer_plist_id,
-                           field_type_id);
-              // We went that far, all is ok.
-              status = 0;
-              H5Tclose (field_type_id);
-              H5Tclose (type_id);
-            }
-
-          H5free_memory (name);
-        }
-    }
   if (auto_type)
     H5Tclose (mem_type_id);
 
@@ -27,6 +27,10 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
     #include <hdf5/serial/hdf5.h>
 #endif
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "H5LT_c.h"
 
 #define H5READ()                                                        \
@@ -45,11 +49,72 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
   retval = octave_value (data);
 
 
+// Compact description of a datatype and of its native memory counterpart.
+// Descriptors are computed once per datatype by get_type_desc, shared
+// between callers, and drive the dispatch of read and write operations.
+struct h5_type_desc
+{
+  // Octave representation of the data, used as dispatch table index
+  enum kind_type
+  {
+    UNSUPPORTED = 0,
+    INT8, UINT8, INT16, UINT16, INT32, UINT32, INT64, UINT64,
+    FLOAT, DOUBLE, REFERENCE, STRING, VLSTRING, COMPOUND, VLEN, ARRAY,
+    NUM_KINDS
+  };
+
+  struct member
+  {
+    std::string name;
+    size_t offset;
+    std::shared_ptr<const h5_type_desc> type;
+  };
+
+  H5T_class_t cls = H5T_NO_CLASS;
+  kind_type kind = UNSUPPORTED;
+
+  // Size and sign of the native type, byte order of the original type
+  size_t size = 0;
+  H5T_sign_t sign = H5T_SGN_NONE;
+  H5T_order_t order = H5T_ORDER_NONE;
+
+  // Serialized native memory type, packed for compound types.  No
+  // identifier is held so that descriptors outlive the library state.
+  std::string native_encoding;
+
+  // Return a new identifier of the native type, to be closed by the caller
+  hid_t native_type (void) const;
+
+  // Whether the native type holds variable length data to be reclaimed
+  bool has_vlen = false;
+
+  // Padding character of fixed length strings
+  char strpad = '\0';
+
+  // Members of compound types, with offsets in the native type
+  std::vector<member> members;
+
+  // Base type of variable length and array types
+  std::shared_ptr<const h5_type_desc> super;
+
+  // Dimensions of array types
+  std::vector<hsize_t> array_dims;
+};
+
+std::shared_ptr<const h5_type_desc>
+get_type_desc (hid_t type_id);
+
 octave_value
 __h5_read__ (const std::string& caller, dim_vector dv, hid_t object_id,
              hid_t mem_type_id, hid_t mem_space_id = H5S_ALL,
              hid_t file_space_id = H5S_ALL, hid_t xfer_plist_id = H5P_DEFAULT,
-             hid_t field_type_id = H5_INDEX_UNKNOWN);
+             hid_t field_type_id = H5_INDEX_UNKNOWN, bool as_records = false);
+
+octave_value
+__h5_read_into__ (const std::string& caller, const octave_value& data,
+                  const dim_vector& dv, hid_t object_id, hid_t mem_type_id,
+                  hid_t mem_space_id = H5S_ALL, hid_t file_space_id = H5S_ALL,
+                  hid_t xfer_plist_id = H5P_DEFAULT);
 
 void
 __h5write__ (const std::string& caller, const octave_value& ov,
@@ -20,6 +20,8 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 #include "h5_oct_util.h"
 #include <octave/builtin-defun-decls.h>
 
+#include <cmath>
+
 dim_vector
 get_dim_vector (hid_t space_id)
 {
@@ -74,6 +76,159 @@ get_dim_vector (hid_t space_id)
   return dv;
 }
 
+hid_t
+get_select_mem_space (hid_t space_id)
+{
+  // Build a simple dataspace, entirely selected, that can hold the elements
+  // selected in SPACE_ID. Regular hyperslabs keep their shape (count * block
+  // in each dimension), other selections are packed in a vector.
+  hssize_t npoints = H5Sget_select_npoints (space_id);
+  if (npoints < 0)
+    error ("get_select_mem_space: unable to get number of selected points");
+
+  int ndims = H5Sget_simple_extent_ndims (space_id);
+  if (ndims < 0)
+    error ("get_select_mem_space: unable to get space dims");
+
+  if (ndims > 0 && H5Sget_select_type (space_id) == H5S_SEL_HYPERSLABS
+      && H5Sis_regular_hyperslab (space_id) > 0)
+    {
+      hsize_t start[ndims];
+      hsize_t stride[ndims];
+      hsize_t count[ndims];
+      hsize_t block[ndims];
+
+      if (H5Sget_regular_hyperslab (space_id, start, stride, count, block) < 0)
+        error ("get_select_mem_space: unable to get hyperslab selection");
+
+      hsize_t dims[ndims];
+      for (int ii = 0; ii < ndims; ii++)
+        dims[ii] = count[ii] * block[ii];
+
+      return H5Screate_simple (ndims, dims, nullptr);
+    }
+
+  hsize_t dims[1] = {static_cast<hsize_t> (npoints)};
+
+  return H5Screate_simple (1, dims, nullptr);
+}
+
+void
+select_user_hyperslab (const std::string& caller, hid_t space_id,
+                       const octave_value& start, const octave_value& count,
+                       const octave_value& stride)
+{
+  // START, COUNT and STRIDE are one-based and in Octave dimension order,
+  // i.e. reversed with respect to HDF5. Infinite COUNT elements extend the
+  // hyperslab to the end of the dataspace.
+  int ndims = H5Sget_simple_extent_ndims (space_id);
+  if (ndims < 0)
+    error ("%s: unable to get space dims", caller.c_str ());
+
+  NDArray ostart = start.xarray_value ("%s: START must be a numeric vector",
+                                       caller.c_str ());
+  NDArray ocount = count.xarray_value ("%s: COUNT must be a numeric vector",
+                                       caller.c_str ());
+  NDArray ostride (dim_vector (1, ndims), 1.0);
+
+  if (! stride.isempty ())
+    ostride = stride.xarray_value ("%s: STRIDE must be a numeric vector",
+                                   caller.c_str ());
+
+  if (ostart.numel () != ndims || ocount.numel () != ndims
+      || ostride.numel () != ndims)
+    error ("%s: START, COUNT and STRIDE must have %d elements, one per "
+           "dataset dimension", caller.c_str (), ndims);
+
+  hsize_t dims[ndims];
+  H5Sget_simple_extent_dims (space_id, dims, nullptr);
+
+  hsize_t hstart[ndims];
+  hsize_t hcount[ndims];
+  hsize_t hstride[ndims];
+
+  for (int ii = 0; ii < ndims; ii++)
+    {
+      int jj = ndims - 1 - ii;
+
+      if (ostart(ii) < 1 || ostart(ii) != std::round (ostart(ii))
+          || ostart(ii) > dims[jj])
+        error ("%s: START(%d) must be an integer between 1 and %ld",
+               caller.c_str (), ii + 1, static_cast<long> (dims[jj]));
+
+      if (ostride(ii) < 1 || ostride(ii) != std::round (ostride(ii)))
+        error ("%s: STRIDE must contain positive integers", caller.c_str ());
+
+      hstart[jj] = static_cast<hsize_t> (ostart(ii)) - 1;
+      hstride[jj] = static_cast<hsize_t> (ostride(ii));
+
+      hsize_t max_count = (dims[jj] - hstart[jj] - 1) / hstride[jj] + 1;
+
+      if (std::isinf (ocount(ii)))
+        hcount[jj] = max_count;
+      else if (ocount(ii) < 0 || ocount(ii) != std::round (ocount(ii))
+               || ocount(ii) > max_count)
+        error ("%s: COUNT(%d) must be an integer between 0 and %ld",
+               caller.c_str (), ii + 1, static_cast<long> (max_count));
+      else
+        hcount[jj] = static_cast<hsize_t> (ocount(ii));
+    }
+
+  if (H5Sselect_hyperslab (space_id, H5S_SELECT_SET, hstart, hstride, hcount,
+                           nullptr) < 0)
+    error ("%s: unable to select hyperslab", caller.c_str ());
+}
+
+void
+get_region_ref (const octave_value& ref, const std::string& caller,
+                hdset_reg_ref_t& region_ref)
+{
+  int64NDArray bytes = ref.xint64_array_value ("%s: REF must be a reference",
+                                               caller.c_str ());
+
+  if (bytes.numel () != sizeof (region_ref))
+    error ("%s: REF must be a dataset region reference of %d elements",
+           caller.c_str (), static_cast<int> (sizeof (region_ref)));
+
+  unsigned char *data = reinterpret_cast<unsigned char *> (&region_ref);
+
+  for (size_t ii = 0; ii < sizeof (region_ref); ii++)
+    data[ii] = static_cast<unsigned char> (bytes(ii).value ());
+}
+
+int64NDArray
+region_ref_value (const hdset_reg_ref_t& ref)
+{
+  const unsigned char *data = reinterpret_cast<const unsigned char *> (&ref);
+
+  int64NDArray retval (dim_vector (1, sizeof (ref)));
+
+  for (size_t ii = 0; ii < sizeof (ref); ii++)
+    retval(ii) = data[ii];
+
+  return retval;
+}
+
+std::string
+get_h5_error_desc (void)
+{
+  // Description of the innermost error of the current HDF5 error stack
+  std::string desc;
+
+  auto walker = [] (unsigned n, const H5E_error2_t *err_desc,
+                    void *client_data) -> herr_t
+    {
+      if (n == 0 && err_desc->desc)
+        *static_cast<std::string *> (client_data) = err_desc->desc;
+
+      return 0;
+    };
+
+  H5Ewalk (H5E_DEFAULT, H5E_WALK_UPWARD, walker, &desc);
+
+  return desc;
+}
+
 hid_t get_h5_id (const octave_value_list& args, int argnum,
                  std::string argname, std::string caller,
                  bool maybe_string)
@@ -214,6 +369,13 @@ get_constants_map (void)
      {"H5D_FILL_VALUE_UNDEFINED", H5D_FILL_VALUE_UNDEFINED},
      {"H5D_FILL_VALUE_DEFAULT", H5D_FILL_VALUE_DEFAULT},
      {"H5D_FILL_VALUE_USER_DEFINED", H5D_FILL_VALUE_USER_DEFINED},
+     {"H5D_ALLOC_TIME_DEFAULT", H5D_ALLOC_TIME_DEFAULT},
+     {"H5D_ALLOC_TIME_EARLY", H5D_ALLOC_TIME_EARLY},
+     {"H5D_ALLOC_TIME_LATE", H5D_ALLOC_TIME_LATE},
+     {"H5D_ALLOC_TIME_INCR", H5D_ALLOC_TIME_INCR},
+     {"H5D_FILL_TIME_ALLOC", H5D_FILL_TIME_ALLOC},
+     {"H5D_FILL_TIME_NEVER", H5D_FILL_TIME_NEVER},
+     {"H5D_FILL_TIME_IFSET", H5D_FILL_TIME_IFSET},
      //H5E
      {"H5E_WALK_DOWNWARD", H5E_WALK_DOWNWARD},
      {"H5E_WALK_UPWARD", H5E_WALK_UPWARD},
@@ -256,6 +418,14 @@ get_constants_map (void)
      {"H5S_NULL", H5S_NULL},
      {"H5S_SCALAR", H5S_SCALAR},
      {"H5S_SIMPLE", H5S_SIMPLE},
+     {"H5S_SELECT_SET", H5S_SELECT_SET},
+     {"H5S_SELECT_OR", H5S_SELECT_OR},
+     {"H5S_SELECT_AND", H5S_SELECT_AND},
+     {"H5S_SELECT_XOR", H5S_SELECT_XOR},
+     {"H5S_SELECT_NOTB", H5S_SELECT_NOTB},
+     {"H5S_SELECT_NOTA", H5S_SELECT_NOTA},
+     {"H5S_SELECT_APPEND", H5S_SELECT_APPEND},
+     {"H5S_SELECT_PREPEND", H5S_SELECT_PREPEND},
      //H5T
      {"H5T_VARIABLE", H5T_VARIABLE},
      {"H5T_CSET_ASCII", H5T_CSET_ASCII},
@@ -311,6 +481,7 @@ get_constants_map (void)
      {"H5T_STD_B64BE", H5T_STD_B64BE},
      {"H5T_STD_B64LE", H5T_STD_B64LE},
      {"H5T_STD_REF_OBJ", H5T_STD_REF_OBJ},
+     {"H5T_STD_REF_DSETREG", H5T_STD_REF_DSETREG},
      /*
       * Types which are particular to Unix.
       */
@@ -445,7 +616,18 @@ get_constants_map (void)
      {"H5T_NATIVE_INT", H5T_NATIVE_INT},
      {"H5T_NATIVE_UINT", H5T_NATIVE_UINT},
      {"H5T_NATIVE_INT", H5T_NATIVE_INT},
-     {"H5T_NATIVE_UINT", H5T_NATIVE_UINT}
+     {"H5T_NATIVE_UINT", H5T_NATIVE_UINT},
+     //H5Z
+     {"H5Z_FILTER_DEFLATE", H5Z_FILTER_DEFLATE},
+     {"H5Z_FILTER_SHUFFLE", H5Z_FILTER_SHUFFLE},
+     {"H5Z_FILTER_FLETCHER32", H5Z_FILTER_FLETCHER32},
+     {"H5Z_FILTER_SZIP", H5Z_FILTER_SZIP},
+     {"H5Z_FILTER_NBIT", H5Z_FILTER_NBIT},
+     {"H5Z_FILTER_SCALEOFFSET", H5Z_FILTER_SCALEOFFSET},
+     {"H5Z_SO_FLOAT_DSCALE", H5Z_SO_FLOAT_DSCALE},
+     {"H5Z_SO_FLOAT_ESCALE", H5Z_SO_FLOAT_ESCALE},
+     {"H5Z_SO_INT", H5Z_SO_INT},
+     {"H5Z_SO_INT_MINBITS_DEFAULT", H5Z_SO_INT_MINBITS_DEFAULT}
     };
 
   return h5_oct_constants;
@@ -34,6 +34,20 @@ along with this program.  If not, see <https://www.gnu.org/licenses/>.
 
 dim_vector get_dim_vector (hid_t space_id);
 
+hid_t get_select_mem_space (hid_t space_id);
+
+void select_user_hyperslab (const std::string& caller, hid_t space_id,
+                            const octave_value& start,
+                            const octave_value& count,
+                            const octave_value& stride);
+
+// Dataset region references are represented by the int64 values of their
+// bytes, in a row vector
+void get_region_ref (const octave_value& ref, const std::string& caller,
+                     hdset_reg_ref_t& region_ref);
+
+int64NDArray region_ref_value (const hdset_reg_ref_t& ref);
+
 hid_t get_h5_id (const octave_value_list& args, int argnum,
                  std::string argname, std::string caller,
                  bool maybe_string = true);
@@ -47,6 +61,69 @@ struct user_callback_data
   octave_value data;
 };
 
+// Close an HDF5 identifier when going out of scope, including when an
+// Octave error is thrown
+class h5_id_closer
+{
+public:
+
+  h5_id_closer (hid_t id, herr_t (*close_fcn) (hid_t))
+    : m_id (id), m_close_fcn (close_fcn)
+  { }
+
+  h5_id_closer (const h5_id_closer&) = delete;
+
+  h5_id_closer& operator = (const h5_id_closer&) = delete;
+
+  ~h5_id_closer (void)
+  {
+    // Default identifiers such as H5S_ALL are 0
+    if (m_id > 0)
+      m_close_fcn (m_id);
+  }
+
+  // Give up the ownership of the identifier and return it
+  hid_t release (void)
+  {
+    hid_t id = m_id;
+    m_id = -1;
+    return id;
+  }
+
+private:
+
+  hid_t m_id;
+  herr_t (*m_close_fcn) (hid_t);
+};
+
+// Disable the automatic printing of the HDF5 error stack while in scope
+class h5_error_silencer
+{
+public:
+
+  h5_error_silencer (void)
+  {
+    H5Eget_auto (H5E_DEFAULT, &m_func, &m_client_data);
+    H5Eset_auto (H5E_DEFAULT, nullptr, nullptr);
+  }
+
+  h5_error_silencer (const h5_error_silencer&) = delete;
+
+  h5_error_silencer& operator = (const h5_error_silencer&) = delete;
+
+  ~h5_error_silencer (void)
+  {
+    H5Eset_auto (H5E_DEFAULT, m_func, m_client_data);
+  }
+
+private:
+
+  H5E_auto_t m_func;
+  void *m_client_data;
+};
+
+std::string get_h5_error_desc (void);
+
 herr_t iter_handler (hid_t group_id, const char* name,
                      const H5L_info_t* /*info*/, void* user_data);
 
@@ -15,44 +15,105 @@
 
 ## -*- texinfo -*-
 ## @deftypefn {} {} write_mat73 (@var{fname}, @var{var1}, @var{var2}, @dots{})
-## @deftypefnx {} {} write_mat73 (@var{fname}, @qcode{"-append"), @var{var1}, @var{var2}, @dots{})
+## @deftypefnx {} {} write_mat73 (@var{fname}, @var{option}, @dots{}, @var{var1}, @var{var2}, @dots{})
 ## Write variables to an HDF5 file @var{fname}, formated according to Matlab's
 ## v7.3 format.
 ## Variables @var{xxx} must be assigned in the calling scope and their
-## name is used in the output file.
+## name is used in the output file. Numeric, logical, char, cell and struct
+## variables, including struct arrays and sparse matrices, are supported.
+## Sparse matrices are stored uncompressed.
+##
+## The following options may precede the variables:
+##
+## @table @asis
+## @item @qcode{"-append"}
+## Add the variables to the existing file @var{fname} instead of
+## overwriting it.
+##
+## @item @qcode{"-compression"}, @var{level}
+## Deflate compression level of the datasets, from 0 (no compression) to 9
+## (best compression). The default is 3.
+##
+## @item @qcode{"-nocompression"}
+## Do not compress datasets, same as a compression level of 0.
+##
+## @item @qcode{"-serial"}
+## Compress chunks on the calling thread only.
+##
+## @item @qcode{"-threshold"}, @var{nbytes}
+## Only compress datasets holding at least @var{nbytes} bytes of data, smaller
+## ones are stored contiguously. The default is 4096.
+## @end table
+##
+## As with Matlab's @code{save -v7.3}, compressed datasets are split in
+## chunks, shuffled and deflated. Chunks of all the saved variables are
+## compressed ahead of time by the number of worker threads given by the
+## @env{OCT_HDF5_NUM_THREADS} environment variable, by default the number of
+## processor cores, while datasets are written in order. The resulting file
+## is identical to the one written with @qcode{"-serial"}.
 ## @seealso{read_mat73}
 ## @end deftypefn
 
 function retval = write_mat73 (fname, varargin)
 
-  append = false;
-
   if (! ischar (fname) || numel (varargin) == 0)
     error ("write_mat73: FNAME must be a string")
-  else
-    ## Handle "-append" option
-    if (strcmp (varargin{1}, "-append"))
-      varargin(1)  = [];
-      append = true;
-      varidx++;
-    endif
+  endif
 
-    if (numel (varargin) == 0)
-      print_usage ()
-    endif
+  ## Handle options
+  append = false;
+  opts = struct ("level", 3, "threshold", 4096, "parallel", true);
+
+  nopts = 0;
+  while (nopts < numel (varargin) && ischar (varargin{nopts+1}))
+    opt = varargin{nopts+1};
+    switch (opt)
+      case "-append"
+        append = true;
+      case "-nocompression"
+        opts.level = 0;
+      case "-serial"
+        opts.parallel = false;
+      case {"-compression", "-threshold"}
+        if (nopts + 2 > numel (varargin) || ! isnumeric (varargin{nopts+2})
+            || ! isscalar (varargin{nopts+2}))
+          error ("write_mat73: option '%s' requires a numeric value", opt);
+        endif
 
-    ## Check we have a name
-    varnames = varargin;
-    for ii = 1:numel (varargin)
-      varnames{ii} = inputname (ii+1);
-      if (isempty (varnames{ii}))
-        error ("write_mat73: variable %d is not assigned", ii);
-      endif
-    endfor
+        val = double (varargin{nopts+2});
+        if (strcmp (opt, "-threshold"))
+          opts.threshold = val;
+        elseif (val < 0 || val > 9 || val != fix (val))
+          error ("write_mat73: compression LEVEL must be an integer from 0 to 9");
+        else
+          opts.level = val;
+        endif
+        nopts++;
+      otherwise
+        break;
+    endswitch
+    nopts++;
+  endwhile
+
+  vars = varargin(nopts+1:end);
+
+  if (numel (vars) == 0)
+    print_usage ()
   endif
 
+  ## Check we have a name
+  varnames = cell (size (vars));
+  for ii = 1:numel (vars)
+    varnames{ii} = inputname (nopts + ii + 1);
+    if (isempty (varnames{ii}))
+      error ("write_mat73: variable %d is not assigned", ii);
+    endif
+  endfor
+
+  append = append && exist (fname, "file");
+
   ## Try writing to file as a check for permissions
-  fid = fopen (fname, "w");
+  fid = fopen (fname, "a");
   if (fid < 0)
     error ("write_mat73: unable to open '%s' for writting", fname)
   endif
@@ -65,8 +126,6 @@ function retval = write_mat73 (fname, varargin)
   unwind_protect
 
     file = [];
-    obj_id = [];
-    attr_id = [];
 
     H5E.set_auto (false);
 
@@ -81,12 +140,8 @@ function retval = write_mat73 (fname, varargin)
       rethrow_h5error ()
     end_try_catch
 
-
-    for ii = 1:numel (varargin)
-      varname = varnames{ii};
-      varinfo = evalin ("caller", sprintf ("whos ('%s')", varname));
-      write_var (file, varname, varargin{ii}, varinfo, file);
-    endfor
+    __write_mat73__ (file, varnames, vars, opts.level, opts.threshold,
+                     opts.parallel);
 
   unwind_protect_cleanup
     if (! isempty (file))
@@ -108,343 +163,145 @@ function status = error_walker (n, s)
   status = -1;
 endfunction
 
-function write_var (parent_id, varname, var, varinfo, file, h5path = "")
-  persistent has_refs = false;
-  space_id = [];
-  obj_id = [];
-
-  empty_var = isempty (var);
-
-  unwind_protect
-    switch varinfo.class
-      case {"int8","int16","int32","int64", ...
-            "uint8","uint16","uint32","uint64"}
-        if (! empty_var)
-          rnk = ndims (var);
-          sz = fliplr (size (var));
-          type_id = ["H5T_NATIVE_" upper(varinfo.class)];
-        else
-          rnk = 1;
-          sz = ndims (var);
-          type_id = "H5T_NATIVE_UINT64";
-          var = uint64 (size (var));
-        endif
-
-        space_id = H5S.create_simple (rnk, sz, sz);
-
-        obj_id = H5D.create (parent_id, varname, type_id, space_id, ...
-                             "H5P_DEFAULT");
-
-        ## Write attributes
-        write_matlab_class (obj_id, varinfo.class);
-        if (empty_var)
-          write_matlab_empty (obj_id);
-        endif
-
-        ## Write data
-        H5D.write (obj_id, "H5ML_DEFAULT", "H5S_ALL", "H5S_ALL", ...
-                   "H5P_DEFAULT", var);
-
-      case {"double", "single"}
-        issingle = strcmp (varinfo.class, "single");
-
-        if (! empty_var)
-          rnk = ndims (var);
-          sz = fliplr (size (var));
-          if (! issingle)
-            type_id = "H5T_NATIVE_DOUBLE";
-            tsize = 8;
-          else
-            type_id = "H5T_NATIVE_FLOAT";
-            tsize = 4;
-          endif
-
-          if (varinfo.complex)
-            sub_type_id = type_id;
-            type_id = H5T.create ("H5T_COMPOUND", 2 * tsize);
-            H5T.insert (type_id, "real", 0, sub_type_id);
-            H5T.insert (type_id, "imag", tsize, sub_type_id);
-          endif
-
-        else
-          rnk = 1;
-          sz = ndims (var);
-          type_id = "H5T_NATIVE_UINT64";
-          var = uint64 (size (var));
-        endif
-
-        space_id = H5S.create_simple (rnk, sz, sz);
-
-        obj_id = H5D.create (parent_id, varname, type_id, space_id, ...
-                             "H5P_DEFAULT");
-
-        ## Write attributes
-        write_matlab_class (obj_id, varinfo.class);
-        if (empty_var)
-          write_matlab_empty (obj_id);
-        endif
-
-        ## Write data
-        if (varinfo.complex)
-          tmpvar = var;
-          clear var;
-          var.real = real (tmpvar);
-          var.imag = imag (tmpvar);
-
-          H5T.close (type_id);
-        endif
-
-        H5D.write (obj_id, "H5ML_DEFAULT", "H5S_ALL", "H5S_ALL", ...
-                   "H5P_DEFAULT", var);
-
-      case "struct"
-        disp ("writing struct")
-      case "cell"
-        if (has_refs)
-          refs_id = H5G.open (file, "/#refs#", "H5P_DEFAULT");
-        else
-          refs_id = H5G.create (file, "/#refs#");
-          has_refs = true;
-        endif
-
-        unwind_protect
-          if (! empty_var)
-            ## Create a dataset to be referenced for each element
-            ref_names = cell (size (var));
-            for ii = 1:numel (var)
-              tmp = var{ii};
-              name = next_ref_name ();
-              ref_names{ii} = name;
-              ref_info = whos ("tmp");
-              write_var (refs_id, name, tmp, ref_info, file, ["/#refs#/" name]);
-            endfor
-
-            rnk = ndims (var);
-            sz = fliplr (size (var));
-            type_id = "H5T_STD_REF_OBJ";
-          else
-            rnk = 1;
-            sz = ndims (var);
-            type_id = "H5T_NATIVE_UINT64";
-            var = uint64 (size (var));
-          endif
-
-          space_id = H5S.create_simple (rnk, sz, sz);
-
-          obj_id = H5D.create (parent_id, varname, type_id, space_id, ...
-                               "H5P_DEFAULT");
-
-          refs = zeros (size (var), "uint64");
-          for ii = 1:numel (ref_names)
-            refs(ii) = H5R.create (refs_id, ref_names{ii}, 'H5R_OBJECT', -1);
-          endfor
-          H5D.write (obj_id, 'H5T_STD_REF_OBJ', 'H5S_ALL', 'H5S_ALL', ...
-                     'H5P_DEFAULT', refs);
-
-          ## Write attributes
-          write_matlab_class (obj_id, varinfo.class);
-          if (empty_var)
-            write_matlab_empty (obj_id);
-          endif
-        unwind_protect_cleanup
-          try
-            H5G.close (refs_id);
-          catch
-          end_try_catch
-        end_unwind_protect
-
-      case "char"
-        if (! empty_var)
-          rnk = ndims (var);
-          type_id = "H5T_NATIVE_UINT16";
-
-          ## Write data a utf-16
-          order = H5T.get_order (type_id);
-          is_le = order == H5ML.get_constant_value ("H5T_ORDER_LE");
-          native_u16 = "utf-16le";
-          if (! is_le)
-            native_u16 = "utf-16be";
-          endif
-
-          nd = ndims (var);
-          if (nd > 2)
-            warning ("write_mat73: Only first page of char array is written.");
-          endif
-
-          if (nd == 1)
-            var = typecast (unicode2native (var, native_u16), "uint16");
-          else
-            nr = rows (var);
-            lines = cell (nr, 1);
-            nc(nr) = 0;
-            for ii = 1:nr;
-              var(ii,:)
-              lines{ii} = typecast (unicode2native (var(ii,:), native_u16), ...
-                                    "uint16");
-              nc(ii) = numel (lines{ii});
-            endfor
-            mx = max (nc);
-            for ii = 1:nr
-              fill_char = string_fill_char ();
-              ## Eventually padd
-              lines{ii}(end+1:mx) = fill_char;
-            endfor
-            var = vertcat (lines{:})
-          endif
-
-          sz = fliplr (size (var));
-
-        else
-          rnk = 1;
-          sz = ndims (var);
-          type_id = "H5T_NATIVE_UINT64";
-          var = uint64 (size (var));
-        endif
-
-        space_id = H5S.create_simple (rnk, sz, sz);
-
-        obj_id = H5D.create (parent_id, varname, type_id, space_id, ...
-                             "H5P_DEFAULT");
-
-        H5D.write (obj_id, "H5ML_DEFAULT", "H5S_ALL", "H5S_ALL", ...
-                   "H5P_DEFAULT", var);
-
-        ## Write attributes
-        write_matlab_class (obj_id, varinfo.class);
-        write_int_decode (obj_id, 2);
-        if (empty_var)
-          write_matlab_empty (obj_id);
-        endif
-
-    endswitch
-
-    ## Write H5PATH
-    if (! isempty (h5path))
-      write_h5path (obj_id, h5path);
-    endif
-  unwind_protect_cleanup
-    if (! isempty (space_id))
-      H5S.close (space_id);
-    endif
-
-    if (! isempty (obj_id))
-      H5O.close (obj_id);
-    endif
-  end_unwind_protect
-endfunction
-
-function write_matlab_class (parent_id, cls)
-  ## Create type id
-  type_id = H5T.copy ("H5T_C_S1");
-  H5T.set_size (type_id, numel (cls));
-  H5T.set_cset (type_id, "H5T_CSET_ASCII");
-
-  ## Create scalar space id
-  space_id = H5S.create ("H5S_SCALAR");
-
-  try
-    attr_id = H5A.create (parent_id, "MATLAB_class", type_id, ...
-                          space_id, "H5P_DEFAULT", "H5P_DEFAULT");
-  catch
-    rethrow_h5error ()
-  end_try_catch
-
-  try
-    H5A.write (attr_id, "H5ML_DEFAULT", cls);
-    H5A.close (attr_id);
-  catch
-    rethrow_h5error ()
-  end_try_catch
-
-  H5S.close (space_id);
-  H5T.close (type_id);
-endfunction
-
-function write_h5path (parent_id, pth)
-  ## Create type id
-  type_id = H5T.copy ("H5T_C_S1");
-  H5T.set_size (type_id, numel (pth));
-  H5T.set_cset (type_id, "H5T_CSET_ASCII");
-
-  ## Create scalar space id
-  space_id = H5S.create ("H5S_SCALAR");
-
-  try
-    attr_id = H5A.create (parent_id, "H5PATH", type_id, ...
-                          space_id, "H5P_DEFAULT", "H5P_DEFAULT");
-  catch
-    rethrow_h5error ()
-  end_try_catch
-
-  try
-    H5A.write (attr_id, "H5ML_DEFAULT", pth);
-    H5A.close (attr_id);
-  catch
-    rethrow_h5error ()
-  end_try_catch
-
-  H5S.close (space_id);
-  H5T.close (type_id);
-endfunction
-
-function write_int_decode (parent_id, val)
-  ## Create type id
-  type_id = "H5T_NATIVE_INT32";
-
-  ## Create scalar space id
-  space_id = H5S.create ("H5S_SCALAR");
-
-  try
-    attr_id = H5A.create (parent_id, "MATLAB_int_decode", type_id, ...
-                          space_id, "H5P_DEFAULT", "H5P_DEFAULT");
-  catch
-    rethrow_h5error ()
-  end_try_catch
-
-  try
-    H5A.write (attr_id, "H5ML_DEFAULT", val);
-    H5A.close (attr_id);
-  catch
-    rethrow_h5error ()
-  end_try_catch
-
-  H5S.close (space_id);
-endfunction
-
-function write_matlab_empty (parent_id)
-  ## Create type id
-  type_id = H5T.copy ("H5T_NATIVE_UINT8");
-
-  ## Create scalar space id
-  space_id = H5S.create ("H5S_SCALAR");
-
-  try
-    attr_id = H5A.create (parent_id, "MATLAB_empty", "H5T_NATIVE_UINT8", ...
-                          space_id, "H5P_DEFAULT", "H5P_DEFAULT");
-  catch
-    rethrow_h5error ()
-  end_try_catch
-
-  try
-    H5A.write (attr_id, "H5ML_DEFAULT", uint8 (1));
-    H5A.close (attr_id);
-  catch
-    rethrow_h5error ()
-  end_try_catch
-
-  H5S.close (space_id);
-  H5T.close (type_id);
-endfunction
-
-function name = next_ref_name ()
-  persistent pidx = 0;
-  persistent alphabet = char ([97:122]);
-  name = "";
-  idx = pidx;
-  while idx >= 0
-    n = mod (idx, 26);
-    name = [alphabet(n+1) name];
-    idx = floor (idx / 26)-1;
-  endwhile
-  pidx++;
-endfunction
+%!test
+%! fname = [tempname() ".mat"];
+%! unwind_protect
+%!   s.a = magic (3);
+%!   s.b = struct ("c", {"x", int8([1 2])}, "d", {true, {1, "y"}});
+%!   s.e = struct ();
+%!   c = {1, single(2+3i); "str", {s.a}};
+%!   write_mat73 (fname, s, c);
+%!   v73 = read_mat73 (fname);
+%!   assert (v73.s, s)
+%!   assert (v73.c, c)
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+%!test
+%! fname = [tempname() ".mat"];
+%! unwind_protect
+%!   x = zeros (1000, 100);
+%!   write_mat73 (fname, x);
+%!   assert (stat (fname).size < numel (x) * 8 / 10)
+%!   write_mat73 (fname, "-nocompression", x);
+%!   assert (stat (fname).size > numel (x) * 8)
+%!   y = x(1:10);
+%!   write_mat73 (fname, "-append", "-compression", 9, y);
+%!   v73 = read_mat73 (fname);
+%!   assert (v73.x, x)
+%!   assert (v73.y, y)
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+%!test
+%! fname = [tempname() ".mat"];
+%! unwind_protect
+%!   c = num2cell (1:1000);
+%!   write_mat73 (fname, c);
+%!   d = {"a", {int16(1)}};
+%!   write_mat73 (fname, "-append", d);
+%!   v73 = read_mat73 (fname);
+%!   assert (v73.c, c)
+%!   assert (v73.d, d)
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+%!test
+%! fname1 = [tempname() ".mat"];
+%! fname2 = [tempname() ".mat"];
+%! nthreads = getenv ("OCT_HDF5_NUM_THREADS");
+%! unwind_protect
+%!   setenv ("OCT_HDF5_NUM_THREADS", "4");
+%!   x = reshape (1:1e5, 1000, 100);
+%!   y = single (rand (300, 200));
+%!   c = {int32(x), "str", {y, uint8(x)}};
+%!   write_mat73 (fname1, "-serial", x, y, c);
+%!   write_mat73 (fname2, x, y, c);
+%!   fid = fopen (fname1, "r");
+%!   bytes1 = fread (fid, Inf, "uint8=>uint8");
+%!   fclose (fid);
+%!   fid = fopen (fname2, "r");
+%!   bytes2 = fread (fid, Inf, "uint8=>uint8");
+%!   fclose (fid);
+%!   assert (bytes2, bytes1)
+%!   v73 = read_mat73 (fname2);
+%!   assert (v73.c, c)
+%! unwind_protect_cleanup
+%!   setenv ("OCT_HDF5_NUM_THREADS", nthreads);
+%!   unlink (fname1);
+%!   unlink (fname2);
+%! end_unwind_protect
+
+%!test
+%! ## Non-ASCII characters are stored as UTF-16 code units, rows are padded
+%! ## with blanks and invalid UTF-8 sequences are replaced with U+FFFD
+%! fname = [tempname() ".mat"];
+%! unwind_protect
+%!   str = ["\xc3\xa9t\xc3\xa9s"; "summer"];
+%!   emoji = "\xf0\x9f\x98\x80";
+%!   bad = "a\xffb";
+%!   write_mat73 (fname, str, emoji, bad);
+%!   fid = H5F.open (fname, "H5F_ACC_RDONLY", "H5P_DEFAULT");
+%!   units = cell (1, 3);
+%!   names = {"str", "emoji", "bad"};
+%!   for ii = 1:3
+%!     dset = H5D.open (fid, names{ii}, "H5P_DEFAULT");
+%!     units{ii} = H5D.read (dset);
+%!     H5D.close (dset);
+%!   endfor
+%!   H5F.close (fid);
+%!   assert (units{1}, uint16 ([233 116 233 115 32 32; double("summer")]))
+%!   assert (units{2}, uint16 ([55357 56832]))
+%!   assert (units{3}, uint16 ([97 65533 98]))
+%!   v73 = read_mat73 (fname);
+%!   assert (v73.str, ["\xc3\xa9t\xc3\xa9s  "; "summer  "])
+%!   assert (v73.emoji, emoji)
+%!   assert (v73.bad, "a\xef\xbf\xbdb")
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+%!test
+%! ## Large datasets are split in chunks of at most 64 KiB holding whole
+%! ## columns, small ones are stored contiguously
+%! fname = [tempname() ".mat"];
+%! unwind_protect
+%!   x = reshape (1:1e5, 1000, 100);
+%!   y = magic (10);
+%!   write_mat73 (fname, x, y);
+%!   fid = H5F.open (fname, "H5F_ACC_RDONLY", "H5P_DEFAULT");
+%!   dset = H5D.open (fid, "x", "H5P_DEFAULT");
+%!   dcpl = H5D.get_create_plist (dset);
+%!   [rank, dims] = H5P.get_chunk (dcpl);
+%!   H5P.close (dcpl);
+%!   H5D.close (dset);
+%!   dset = H5D.open (fid, "y", "H5P_DEFAULT");
+%!   dcpl = H5D.get_create_plist (dset);
+%!   layout = H5P.get_layout (dcpl);
+%!   H5P.close (dcpl);
+%!   H5D.close (dset);
+%!   H5F.close (fid);
+%!   assert (rank, 2)
+%!   assert (prod (dims) * 8 <= 65536)
+%!   assert (dims(2), 1000)
+%!   assert (double (layout),
+%!           double (H5ML.get_constant_value ("H5D_CONTIGUOUS")))
+%!   v73 = read_mat73 (fname);
+%!   assert (v73.x, x)
+%!   assert (v73.y, y)
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect
+
+%!error <requires a numeric value> write_mat73 (tempname (), "-compression", "x")
+%!test
+%! fname = tempname ();
+%! unwind_protect
+%!   x = @sin;
+%!   fail ("write_mat73 (fname, x)", "unsupported type");
+%! unwind_protect_cleanup
+%!   unlink (fname);
+%! end_unwind_protect